@@ -0,0 +1,79 @@
+#!/bin/bash
+# Times the CTL engine on the models of Tests/ and test_models/, forcing the
+# CTL engine also for reachability queries.
+#
+# Usage: ctl_benchmark.sh <binary> [baseline binary] [timeout] [repetitions]
+#
+# Prints one CSV line per model with the best wall time of each binary and,
+# when a baseline is given, the speedup and whether the answers agree.
+# Extra verifypn options can be given in OPTIONS (default: -ctl czero -s DFS).
+
+B=$1
+BASE=$2
+T=${3:-60}
+N=${4:-3}
+OPTIONS=${OPTIONS:-"-ctl czero -s DFS"}
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 1
+fi
+
+# best time of N runs in seconds, the answers are written to $2
+run() {
+	local bin=$1 out=$2
+	shift 2
+	local best=""
+	for i in $(seq 1 $N) ; do
+		local start=$(date +%s.%N)
+		timeout $T $bin --noreach $OPTIONS "$@" 2> /dev/null | grep "Query is" > $out
+		local code=${PIPESTATUS[0]}
+		local end=$(date +%s.%N)
+		if [ $code -eq 124 ] ; then
+			echo "timeout"
+			return
+		fi
+		local t=$(echo "$end - $start" | bc)
+		if [ -z "$best" ] || [ $(echo "$t < $best" | bc) -eq 1 ] ; then
+			best=$t
+		fi
+	done
+	echo $best
+}
+
+bench() {
+	local name=$1
+	shift
+	local t=$(run $B /tmp/ctl_bench_new.$$ "$@")
+	if [ -z "$BASE" ] ; then
+		echo "$name,$t"
+		return
+	fi
+	local tb=$(run $BASE /tmp/ctl_bench_base.$$ "$@")
+	local speedup="-"
+	if [ "$t" != "timeout" ] && [ "$tb" != "timeout" ] && [ $(echo "$t > 0" | bc) -eq 1 ] ; then
+		speedup=$(echo "scale=2; $tb / $t" | bc)
+	fi
+	local same="same"
+	cmp -s /tmp/ctl_bench_new.$$ /tmp/ctl_bench_base.$$ || same="DIFFERENT"
+	echo "$name,$t,$tb,$speedup,$same"
+}
+
+if [ -z "$BASE" ] ; then
+	echo "model,time"
+else
+	echo "model,time,baseline,speedup,answers"
+fi
+
+for f in $ROOT/Tests/*.xml ; do
+	[ -f "$f.q" ] || continue
+	bench "Tests/$(basename $f)" "$f" "$f.q"
+done
+
+for d in $ROOT/test_models/*/ ; do
+	[ -f "$d/model.pnml" ] && [ -f "$d/query.xml" ] || continue
+	bench "test_models/$(basename $d)" "$d/model.pnml" "$d/query.xml"
+done
+
+rm -f /tmp/ctl_bench_new.$$ /tmp/ctl_bench_base.$$
@@ -0,0 +1,87 @@
+#!/bin/bash
+# Measures the per-query overhead of the LTL engine: every LTL query of the
+# small models in boost_tests/models and cpn_tests is verified on its own,
+# so the run time and peak memory are dominated by the setup of the search.
+#
+# Usage: ltl_setup_benchmark.sh <binary> [baseline binary] [repetitions]
+#
+# Prints one CSV line per query with the best wall time in seconds and the
+# peak resident set size in KB of each binary, followed by a line with the
+# number of queries, the summed times and the mean peak memory.
+# Extra verifypn options can be given in OPTIONS (default: -ltl tarjan).
+# Requires GNU time, set TIME if it is not /usr/bin/time.
+
+B=$1
+BASE=$2
+N=${3:-5}
+OPTIONS=${OPTIONS:-"-ltl tarjan"}
+TIME=${TIME:-/usr/bin/time}
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+
+if [ -z "$B" ] ; then
+	echo "Missing binary"
+	exit 1
+fi
+
+if [ ! -x "$TIME" ] ; then
+	echo "GNU time not found at $TIME"
+	exit 1
+fi
+
+# prints "<best time> <peak rss>" over N runs
+run() {
+	local bin=$1
+	shift
+	local best="" rss=0
+	for i in $(seq 1 $N) ; do
+		local out=$($TIME -f "%e %M" $bin $OPTIONS "$@" 2>&1 > /dev/null | tail -n 1)
+		local t=${out% *} m=${out#* }
+		if [ -z "$best" ] || [ $(echo "$t < $best" | bc) -eq 1 ] ; then
+			best=$t
+		fi
+		[ "$m" -gt "$rss" ] && rss=$m
+	done
+	echo "$best $rss"
+}
+
+TT=0 TM=0 BT=0 BM=0 COUNT=0
+
+bench() {
+	local name=$1 model=$2 query=$3
+	local n=$(grep -c "<property>" "$query")
+	for q in $(seq 1 $n) ; do
+		local r=($(run $B -x $q "$model" "$query"))
+		TT=$(echo "$TT + ${r[0]}" | bc)
+		TM=$((TM + r[1]))
+		COUNT=$((COUNT + 1))
+		if [ -z "$BASE" ] ; then
+			echo "$name,$q,${r[0]},${r[1]}"
+			continue
+		fi
+		local rb=($(run $BASE -x $q "$model" "$query"))
+		BT=$(echo "$BT + ${rb[0]}" | bc)
+		BM=$((BM + rb[1]))
+		echo "$name,$q,${r[0]},${r[1]},${rb[0]},${rb[1]}"
+	done
+}
+
+if [ -z "$BASE" ] ; then
+	echo "model,query,time,rss"
+else
+	echo "model,query,time,rss,baseline time,baseline rss"
+fi
+
+for d in $ROOT/boost_tests/models/*/ $ROOT/cpn_tests/*/ ; do
+	[ -f "$d/model.pnml" ] || continue
+	for f in LTLCardinality LTLFireability ; do
+		[ -f "$d/$f.xml" ] || continue
+		bench "$(basename $d)/$f" "$d/model.pnml" "$d/$f.xml"
+	done
+done
+
+[ $COUNT -eq 0 ] && exit 0
+if [ -z "$BASE" ] ; then
+	echo "total,$COUNT,$TT,$((TM / COUNT))"
+else
+	echo "total,$COUNT,$TT,$((TM / COUNT)),$BT,$((BM / COUNT))"
+fi
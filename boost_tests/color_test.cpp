@@ -457,3 +457,146 @@ BOOST_AUTO_TEST_CASE(SubtractionErrorUnfoldingNonEmptyMarking, * utf::timeout(2)
     );
 }
 
+
+BOOST_AUTO_TEST_CASE(ParallelUnfoldingIsDeterministic, * utf::timeout(100)) {
+    for (const std::string model : {"/models/PhilosophersDyn-COL-03/model.pnml", "/models/NeoElection-COL-3/model.pnml",
+                                    "/models/Peterson-COL-2/model.pnml"})
+    {
+        for (auto partition : {false, true})
+        {
+            for (auto cfp : {false, true})
+            {
+                std::cerr << "\t" << model << std::boolalpha << " partition=" << partition << " cfp=" << cfp << std::endl;
+                // binding order depends on addresses, so all unfoldings are made from the same colored net
+                shared_string_set sset;
+                ColoredPetriNetBuilder cpnBuilder(sset);
+                auto f = loadFile(model.c_str());
+                cpnBuilder.parse_model(f);
+                std::string expected;
+                for (uint32_t threads : {1, 2, 4})
+                {
+                    auto [builder, trans_names, place_names] = unfold(cpnBuilder, partition, false, cfp, std::cerr,
+                        10, 100, 10, 10, false, false, threads);
+                    std::unique_ptr<PetriNet> pn{builder.makePetriNet(false)};
+                    std::stringstream ss;
+                    pn->toXML(ss);
+                    if (threads == 1)
+                        expected = ss.str();
+                    else
+                        BOOST_REQUIRE(expected == ss.str());
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(StreamingUnfoldingMatchesUnfoldedNet, * utf::timeout(100)) {
+    for (const std::string model : {"/models/PhilosophersDyn-COL-03/model.pnml", "/models/Peterson-COL-2/model.pnml",
+                                    "/models/all_place_product.pnml", "/models/subtraction_bug.pnml"})
+    {
+        for (auto cfp : {false, true})
+        {
+            for (uint32_t threads : {1, 4})
+            {
+                std::cerr << "\t" << model << std::boolalpha << " cfp=" << cfp << " threads=" << threads << std::endl;
+                shared_string_set sset;
+                ColoredPetriNetBuilder cpnBuilder(sset);
+                auto f = loadFile(model.c_str());
+                cpnBuilder.parse_model(f);
+                Colored::PartitionBuilder partition(cpnBuilder.transitions(), cpnBuilder.places());
+                Colored::VariableSymmetry symmetry(cpnBuilder, partition);
+                Colored::ForwardFixedPoint fixed_point(cpnBuilder, partition);
+                if (cfp)
+                    fixed_point.compute(100, 10, 10);
+                else
+                    fixed_point.set_default();
+
+                Colored::Unfolder unfolder(cpnBuilder, partition, symmetry, fixed_point, false, threads);
+                auto builder = unfolder.unfold();
+                std::unique_ptr<PetriNet> expected{builder.makePetriNet(false)};
+                std::stringstream expectedXML;
+                expected->toXML(expectedXML);
+
+                std::stringstream streamed;
+                Colored::Unfolder streaming(cpnBuilder, partition, symmetry, fixed_point, false, threads);
+                StreamingPnmlBuilder ptBuilder(streamed);
+                streaming.unfold(ptBuilder);
+                ptBuilder.finish();
+                BOOST_REQUIRE_EQUAL(builder.numberOfPlaces(), ptBuilder.numberOfPlaces());
+                BOOST_REQUIRE_EQUAL(builder.numberOfTransitions(), ptBuilder.numberOfTransitions());
+
+                shared_string_set rset;
+                PetriNetBuilder reparsed(rset);
+                reparsed.parse_model(streamed);
+                std::unique_ptr<PetriNet> actual{reparsed.makePetriNet(false)};
+                std::stringstream actualXML;
+                actual->toXML(actualXML);
+                BOOST_REQUIRE(expectedXML.str() == actualXML.str());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelColorFixpointMatchesSequential, * utf::timeout(100)) {
+    for (const std::string model : {"/models/PhilosophersDyn-COL-03/model.pnml", "/models/NeoElection-COL-3/model.pnml",
+                                    "/models/Peterson-COL-2/model.pnml", "/models/UtilityControlRoom-COL-Z2T3N04/model.pnml",
+                                    "/models/unfolding_loop.pnml", "/models/subtraction_bug.pnml"})
+    {
+        for (auto partition : {false, true})
+        {
+            std::cerr << "\t" << model << std::boolalpha << " partition=" << partition << std::endl;
+            shared_string_set sset;
+            ColoredPetriNetBuilder cpnBuilder(sset);
+            auto f = loadFile(model.c_str());
+            cpnBuilder.parse_model(f);
+            Colored::PartitionBuilder partitionBuilder(cpnBuilder.transitions(), cpnBuilder.places());
+            if (partition)
+                partitionBuilder.compute(10);
+            // the interval limit is not reached, so the fixed point does not depend on the evaluation order
+            std::vector<std::vector<std::set<std::vector<std::pair<uint32_t, uint32_t>>>>> fixpoints;
+            for (uint32_t threads : {1, 4})
+            {
+                Colored::ForwardFixedPoint fixed_point(cpnBuilder, partitionBuilder);
+                fixed_point.compute(0, 0, 0, threads);
+                auto& places = fixpoints.emplace_back();
+                for (const auto& cfp : fixed_point.fixed_point())
+                {
+                    auto& intervals = places.emplace_back();
+                    for (const auto& interval : cfp.constraints)
+                    {
+                        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+                        for (const auto& range : interval._ranges)
+                            ranges.emplace_back(range._lower, range._upper);
+                        intervals.insert(ranges);
+                    }
+                }
+            }
+            BOOST_REQUIRE(fixpoints[0] == fixpoints[1]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ProductColorsOfLargeProducts, * utf::timeout(10)) {
+    Colored::ColorType digit("Digit");
+    for (size_t i = 0; i < 4096; ++i)
+        digit.addColor(std::to_string(i).c_str());
+    // 2^24 colors fit one directory, 2^36 need 4096 directories and 2^48 go to the hash map
+    for (size_t width : {2, 3, 4})
+    {
+        Colored::ProductType product("Product");
+        for (size_t i = 0; i < width; ++i)
+            product.addType(&digit);
+        for (uint32_t id : {0u, 1u, 4095u, 4096u, 123456u, (1u << 24) - 1})
+        {
+            const Color& color = product[id];
+            BOOST_REQUIRE_EQUAL(color.getId(), id);
+            BOOST_REQUIRE(&product[id] == &color);
+            std::vector<uint32_t> ids;
+            color.getTupleId(ids);
+            BOOST_REQUIRE_EQUAL(ids.size(), width);
+            BOOST_REQUIRE_EQUAL(ids[0], id % 4096);
+            BOOST_REQUIRE_EQUAL(ids[1], (id / 4096) % 4096);
+            BOOST_REQUIRE(product.getColor(ids) == &color);
+        }
+    }
+}
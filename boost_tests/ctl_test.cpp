@@ -0,0 +1,74 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ctl
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "CTL/CTLResult.h"
+#include "CTL/CTLEngine.h"
+
+using namespace PetriEngine;
+using namespace PetriEngine::PQL;
+namespace utf = boost::unit_test;
+
+namespace {
+    // answers every query of the file with the given algorithm
+    std::vector<bool> solve(const std::string& model, const std::string& queries,
+                            CTL::CTLAlgorithmType algorithm, Strategy strategy,
+                            bool partial_order, uint32_t threads) {
+        auto [pn, conditions, qstrings] = load_pn(model, queries, {});
+        std::vector<bool> res;
+        for (auto& c : conditions) {
+            CTLResult cres(c);
+            AsCTL v;
+            Visitor::visit(v, c);
+            auto p = pushNegation(v._ctl_query);
+            res.push_back(CTLSingleSolve(p.get(), pn.get(), algorithm, strategy, partial_order, cres, threads));
+        }
+        return res;
+    }
+
+    void compare(const std::string& model, const std::string& queries) {
+        for (bool partial_order : {false, true}) {
+            auto expected = solve(model, queries, CTL::CZero, Strategy::DFS, partial_order, 1);
+            for (auto strategy : {Strategy::DFS, Strategy::BFS}) {
+                for (uint32_t threads : {1u, 2u, 4u}) {
+                    auto res = solve(model, queries, CTL::ParallelCZero, strategy, partial_order, threads);
+                    BOOST_REQUIRE_EQUAL(expected.size(), res.size());
+                    for (size_t i = 0; i < res.size(); ++i) {
+                        BOOST_TEST_CONTEXT(queries << " query " << i << " with " << threads << " threads") {
+                            BOOST_CHECK_EQUAL(expected[i], res[i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DirectoryTest) {
+    BOOST_REQUIRE(getenv("TEST_FILES"));
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01CTLCardinalityParallel, * utf::timeout(120)) {
+    compare("/models/Angiogenesis-PT-01/model.pnml", "/models/Angiogenesis-PT-01/CTLCardinality.xml");
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01CTLFireabilityParallel, * utf::timeout(120)) {
+    compare("/models/Angiogenesis-PT-01/model.pnml", "/models/Angiogenesis-PT-01/CTLFireability.xml");
+}
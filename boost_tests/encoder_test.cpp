@@ -0,0 +1,189 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE encoder
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+#include "PetriEngine/SuccessorGenerator.h"
+#include "PetriEngine/Structures/AlignedEncoder.h"
+
+using namespace PetriEngine;
+namespace utf = boost::unit_test;
+
+namespace {
+    struct sample_t {
+        std::string name;
+        uint32_t places;
+        std::vector<std::vector<MarkVal>> markings;
+    };
+
+    // the first markings found by a DFS from the initial marking
+    sample_t sample(const std::string& model, const std::string& query, size_t limit) {
+        auto [pn, conditions, qstrings] = load_pn(model, query, {0});
+        const auto nplaces = pn->numberOfPlaces();
+        sample_t res{model, nplaces, {}};
+        std::set<std::vector<MarkVal>> seen;
+        std::vector<std::vector<MarkVal>> stack;
+        {
+            Structures::State initial(pn->makeInitialMarking());
+            stack.emplace_back(initial.marking(), initial.marking() + nplaces);
+        }
+        seen.insert(stack.back());
+        SuccessorGenerator generator(*pn);
+        Structures::State state(new MarkVal[nplaces]);
+        Structures::State working(new MarkVal[nplaces]);
+        while (!stack.empty() && res.markings.size() < limit) {
+            res.markings.push_back(std::move(stack.back()));
+            stack.pop_back();
+            state.copy(res.markings.back().data(), nplaces);
+            generator.prepare(&state);
+            while (generator.next(working)) {
+                std::vector<MarkVal> succ(working.marking(), working.marking() + nplaces);
+                if (seen.insert(succ).second)
+                    stack.emplace_back(std::move(succ));
+            }
+        }
+        return res;
+    }
+
+    std::vector<sample_t> samples() {
+        std::vector<sample_t> res;
+        res.push_back(sample("/models/Angiogenesis-PT-01/model.pnml",
+                             "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", 20000));
+        for (auto name : {"MAPK-test001", "Kanban2-test001", "FMS2-untimed"}) {
+            std::string dir = std::string("/../test_models/") + name;
+            res.push_back(sample(dir + "/model.pnml", dir + "/query.xml", 20000));
+        }
+        return res;
+    }
+
+    std::vector<unsigned char> encode(AlignedEncoder& encoder, const std::vector<MarkVal>& marking, uint32_t places) {
+        uint64_t sum;
+        bool allsame;
+        uint32_t val, active, last;
+        AlignedEncoder::markingStats(marking.data(), places, sum, allsame, val, active, last);
+        auto length = encoder.encode(marking.data(), encoder.getType(sum, active, allsame, val));
+        auto raw = encoder.scratchpad().const_raw();
+        return std::vector<unsigned char>(raw, raw + length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MarkingStats) {
+    for (bool vectorized : {false, true}) {
+        AlignedEncoder::setVectorized(vectorized);
+        // cover both the vector body and the scalar tail
+        for (uint32_t places : {0u, 1u, 7u, 8u, 9u, 31u, 64u, 67u}) {
+            for (uint32_t seed = 0; seed < 50; ++seed) {
+                std::vector<MarkVal> marking(places, 0);
+                for (uint32_t i = 0; i < places; ++i)
+                    marking[i] = ((i * 2654435761u) ^ (seed * 40503u)) % 5 == 0 ? (seed % 3 == 0 ? 2 : 1 + i % 3) : 0;
+                if (places > 0 && seed % 7 == 0)
+                    marking[places - 1] = std::numeric_limits<MarkVal>::max();
+
+                uint64_t sum;
+                bool allsame;
+                uint32_t val, active, last;
+                AlignedEncoder::markingStats(marking.data(), places, sum, allsame, val, active, last);
+
+                uint64_t esum = 0;
+                uint32_t eval = 0, eactive = 0, elast = 0;
+                std::set<MarkVal> values;
+                for (uint32_t i = 0; i < places; ++i) {
+                    if (marking[i] == 0) continue;
+                    esum += marking[i];
+                    eval = std::max(eval, marking[i]);
+                    ++eactive;
+                    elast = i;
+                    values.insert(marking[i]);
+                }
+                BOOST_REQUIRE_EQUAL(sum, esum);
+                BOOST_REQUIRE_EQUAL(val, eval);
+                BOOST_REQUIRE_EQUAL(active, eactive);
+                BOOST_REQUIRE_EQUAL(last, elast);
+                BOOST_REQUIRE_EQUAL(allsame, values.size() <= 1);
+            }
+        }
+    }
+    AlignedEncoder::setVectorized(true);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeModels, * utf::timeout(120)) {
+    for (auto& s : samples()) {
+        AlignedEncoder encoder(s.places, 0);
+        std::vector<MarkVal> decoded(s.places);
+        for (auto& marking : s.markings) {
+            AlignedEncoder::setVectorized(false);
+            auto scalar = encode(encoder, marking, s.places);
+            AlignedEncoder::setVectorized(true);
+            auto simd = encode(encoder, marking, s.places);
+            BOOST_REQUIRE(scalar == simd);
+            for (bool vectorized : {false, true}) {
+                AlignedEncoder::setVectorized(vectorized);
+                std::fill(decoded.begin(), decoded.end(), 1);
+                encoder.decode(decoded.data(), simd.data());
+                BOOST_REQUIRE(decoded == marking);
+            }
+        }
+    }
+    AlignedEncoder::setVectorized(true);
+}
+
+// Microbenchmark of encode and decode on markings of the test models; prints
+// the time per marking of the scalar and the vectorized kernels.
+BOOST_AUTO_TEST_CASE(EncodeDecodeBenchmark, * utf::timeout(300)) {
+    constexpr size_t rounds = 20;
+    for (auto& s : samples()) {
+        AlignedEncoder encoder(s.places, 0);
+        std::vector<std::vector<unsigned char>> encoded;
+        for (auto& marking : s.markings)
+            encoded.push_back(encode(encoder, marking, s.places));
+        std::vector<MarkVal> decoded(s.places);
+
+        for (bool vectorized : {false, true}) {
+            AlignedEncoder::setVectorized(vectorized);
+            if (vectorized && !AlignedEncoder::vectorized()) {
+                BOOST_TEST_MESSAGE(s.name << ": no vectorized kernels on this CPU");
+                continue;
+            }
+            size_t checksum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < rounds; ++r)
+                for (auto& marking : s.markings)
+                    checksum += encode(encoder, marking, s.places).size();
+            auto mid = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < rounds; ++r) {
+                for (auto& e : encoded) {
+                    encoder.decode(decoded.data(), e.data());
+                    checksum += decoded[0];
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            auto n = static_cast<double>(rounds * s.markings.size());
+            auto enc = std::chrono::duration<double, std::nano>(mid - start).count() / n;
+            auto dec = std::chrono::duration<double, std::nano>(end - mid).count() / n;
+            BOOST_TEST_MESSAGE(s.name << " (" << s.places << " places, " << s.markings.size() << " markings) "
+                << (vectorized ? "vectorized" : "scalar") << ": encode " << enc << " ns, decode " << dec
+                << " ns, checksum " << checksum);
+            BOOST_CHECK_GT(checksum, 0);
+        }
+    }
+    AlignedEncoder::setVectorized(true);
+}
@@ -16,12 +16,13 @@ BOOST_AUTO_TEST_CASE(DirectoryTest) {
     BOOST_REQUIRE(getenv("TEST_FILES"));
 }
 
-void test_explicit_engine(const char* fn, ExplicitColoredModelChecker::Result expected, size_t quid = 0) { 
+void test_explicit_engine(const char* fn, ExplicitColoredModelChecker::Result expected, size_t quid = 0, uint32_t cores = 1) { 
     std::string model = std::string("/models/explicit-engine/") + fn + ".pnml";
     std::string query = std::string("/models/explicit-engine/") + fn + ".xml";
     std::set<size_t> qnums{quid};
     auto [queries, querynames, sset, options] = load_explicit(model, query, qnums);
     options.kbound = 4;
+    options.cores = cores;
 
     ExplicitColoredModelChecker checker(sset, std::cout);
     
@@ -37,3 +38,40 @@ BOOST_AUTO_TEST_CASE(SubtractionWithVars, * utf::timeout(5)) {
 BOOST_AUTO_TEST_CASE(ReferendumColoredSubtraction, * utf::timeout(5)) {
     test_explicit_engine("referendum_colored_subtraction", ExplicitColoredModelChecker::Result::SATISFIED);
 }
+
+BOOST_AUTO_TEST_CASE(CompactWaitingList, * utf::timeout(10)) {
+    for (auto generator : {ColoredSuccessorGeneratorOption::EVEN, ColoredSuccessorGeneratorOption::FIXED}) {
+        for (auto strategy : {Strategy::DFS, Strategy::BFS, Strategy::RDFS, Strategy::HEUR}) {
+            std::set<size_t> qnums{0};
+            auto [queries, querynames, sset, options] = load_explicit("/models/explicit-engine/subtraction_with_vars.pnml",
+                "/models/explicit-engine/subtraction_with_vars.xml", qnums);
+            options.kbound = 4;
+            options.colored_compact_waiting = true;
+            options.colored_sucessor_generator = generator;
+            options.strategy = strategy;
+            ExplicitColoredModelChecker checker(sset, std::cout);
+            BOOST_REQUIRE_EQUAL(ExplicitColoredModelChecker::Result::SATISFIED, checker.checkQuery(queries[0], options));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CompactWaitingListWideMarking, * utf::timeout(30)) {
+    // the initial marking does not fit in an encoding, so its state must keep the marking while waiting
+    for (auto strategy : {Strategy::DFS, Strategy::BFS, Strategy::HEUR}) {
+        std::set<size_t> qnums{0};
+        auto [queries, querynames, sset, options] = load_explicit("/models/explicit-engine/wide_marking.pnml",
+            "/models/explicit-engine/wide_marking.xml", qnums);
+        options.kbound = 4;
+        options.colored_compact_waiting = true;
+        options.strategy = strategy;
+        ExplicitColoredModelChecker checker(sset, std::cout);
+        BOOST_REQUIRE_EQUAL(ExplicitColoredModelChecker::Result::SATISFIED, checker.checkQuery(queries[0], options));
+    }
+}
+
+#ifdef VERIFYPN_MultiCore
+BOOST_AUTO_TEST_CASE(ParallelSearch, * utf::timeout(10)) {
+    test_explicit_engine("subtraction_with_vars", ExplicitColoredModelChecker::Result::SATISFIED, 0, 4);
+    test_explicit_engine("referendum_colored_subtraction", ExplicitColoredModelChecker::Result::SATISFIED, 0, 4);
+}
+#endif
@@ -85,6 +85,45 @@ BOOST_AUTO_TEST_CASE(AngiogenesisPT01LTLCardinality, * utf::timeout(300)) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01LTLCardinalityApproximate, * utf::timeout(300)) {
+
+    const std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    const std::vector<Reachability::ResultPrinter::Result> expected{
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied};
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/LTLCardinality.xml", qnums, TemporalLogic::LTL);
+
+    for (auto i : qnums) {
+        for (auto storage : { StateStorage::HashCompaction, StateStorage::Bitstate }) {
+            for (auto por : { LTL::LTLPartialOrder::None, LTL::LTLPartialOrder::Automaton }) {
+                LTL::LTLSearch search(*pn, conditions[i], LTL::BuchiOptimization::Low, LTL::APCompression::None);
+                auto r = search.solve(false, 0, LTL::Algorithm::Tarjan, por, Strategy::HEUR,
+                    LTL::LTLHeuristic::Automaton, true, 0, storage, 1);
+                auto result = r ? ResultPrinter::Satisfied : ResultPrinter::NotSatisfied;
+                BOOST_REQUIRE_EQUAL(expected[i], result);
+                BOOST_REQUIRE(search.is_approximate());
+                BOOST_REQUIRE_LT(search.omission_probability(), 0.01);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(AngiogenesisPT01LTLFireability, * utf::timeout(300)) {
 
     const std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
@@ -137,4 +176,64 @@ BOOST_AUTO_TEST_CASE(AngiogenesisPT01LTLFireability, * utf::timeout(300)) {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+#ifdef VERIFYPN_MultiCore
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01LTLParallel, * utf::timeout(300)) {
+
+    const std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    const std::vector<Reachability::ResultPrinter::Result> cardinality{
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied};
+    const std::vector<Reachability::ResultPrinter::Result> fireability{
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::Satisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::NotSatisfied,
+        ResultPrinter::Satisfied};
+
+    for (auto& [file, expected] : {std::make_pair("LTLCardinality.xml", cardinality),
+                                   std::make_pair("LTLFireability.xml", fireability)}) {
+        auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+            std::string("/models/Angiogenesis-PT-01/") + file, qnums, TemporalLogic::LTL);
+
+        for (auto i : qnums) {
+            for (uint32_t threads : {1, 2, 4}) {
+                for (bool weak : {false, true}) {
+                    std::cerr << file << " Q[" << i << "] threads=" << threads << " weak=" << std::boolalpha << weak << std::endl;
+                    LTL::LTLSearch search(*pn, conditions[i], LTL::BuchiOptimization::Low, LTL::APCompression::None);
+                    auto r = search.solve(false, 0, LTL::Algorithm::ParallelNDFS, LTL::LTLPartialOrder::None,
+                        Strategy::DFS, LTL::LTLHeuristic::DFS, weak, 0, StateStorage::Exact, 0, threads);
+                    auto result = r ? ResultPrinter::Satisfied : ResultPrinter::NotSatisfied;
+                    BOOST_REQUIRE_EQUAL(expected[i], result);
+                }
+            }
+        }
+    }
+}
+#endif
@@ -20,8 +20,23 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <map>
 
 #include "utils.h"
+#include "PetriEngine/IncrementalSuccessorGenerator.h"
+#include "PetriEngine/PackedSuccessorGenerator.h"
+#include "PetriEngine/PQL/QueryProgram.h"
+#include "PetriEngine/PQL/Evaluation.h"
+#include "PetriEngine/PQL/PrepareForReachability.h"
+#include "PetriEngine/PQL/Simplifier.h"
+#include "PetriEngine/Structures/MarkingBatch.h"
+
+#ifdef VERIFYPN_MultiCore
+#include "PetriEngine/Reachability/ParallelReachabilitySearch.h"
+#include "PetriEngine/Reachability/PortfolioReachabilitySearch.h"
+#endif
 
 using namespace PetriEngine;
 using namespace PetriEngine::Colored;
@@ -114,3 +129,486 @@ BOOST_AUTO_TEST_CASE(AngiogenesisPT01ReachabilityFireability, * utf::timeout(60)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01ReachabilityCardinalityExternal, * utf::timeout(120)) {
+
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::vector<Reachability::ResultPrinter::Result> expected{
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied};
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", qnums);
+
+    ResultHandler handler;
+
+    for (auto i : qnums) {
+        for (bool stub :{true, false}) {
+            auto c2 = prepareForReachability(conditions[i]);
+            ReachabilitySearch strategy(*pn, handler, 0);
+            // smallest budget, so large layers are written as several runs
+            strategy.setExternalMemory("", 1);
+            std::vector<Condition_ptr> vec{c2};
+            std::vector<Reachability::ResultPrinter::Result> results{Reachability::ResultPrinter::Unknown};
+            strategy.reachable(vec, results, Strategy::ExternalBFS, stub, false, StatisticsLevel::None, false, 0);
+            BOOST_REQUIRE_EQUAL(expected[i], results[0]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ExternalStateSetVisitedRuns, * utf::timeout(120)) {
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", {0});
+
+    SuccessorGenerator generator(*pn);
+    Structures::State state;
+    Structures::State working;
+    state.setMarking(pn->makeInitialMarking());
+    working.setMarking(pn->makeInitialMarking());
+
+    // the whole state space is explored layer by layer, and stored in memory for reference
+    Structures::StateSet reference(*pn, 0);
+    Structures::ExternalStateSet external(*pn, 0, "", 1);
+    reference.add(state);
+    external.add(state);
+    while (external.next(state)) {
+        generator.prepare(&state);
+        while (generator.next(working)) {
+            reference.add(working);
+            external.add(working);
+        }
+        // the layers are merged lazily into logarithmically many runs
+        BOOST_REQUIRE_LE(external.visitedRuns(), std::log2(external.size() + 1) + 1);
+    }
+    BOOST_REQUIRE_GT(external.layers(), 1);
+    BOOST_REQUIRE_EQUAL(external.size(), reference.size());
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01ReachabilityCardinalityApproximate, * utf::timeout(120)) {
+
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::vector<Reachability::ResultPrinter::Result> expected{
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied};
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", qnums);
+
+    ResultHandler handler;
+
+    for (auto i : qnums) {
+        for (auto storage :{StateStorage::HashCompaction, StateStorage::Bitstate}) {
+            for (auto search :{Strategy::BFS, Strategy::DFS, Strategy::HEUR}) {
+                auto c2 = prepareForReachability(conditions[i]);
+                ReachabilitySearch strategy(*pn, handler, 0);
+                // the state space is small enough that 1 MB should not lose any state
+                strategy.setStateStorage(storage, 1);
+                std::vector<Condition_ptr> vec{c2};
+                std::vector<Reachability::ResultPrinter::Result> results{Reachability::ResultPrinter::Unknown};
+                strategy.reachable(vec, results, search, true, false, StatisticsLevel::None, false, 0);
+                BOOST_REQUIRE_EQUAL(expected[i], results[0]);
+            }
+        }
+    }
+}
+
+// explores the state space in DFS order and checks that G produces the same successors as SuccessorGenerator
+template<typename G>
+void compareSuccessors(const PetriNet& net, G& generator) {
+    const auto nplaces = net.numberOfPlaces();
+    SuccessorGenerator plain(net);
+    std::set<std::vector<MarkVal>> seen;
+    std::vector<std::vector<MarkVal>> stack;
+    {
+        Structures::State initial(net.makeInitialMarking());
+        stack.emplace_back(initial.marking(), initial.marking() + nplaces);
+    }
+    seen.insert(stack.back());
+
+    Structures::State state(new MarkVal[nplaces]);
+    Structures::State a(new MarkVal[nplaces]);
+    Structures::State b(new MarkVal[nplaces]);
+    while (!stack.empty()) {
+        auto marking = std::move(stack.back());
+        stack.pop_back();
+        state.copy(marking.data(), nplaces);
+        plain.prepare(&state);
+        generator.prepare(&state);
+        while (plain.next(a)) {
+            BOOST_REQUIRE(generator.next(b));
+            BOOST_REQUIRE_EQUAL(plain.fired(), generator.fired());
+            BOOST_REQUIRE(generator.enabled(plain.fired()));
+            BOOST_REQUIRE(std::equal(a.marking(), a.marking() + nplaces, b.marking()));
+            std::vector<MarkVal> succ(a.marking(), a.marking() + nplaces);
+            if (seen.insert(succ).second)
+                stack.emplace_back(std::move(succ));
+        }
+        BOOST_REQUIRE(!generator.next(b));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01IncrementalSuccessors, * utf::timeout(60)) {
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", {0});
+
+    // DFS order, so most steps are a single firing apart
+    IncrementalSuccessorGenerator incremental(*pn);
+    compareSuccessors(*pn, incremental);
+    BOOST_REQUIRE_GT(incremental.updates(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01PackedSuccessors, * utf::timeout(60)) {
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", {0});
+
+    BOOST_REQUIRE(PackedSuccessorGenerator<true>::applicable(*pn));
+    PackedSuccessorGenerator<true> inhibitors(*pn);
+    compareSuccessors(*pn, inhibitors);
+    if (!pn->has_inhibitor()) {
+        BOOST_REQUIRE(PackedSuccessorGenerator<false>::applicable(*pn));
+        PackedSuccessorGenerator<false> packed(*pn);
+        compareSuccessors(*pn, packed);
+    }
+}
+
+// every marking reachable from the initial marking, in DFS order
+std::vector<std::vector<MarkVal>> reachableMarkings(const PetriNet& net) {
+    const auto nplaces = net.numberOfPlaces();
+    SuccessorGenerator generator(net);
+    std::set<std::vector<MarkVal>> seen;
+    std::vector<std::vector<MarkVal>> stack;
+    std::vector<std::vector<MarkVal>> markings;
+    {
+        Structures::State initial(net.makeInitialMarking());
+        stack.emplace_back(initial.marking(), initial.marking() + nplaces);
+    }
+    seen.insert(stack.back());
+
+    Structures::State state(new MarkVal[nplaces]);
+    Structures::State next(new MarkVal[nplaces]);
+    while (!stack.empty()) {
+        markings.push_back(std::move(stack.back()));
+        stack.pop_back();
+        state.copy(markings.back().data(), nplaces);
+        generator.prepare(&state);
+        while (generator.next(next)) {
+            std::vector<MarkVal> succ(next.marking(), next.marking() + nplaces);
+            if (seen.insert(succ).second)
+                stack.emplace_back(std::move(succ));
+        }
+    }
+    return markings;
+}
+
+// the queries of the file, with the reachability queries also as the searches see them
+std::pair<std::unique_ptr<PetriNet>, std::vector<Condition_ptr>> loadAngiogenesisQueries(const std::string& file) {
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/" + file, qnums);
+    std::vector<Condition_ptr> queries = conditions;
+    if (file.rfind("Reachability", 0) == 0)
+        for (auto& c : conditions)
+            queries.push_back(prepareForReachability(c));
+    return {std::move(pn), std::move(queries)};
+}
+
+// distances are not defined for path formulas such as E, where Condition::distance throws
+bool hasDistance(const Condition_ptr& query, const PetriNet& net) {
+    Structures::State initial(net.makeInitialMarking());
+    PQL::DistanceContext dc(&net, initial.marking());
+    try {
+        (void)query->distance(dc);
+        return true;
+    } catch (const base_error&) {
+        return false;
+    }
+}
+
+const std::vector<std::string> angiogenesisQueryFiles{
+    "ReachabilityCardinality.xml", "ReachabilityFireability.xml", "CTLCardinality.xml", "CTLFireability.xml"};
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01CompiledQueries, * utf::timeout(120)) {
+
+    for (auto& file : angiogenesisQueryFiles) {
+        auto [pn, queries] = loadAngiogenesisQueries(file);
+        const PQL::QueryProgram program(queries);
+        auto scratch = program.make_scratch();
+
+        for (auto& marking : reachableMarkings(*pn)) {
+            PQL::EvaluationContext context(marking.data(), pn.get());
+            for (auto& q : queries) {
+                BOOST_REQUIRE(program.contains(q.get()));
+                BOOST_REQUIRE_EQUAL(program.evaluate(q.get(), context, scratch), PQL::evaluate(q.get(), context));
+                if (hasDistance(q, *pn)) {
+                    PQL::DistanceContext dc(pn.get(), marking.data());
+                    BOOST_REQUIRE_EQUAL(program.distance(q.get(), context, scratch), q->distance(dc));
+                } else {
+                    BOOST_REQUIRE_THROW(program.distance(q.get(), context, scratch), base_error);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01BatchedQueries, * utf::timeout(120)) {
+
+    // restores the process-wide setting also when a check fails
+    struct VectorizedRestorer {
+        const bool vectorized = PQL::QueryProgram::vectorized();
+        ~VectorizedRestorer() { PQL::QueryProgram::set_vectorized(vectorized); }
+    } restorer;
+    for (auto& file : angiogenesisQueryFiles) {
+        auto [pn, queries] = loadAngiogenesisQueries(file);
+        const PQL::QueryProgram program(queries);
+        auto scratch = program.make_scratch();
+        const auto markings = reachableMarkings(*pn);
+
+        for (bool simd : {false, true}) {
+            PQL::QueryProgram::set_vectorized(simd);
+            // a batch of one, batches that grow, and batches smaller than a vector
+            for (uint32_t size : {1, 3, 37, 200}) {
+                Structures::MarkingBatch batch(pn->numberOfPlaces(), 2);
+                std::vector<PQL::Condition::Result> results(size);
+                std::vector<uint32_t> distances(size);
+                for (size_t begin = 0; begin < markings.size(); begin += size) {
+                    batch.clear();
+                    for (size_t m = begin; m < std::min(begin + size, markings.size()); ++m)
+                        batch.push(markings[m].data());
+                    for (auto& q : queries) {
+                        const bool distance = hasDistance(q, *pn);
+                        program.evaluate(q.get(), batch, pn.get(), scratch, results.data());
+                        if (distance)
+                            program.distance(q.get(), batch, pn.get(), scratch, distances.data());
+                        for (uint32_t l = 0; l < batch.size(); ++l) {
+                            BOOST_REQUIRE(std::equal(markings[begin + l].begin(), markings[begin + l].end(),
+                                                     batch.marking(l)));
+                            PQL::EvaluationContext context(batch.marking(l), pn.get());
+                            BOOST_REQUIRE_EQUAL(results[l], PQL::evaluate(q.get(), context));
+                            if (distance) {
+                                PQL::DistanceContext dc(pn.get(), batch.marking(l));
+                                BOOST_REQUIRE_EQUAL(distances[l], q->distance(dc));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01SimplifyWithSharedLP, * utf::timeout(120)) {
+
+    for (auto& file : {"ReachabilityCardinality.xml", "ReachabilityFireability.xml", "CTLCardinality.xml"}) {
+        auto [pn, queries] = loadAngiogenesisQueries(file);
+        std::unique_ptr<MarkVal[]> marking(pn->makeInitialMarking());
+        // every program is solved once on a state equation of its own, and twice on a shared one
+        Simplification::LPCache shared;
+        for (size_t round = 0; round < 2; ++round) {
+            for (auto& q : queries) {
+                Simplification::LPCache own;
+                PQL::SimplificationContext fresh(marking.get(), pn.get(), 60, 10, &own);
+                PQL::SimplificationContext reused(marking.get(), pn.get(), 60, 10, &shared);
+                std::stringstream expected, actual;
+                PQL::simplify(q, fresh).formula->toString(expected);
+                PQL::simplify(q, reused).formula->toString(actual);
+                BOOST_REQUIRE_EQUAL(expected.str(), actual.str());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01QueryGroups, * utf::timeout(120)) {
+
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::vector<Reachability::ResultPrinter::Result> expected{
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied};
+
+    auto [conditions, builder, qstrings, trans_names, place_names] = load_builder("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", qnums);
+    builder.freezeOriginalSize();
+
+    std::vector<Reachability::ResultPrinter::Result> results(conditions.size(), Reachability::ResultPrinter::Unknown);
+    auto groups = builder.queryGroups(conditions, results, nullptr);
+    BOOST_REQUIRE_GT(groups.size(), 1);
+    std::vector<size_t> grouped;
+    for (auto& group : groups)
+        grouped.insert(grouped.end(), group.begin(), group.end());
+    std::sort(grouped.begin(), grouped.end());
+    BOOST_REQUIRE_EQUAL(grouped.size(), conditions.size());
+    for (size_t i = 0; i < grouped.size(); ++i)
+        BOOST_REQUIRE_EQUAL(grouped[i], i);
+
+    // records the index every result is reported under
+    class IndexRecorder : public Reachability::AbstractHandler {
+        ResultHandler _handler;
+    public:
+        std::map<size_t, Reachability::ResultPrinter::Result> reported;
+        std::pair<Result, bool> handle(size_t index, PQL::Condition* query, Result result,
+            const std::vector<uint32_t>* maxPlaceBound, size_t expandedStates, size_t exploredStates,
+            size_t discoveredStates, int maxTokens, Structures::StateSetInterface* stateset, size_t lastmarking,
+            const MarkVal* initialMarking, bool trace) override {
+            auto retval = static_cast<AbstractHandler&>(_handler).handle(index, query, result);
+            BOOST_REQUIRE(reported.emplace(index, retval.first).second);
+            return retval;
+        }
+    };
+
+    options_t options;
+    options.cores = 4;
+    options.strategy = Strategy::DFS;
+    options.printstatistics = StatisticsLevel::None;
+    auto reduced = reduceQueryGroups(builder, groups, conditions, results, options);
+    BOOST_REQUIRE_EQUAL(reduced.size(), groups.size());
+    for (auto& group_builder : reduced)
+        BOOST_REQUIRE_LE(group_builder->numberOfUnskippedPlaces(), builder.numberOfUnskippedPlaces());
+
+    // every group is verified on its own net, results are reported under the original index;
+    // RPFS initializes its potencies on the net of each group
+    for (auto strategy : {Strategy::DFS, Strategy::RPFS}) {
+        options.strategy = strategy;
+        std::fill(results.begin(), results.end(), Reachability::ResultPrinter::Unknown);
+        IndexRecorder handler;
+        verifyQueryGroups(builder, groups, conditions, results, false, trans_names, place_names, handler, options);
+        BOOST_REQUIRE_EQUAL(handler.reported.size(), conditions.size());
+        for (size_t i = 0; i < conditions.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(expected[i], results[i]);
+            BOOST_REQUIRE_EQUAL(expected[i], handler.reported.at(i));
+        }
+    }
+}
+
+#ifdef VERIFYPN_MultiCore
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01ReachabilityCardinalityParallel, * utf::timeout(120)) {
+
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::vector<Reachability::ResultPrinter::Result> expected{
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied};
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", qnums);
+
+    ResultHandler handler;
+
+    for (auto i : qnums) {
+        for (auto search :{Strategy::BFS, Strategy::DFS, Strategy::HEUR, Strategy::RDFS}) {
+            for (bool stub :{true, false}) {
+                for (bool trace :{true, false}) {
+                    auto c2 = prepareForReachability(conditions[i]);
+                    ParallelReachabilitySearch strategy(*pn, handler, 4, 0);
+                    std::vector<Condition_ptr> vec{c2};
+                    std::vector<Reachability::ResultPrinter::Result> results{Reachability::ResultPrinter::Unknown};
+                    strategy.reachable(vec, results, search, stub, false, StatisticsLevel::None, trace, 0);
+                    BOOST_REQUIRE_EQUAL(expected[i], results[0]);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AngiogenesisPT01ReachabilityCardinalityPortfolio, * utf::timeout(120)) {
+
+    std::set<size_t> qnums{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::vector<Reachability::ResultPrinter::Result> expected{
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::Satisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied,
+        Reachability::ResultPrinter::NotSatisfied};
+
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", qnums);
+
+    ResultHandler handler;
+    std::vector<std::vector<std::string>> portfolios{
+        {"BestFS", "DFS", "RDFS", "RandomWalk", "RandomWalk", "TAR"},
+        {"RandomWalk", "TAR"},
+        {"BFS", "RandomWalk"}};
+
+    for (auto& engines : portfolios) {
+        for (bool stub :{true, false}) {
+            std::vector<Condition_ptr> vec;
+            for (auto i : qnums)
+                vec.push_back(prepareForReachability(conditions[i]));
+            std::vector<Reachability::ResultPrinter::Result> results(vec.size(), Reachability::ResultPrinter::Unknown);
+            PortfolioReachabilitySearch portfolio(*pn, handler, nullptr, 0);
+            BOOST_REQUIRE(portfolio.reachable(vec, results, engines, stub, StatisticsLevel::None, 0));
+            for (auto i : qnums) {
+                BOOST_REQUIRE_EQUAL(expected[i], results[i]);
+                BOOST_REQUIRE(std::find(engines.begin(), engines.end(),
+                    portfolio.winner(i).substr(0, portfolio.winner(i).find('#'))) != engines.end());
+            }
+        }
+    }
+}
+#endif
@@ -155,4 +155,108 @@ BOOST_AUTO_TEST_CASE(ruleGFail, * utf::timeout(60)) {
             ++i;
         }
     }
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(ReductionCandidatesPasses) {
+    ReductionCandidates candidates;
+    auto pass = [&candidates](uint32_t size) {
+        std::vector<uint32_t> nodes;
+        candidates.begin(size);
+        for (uint32_t n; candidates.next(n);)
+            nodes.push_back(n);
+        return nodes;
+    };
+    using nodes_t = std::vector<uint32_t>;
+
+    // the first pass examines every node, later passes only the touched ones, in order
+    BOOST_REQUIRE(pass(5) == (nodes_t{0, 1, 2, 3, 4}));
+    BOOST_REQUIRE(pass(5).empty());
+    candidates.touch(3);
+    candidates.touch(1);
+    candidates.touch(3);
+    BOOST_REQUIRE(pass(5) == (nodes_t{1, 3}));
+
+    // a node touched ahead of the cursor is examined in the same pass, one behind it in the next
+    candidates.touch(2);
+    candidates.touch(4);
+    candidates.begin(5);
+    uint32_t n;
+    BOOST_REQUIRE(candidates.next(n));
+    BOOST_REQUIRE_EQUAL(n, 2);
+    candidates.touch(0);
+    candidates.touch(2);
+    candidates.touch(3);
+    candidates.touch(3);
+    nodes_t rest;
+    while (candidates.next(n))
+        rest.push_back(n);
+    BOOST_REQUIRE(rest == (nodes_t{3, 4}));
+    BOOST_REQUIRE(pass(5) == (nodes_t{0, 2}));
+
+    // nodes at or above the size of a pass are left for the first pass that reaches them
+    candidates.touch(1);
+    BOOST_REQUIRE(pass(7) == (nodes_t{1, 5, 6}));
+    candidates.touch(6);
+    candidates.touch(0);
+    BOOST_REQUIRE(pass(4) == (nodes_t{0}));
+    BOOST_REQUIRE(pass(7) == (nodes_t{6}));
+
+    // a pass cut short is followed by a full pass, as is touchAll
+    candidates.touch(0);
+    candidates.touch(2);
+    candidates.begin(3);
+    BOOST_REQUIRE(candidates.next(n));
+    BOOST_REQUIRE_EQUAL(n, 0);
+    BOOST_REQUIRE(pass(3) == (nodes_t{0, 1, 2}));
+    candidates.touchAll();
+    BOOST_REQUIRE(pass(3) == (nodes_t{0, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalReductionMatchesFullScans, * utf::timeout(600)) {
+    const std::vector<std::pair<std::string, std::string>> models{
+        {"/models/rule_D.pnml", "/models/rule_D.xml"},
+        {"/models/Referendum-PT-0015/model.pnml", "/models/Referendum-PT-0015/LTLCardinality.xml"},
+        {"/models/Angiogenesis-PT-01/model.pnml", "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml"},
+        {"/models/Angiogenesis-PT-01/model.pnml", "/models/Angiogenesis-PT-01/LTLFireability.xml"},
+        {"/models/Angiogenesis-PT-01/model.pnml", "/models/Angiogenesis-PT-01/UpperBounds.xml"},
+        {"/models/DiscoveryGPU-PT-15a/model.pnml", "/models/DiscoveryGPU-PT-15a/CTLCardinality.xml"},
+        {"/models/Kanban-PT-02000/model.pnml", "/models/Kanban-PT-02000/errG.xml"},
+        {"/models/NeoElection-COL-3/model.pnml", "/models/NeoElection-COL-3/ReachabilityCardinality.xml"},
+        {"/models/Peterson-COL-2/model.pnml", "/models/Peterson-COL-2/ReachabilityCardinality.xml"},
+        {"/models/PhilosophersDyn-COL-03/model.pnml", "/models/PhilosophersDyn-COL-03/ReachabilityCardinality.xml"},
+        {"/models/UtilityControlRoom-COL-Z2T3N04/model.pnml", "/models/UtilityControlRoom-COL-Z2T3N04/ReachabilityCardinality.xml"}
+    };
+    for (auto& [model, queries] : models) {
+        // fewer queries leave more of the net to reduce
+        for (size_t nqueries : {1, 16}) {
+            std::set<size_t> qnums;
+            for (size_t i = 0; i < nqueries; ++i)
+                qnums.insert(i);
+            // loaded once, as an unfolded net may order its places differently on the next load
+            auto [conditions, builder, qstrings, trans_names, place_names] = load_builder(model, queries, qnums);
+            // the default reductions, those for k-bound queries and the rules with candidate indexes
+            for (int type : {1, 2, 3}) {
+                std::string reduced[2];
+                for (bool incremental : {false, true}) {
+                    PetriNetBuilder copy(builder);
+                    copy.getReducer()->setIncrementalScans(incremental);
+                    std::vector<Reachability::ResultPrinter::Result> results(conditions.size(),
+                        Reachability::ResultPrinter::Unknown);
+                    std::vector<uint32_t> reductions;
+                    if (type == 3)
+                        reductions = {0, 1, 2, 3, 5, 6, 11, 13, 16, 0, 1};
+                    std::unique_ptr<PetriNet> net{copy.makePetriNet(false)};
+                    contextAnalysis(false, trans_names, place_names, copy, net.get(), conditions);
+                    copy.reduce(conditions, results, type, false, net.get(), 300, reductions);
+                    net.reset(copy.makePetriNet(false));
+                    std::stringstream ss;
+                    copy.printStats(ss);
+                    net->toXML(ss);
+                    reduced[incremental] = ss.str();
+                }
+                BOOST_REQUIRE_MESSAGE(reduced[0] == reduced[1], model << " " << queries << " with " << nqueries
+                                      << " queries, reduction type " << type);
+            }
+        }
+    }
+}
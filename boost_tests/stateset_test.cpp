@@ -0,0 +1,146 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE stateset
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "utils.h"
+#include "PetriEngine/Structures/ConcurrentStateSet.h"
+
+using namespace PetriEngine;
+using namespace PetriEngine::Structures;
+namespace utf = boost::unit_test;
+
+// collect the first n markings of a BFS through the net
+std::vector<std::unique_ptr<MarkVal[]>> collect_markings(const PetriNet& net, size_t n) {
+    std::vector<std::unique_ptr<MarkVal[]>> markings;
+    StateSet states(net, 0);
+    SuccessorGenerator generator(net);
+    State state;
+    State working;
+    state.setMarking(net.makeInitialMarking());
+    working.setMarking(net.makeInitialMarking());
+    states.add(state);
+    BFSQueue queue(0);
+    queue.push(0, nullptr, nullptr);
+    for (auto nid = queue.pop(); nid != Queue::EMPTY && markings.size() < n; nid = queue.pop()) {
+        states.decode(state, nid);
+        markings.emplace_back(std::make_unique<MarkVal[]>(net.numberOfPlaces()));
+        std::copy(state.marking(), state.marking() + net.numberOfPlaces(), markings.back().get());
+        generator.prepare(&state);
+        while (generator.next(working)) {
+            auto res = states.add(working);
+            if (res.first)
+                queue.push(res.second, nullptr, nullptr);
+        }
+    }
+    return markings;
+}
+
+// every thread inserts every marking, starting at a different offset
+template<typename F>
+double insert_all(const std::vector<std::unique_ptr<MarkVal[]>>& markings, size_t threads, F&& insert) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w] {
+            State s;
+            for (size_t i = 0; i < markings.size(); ++i) {
+                auto index = (i + w * (markings.size() / threads)) % markings.size();
+                s.setMarking(markings[index].get());
+                insert(s, w, index);
+            }
+            s.release();
+        });
+    }
+    for (auto& t : workers)
+        t.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+BOOST_AUTO_TEST_CASE(DirectoryTest) {
+    BOOST_REQUIRE(getenv("TEST_FILES"));
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentStateSetStableIds, * utf::timeout(60)) {
+    auto [pn, conditions, qstrings] = load_pn("/models/Angiogenesis-PT-01/model.pnml",
+        "/models/Angiogenesis-PT-01/ReachabilityCardinality.xml", {0});
+    auto markings = collect_markings(*pn, 20000);
+    BOOST_REQUIRE(!markings.empty());
+
+    const size_t threads = 8;
+    ConcurrentStateSet states(*pn, 0, threads, true);
+    std::vector<std::vector<size_t>> ids(threads, std::vector<size_t>(markings.size()));
+    {
+        // a lookup does not fix the shard rotation, so it may come before the first add
+        State other(markings[1].get());
+        BOOST_REQUIRE(!states.lookup(other, 1).first);
+        other.release();
+        // the initial marking is added first and must be id 0
+        State s(markings[0].get());
+        auto r = states.add(s, 0);
+        s.release();
+        BOOST_REQUIRE(r.first);
+        BOOST_REQUIRE_EQUAL(r.second, 0);
+    }
+    insert_all(markings, threads, [&](State& s, size_t w, size_t index) {
+        ids[w][index] = states.add(s, w).second;
+    });
+    BOOST_REQUIRE_EQUAL(states.size(), markings.size());
+
+    State decoded;
+    decoded.setMarking(pn->makeInitialMarking());
+    for (size_t i = 0; i < markings.size(); ++i) {
+        for (size_t w = 1; w < threads; ++w)
+            BOOST_REQUIRE_EQUAL(ids[0][i], ids[w][i]);
+        states.decode(decoded, ids[0][i], i % threads);
+        BOOST_REQUIRE(std::equal(decoded.marking(), decoded.marking() + pn->numberOfPlaces(), markings[i].get()));
+        states.setHistory(ids[0][i], i, 0);
+        BOOST_REQUIRE_EQUAL(states.getHistory(ids[0][i]).first, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentStateSetInsertThroughput, * utf::timeout(600)) {
+    auto [pn, conditions, qstrings] = load_pn("/models/Kanban-PT-02000/model.pnml",
+        "/models/Kanban-PT-02000/errG.xml", {0});
+    auto markings = collect_markings(*pn, 100000);
+    BOOST_REQUIRE(!markings.empty());
+
+    for (size_t threads : {1, 8, 32, 64}) {
+        StateSet sequential(*pn, 0);
+        std::mutex lock;
+        auto tseq = insert_all(markings, threads, [&](State& s, size_t, size_t) {
+            std::lock_guard<std::mutex> guard(lock);
+            sequential.add(s);
+        });
+
+        ConcurrentStateSet concurrent(*pn, 0, threads, false);
+        auto tcon = insert_all(markings, threads, [&](State& s, size_t w, size_t) {
+            concurrent.add(s, w);
+        });
+
+        BOOST_REQUIRE_EQUAL(sequential.size(), markings.size());
+        BOOST_REQUIRE_EQUAL(concurrent.size(), markings.size());
+        auto inserts = static_cast<double>(markings.size() * threads);
+        BOOST_TEST_MESSAGE("threads: " << threads
+            << " StateSet (locked): " << inserts / tseq << " inserts/s"
+            << " ConcurrentStateSet: " << inserts / tcon << " inserts/s");
+    }
+}
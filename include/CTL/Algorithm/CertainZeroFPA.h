@@ -24,6 +24,8 @@ protected:
 
     DependencyGraph::BasicDependencyGraph *graph;
     DependencyGraph::Configuration* vertex;
+    // reused by explore, which is not re-entered
+    std::vector<DependencyGraph::Edge*> _succs;
 
     void checkEdge(DependencyGraph::Edge* e, bool only_assign = false);
     void finalAssign(DependencyGraph::Configuration *c, DependencyGraph::Assignment a);
@@ -19,6 +19,7 @@ public:
 
 protected:
     DependencyGraph::BasicDependencyGraph *graph;
+    std::vector<DependencyGraph::Edge*> _succs;
 
     void finalAssign(DependencyGraph::Configuration *c, DependencyGraph::Assignment a);
     void explore(DependencyGraph::Configuration *c);
@@ -0,0 +1,77 @@
+#ifndef PARALLELCERTAINZEROFPA_H
+#define PARALLELCERTAINZEROFPA_H
+
+#include "FixedPointAlgorithm.h"
+#include "CTL/DependencyGraph/Edge.h"
+#include "CTL/DependencyGraph/Configuration.h"
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Algorithm {
+
+/**
+ * Multi-threaded variant of CertainZeroFPA. The workers share the dependency
+ * graph, each worker owns a queue of edges and idle workers steal from the
+ * queues of the others.
+ *
+ * Assignments only move forward by compare-and-swap, so a configuration is
+ * explored and assigned by exactly one worker. Edges register with their
+ * targets through the lock-free DependencySet, and the worker assigning a
+ * configuration closes its set and pushes the dependents; an edge that finds
+ * a closed set is checked again instead.
+ *
+ * Negation edges are released when every worker is idle, all edges of the
+ * largest distance at once, as the sequential algorithm does when its
+ * waiting list runs empty. Edges are not recycled during the search.
+ */
+class ParallelCertainZeroFPA : public FixedPointAlgorithm
+{
+public:
+    ParallelCertainZeroFPA(Strategy type, uint32_t threads);
+    virtual ~ParallelCertainZeroFPA()
+    {
+    }
+    virtual bool search(DependencyGraph::BasicDependencyGraph &t_graph) override;
+private:
+    struct alignas(64) worker_t {
+        explicit worker_t(size_t id) : id(id) {}
+        std::mutex lock;
+        std::deque<DependencyGraph::Edge*> queue;
+        std::vector<DependencyGraph::Edge*> succs;
+        size_t id;
+        size_t processedEdges = 0;
+        size_t processedNegationEdges = 0;
+        size_t exploredConfigurations = 0;
+        size_t numberOfEdges = 0;
+    };
+
+    void run(worker_t& worker);
+    void checkEdge(worker_t& worker, DependencyGraph::Edge* e, bool only_assign = false);
+    void killEdge(worker_t& worker, DependencyGraph::Edge* e);
+    void finalAssign(worker_t& worker, DependencyGraph::Configuration *c, DependencyGraph::Assignment a);
+    void explore(worker_t& worker, DependencyGraph::Configuration *c);
+    void releaseNegationEdges(worker_t& worker);
+    void push(worker_t& worker, DependencyGraph::Edge* e);
+    DependencyGraph::Edge* pop(worker_t& worker);
+
+    DependencyGraph::BasicDependencyGraph *graph = nullptr;
+    DependencyGraph::Configuration* vertex = nullptr;
+    uint32_t _threads;
+    bool _fifo;
+    std::vector<std::unique_ptr<worker_t>> _workers;
+    // processed negation edges that wait for their target to be assigned
+    std::vector<DependencyGraph::Edge*> _negations;
+    std::mutex _negationLock;
+    // edges pushed but not yet checked
+    std::atomic<size_t> _pending{0};
+    std::atomic<bool> _stop{false};
+    std::mutex _errorLock;
+    std::exception_ptr _error;
+};
+}
+#endif // PARALLELCERTAINZEROFPA_H
@@ -14,7 +14,8 @@
 
 bool CTLSingleSolve(PetriEngine::PQL::Condition* query, PetriEngine::PetriNet* net,
                     CTL::CTLAlgorithmType algorithmtype,
-                    Strategy strategytype, bool partial_order, CTLResult& result);
+                    Strategy strategytype, bool partial_order, CTLResult& result,
+                    uint32_t threads = 1);
 
 ReturnValue CTLMain(PetriEngine::PetriNet* net,
                     CTL::CTLAlgorithmType algorithmtype,
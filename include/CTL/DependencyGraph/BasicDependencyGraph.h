@@ -13,7 +13,13 @@ class Edge;
 class BasicDependencyGraph {
 
 public:
-    virtual std::vector<Edge*> successors(Configuration *c) =0;
+    // replaces the content of succs with the outgoing edges of c, so callers
+    // can reuse one buffer across calls
+    virtual void successors(Configuration *c, std::vector<Edge*>& succs) =0;
+    // successors may be called concurrently for distinct workers once the
+    // number of workers is set, which must happen before the first call
+    virtual void setWorkers(size_t workers) =0;
+    virtual void successors(Configuration *c, size_t worker, std::vector<Edge*>& succs) =0;
     virtual Configuration *initialConfiguration() =0;
     virtual void release(Edge* e) = 0;
     virtual void cleanUp() =0;
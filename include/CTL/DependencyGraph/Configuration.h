@@ -7,30 +7,125 @@
 #include <cstdio>
 #include <iostream>
 #include <vector>
-#include <forward_list>
+#include <atomic>
 #include <cstdint>
 
 namespace DependencyGraph {
 
 class Edge;
 
+/**
+ * The edges depending on a configuration, linked through the target slots of
+ * the edges. The sequential algorithms keep the set sorted and free of
+ * duplicate edges through insert(). The parallel algorithm adds slots with the
+ * lock-free push() and takes the set with close() when the configuration is
+ * assigned; pushing to a closed set fails, so no dependent is lost to a
+ * concurrent assignment.
+ */
+class DependencySet {
+public:
+    class iterator {
+    public:
+        explicit iterator(target_t* slot) : _slot(slot), _next(slot ? slot->next : nullptr) {}
+        Edge* operator*() const { return _slot->edge; }
+        // the next slot is read in advance, as visiting may release the edge
+        iterator& operator++() { _slot = _next; _next = _slot ? _slot->next : nullptr; return *this; }
+        bool operator==(const iterator& other) const { return _slot == other._slot; }
+        bool operator!=(const iterator& other) const { return _slot != other._slot; }
+    private:
+        target_t* _slot;
+        target_t* _next;
+    };
+
+    DependencySet() {}
+    DependencySet(const DependencySet&) = delete;
+    DependencySet& operator=(const DependencySet&) = delete;
+
+    iterator begin() const {
+        auto head = _head.load(std::memory_order_relaxed);
+        return iterator(head == closed() ? nullptr : head);
+    }
+    iterator end() const { return iterator(nullptr); }
+    bool empty() const { return begin() == end(); }
+
+    // not thread-safe; returns false if the edge of the slot is already in the set
+    bool insert(target_t& slot) {
+        target_t* prev = nullptr;
+        target_t* it = _head.load(std::memory_order_relaxed);
+        if(it == closed()) it = nullptr;
+        while(it != nullptr && it->edge < slot.edge)
+        {
+            prev = it;
+            it = it->next;
+        }
+        if(it != nullptr && it->edge == slot.edge) return false;
+        slot.next = it;
+        if(prev) prev->next = &slot;
+        else _head.store(&slot, std::memory_order_relaxed);
+        return true;
+    }
+
+    // returns false if the set has been closed
+    bool push(target_t& slot) {
+        auto head = _head.load(std::memory_order_acquire);
+        do {
+            if(head == closed())
+                return false;
+            slot.next = head;
+        } while(!_head.compare_exchange_weak(head, &slot, std::memory_order_release, std::memory_order_acquire));
+        return true;
+    }
+
+    // visits and removes every edge and makes later pushes fail
+    template<typename F>
+    void close(F&& visit) {
+        auto slot = _head.exchange(closed(), std::memory_order_acq_rel);
+        if(slot == closed()) return;
+        while(slot != nullptr)
+        {
+            auto next = slot->next;
+            visit(slot->edge);
+            slot = next;
+        }
+    }
+
+    // the slots belong to the edges, so there is nothing to free
+    void clear() {
+        if(_head.load(std::memory_order_relaxed) != closed())
+            _head.store(nullptr, std::memory_order_relaxed);
+    }
+
+private:
+    static target_t* closed() {
+        static target_t sentinel{nullptr, nullptr, nullptr};
+        return &sentinel;
+    }
+
+    std::atomic<target_t*> _head{nullptr};
+};
+
 class Configuration
 {
 public:
-    std::forward_list<Edge*> dependency_set;   
-    uint32_t nsuccs = 0;
+    DependencySet dependency_set;
+    std::atomic<uint32_t> nsuccs{0};
 private:
-    uint32_t distance = 0;
-    void setDistance(uint32_t value) { distance = value; }
+    std::atomic<uint32_t> distance{0};
+    void setDistance(uint32_t value) { distance.store(value, std::memory_order_relaxed); }
 public:
-    int8_t assignment = UNKNOWN;
+    std::atomic<int8_t> assignment{UNKNOWN};
     Configuration() {}
-    uint32_t getDistance() const { return distance; }
-    bool isDone() const { return assignment == ONE || assignment == CZERO; }
+    uint32_t getDistance() const { return distance.load(std::memory_order_relaxed); }
+    bool isDone() const { auto a = assignment.load(); return a == ONE || a == CZERO; }
     void addDependency(Edge* e);
+    // slot must be a target slot of its edge pointing to this configuration
+    void addDependency(target_t& slot);
+    // thread-safe; returns false if the configuration was assigned meanwhile
+    bool pushDependency(Edge* e);
+    bool pushDependency(target_t& slot);
     void setOwner(uint32_t) { }
     uint32_t getOwner() { return 0; }
-    
+
 };
 
 
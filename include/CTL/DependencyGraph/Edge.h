@@ -6,23 +6,108 @@
 #include <string>
 #include <algorithm>
 #include <cassert>
-#include <forward_list>
+#include <memory>
+#include <atomic>
 #include <cstdint>
 
 namespace DependencyGraph {
 
 class Configuration;
+class Edge;
 enum Assignment {
     ONE = 1, UNKNOWN = 0, ZERO = -1, CZERO = -2
 };
 
+/**
+ * A target of an edge. The slot doubles as the link of the edge in the
+ * dependency set of the target, so registering a dependency allocates nothing.
+ */
+struct target_t {
+    Configuration* conf;
+    target_t* next;
+    Edge* edge;
+};
+
+/**
+ * Bump allocator for the targets of edges with more than a few targets. The
+ * memory is owned by the arena and reused along with the edges.
+ */
+class TargetArena {
+public:
+    target_t* allocate(uint32_t n)
+    {
+        if(_used + n > _blockSize || _blocks.empty())
+        {
+            _blocks.emplace_back(new target_t[std::max(n, _blockSize)]);
+            _used = 0;
+        }
+        auto r = _blocks.back().get() + _used;
+        _used += n;
+        return r;
+    }
+private:
+    static constexpr uint32_t _blockSize = 1 << 14;
+    std::vector<std::unique_ptr<target_t[]>> _blocks;
+    uint32_t _used = 0;
+};
+
+/**
+ * The targets of an edge; the first ones are stored inline. A zeroed object
+ * is a valid empty set, as the edge allocator hands out cleared memory.
+ * Iteration visits the most recently added target first.
+ */
+class targets_t {
+    static constexpr uint32_t _inline = 2;
+public:
+    class iterator {
+    public:
+        explicit iterator(target_t* slot) : _slot(slot) {}
+        Configuration* operator*() const { return (_slot - 1)->conf; }
+        target_t& slot() const { return *(_slot - 1); }
+        iterator& operator++() { --_slot; return *this; }
+        bool operator==(const iterator& other) const { return _slot == other._slot; }
+        bool operator!=(const iterator& other) const { return _slot != other._slot; }
+    private:
+        target_t* _slot;
+    };
+
+    iterator begin() const { return iterator(data() + _size); }
+    iterator end() const { return iterator(data()); }
+    bool empty() const { return _size == 0; }
+    uint32_t size() const { return _size; }
+    Configuration* front() const { return data()[_size - 1].conf; }
+    // keeps the storage for the next user of the edge
+    void clear() { _size = 0; }
+
+    void push(Configuration* conf, Edge* edge, TargetArena& arena)
+    {
+        if(_size == capacity())
+        {
+            auto cap = capacity() * 2;
+            auto grown = arena.allocate(cap);
+            std::copy(data(), data() + _size, grown);
+            _data = grown;
+            _capacity = cap;
+        }
+        data()[_size++] = target_t{conf, nullptr, edge};
+    }
+
+private:
+    target_t* data() const { return _data ? _data : const_cast<target_t*>(_local); }
+    uint32_t capacity() const { return _data ? _capacity : _inline; }
+
+    target_t _local[_inline];
+    target_t* _data = nullptr;
+    uint32_t _size = 0;
+    uint32_t _capacity = 0;
+};
+
 class Edge {
-    typedef std::forward_list<Configuration*> container;
 public:
     Edge(){}
     Edge(Configuration &t_source) : source(&t_source) {}
 
-    bool addTarget(Configuration* conf)
+    bool addTarget(Configuration* conf, TargetArena& arena)
     {
         if(handled) return true;
         assert(conf);
@@ -31,16 +116,16 @@ public:
             handled = true;
             targets.clear();
         }
-        else targets.push_front(conf);
+        else targets.push(conf, this, arena);
         return handled;
     }
 
-    container targets;
+    targets_t targets;
     Configuration* source;
     uint8_t status = 0;
-    bool processed = false;
+    std::atomic<bool> processed{false};
     bool is_negated = false;
-    bool handled = false;
+    std::atomic<bool> handled{false};
     int32_t refcnt = 0;
     /*size_t children;
     Assignment assignment;*/
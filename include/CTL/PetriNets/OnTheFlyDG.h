@@ -1,7 +1,8 @@
 #ifndef ONTHEFLYDG_H
 #define ONTHEFLYDG_H
 
-#include <functional>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <ptrie/ptrie_map.h>
 
@@ -11,9 +12,11 @@
 #include "PetriConfig.h"
 #include "PetriParse/PNMLParser.h"
 #include "PetriEngine/PQL/PQL.h"
+#include "PetriEngine/PQL/QueryProgram.h"
 #include "PetriEngine/Structures/AlignedEncoder.h"
 #include "PetriEngine/Structures/linked_bucket.h"
 #include "PetriEngine/ReducingSuccessorGenerator.h"
+#include "PetriEngine/Stubborn/ReachabilityStubbornSet.h"
 
 namespace PetriNets {
 class OnTheFlyDG : public DependencyGraph::BasicDependencyGraph
@@ -27,7 +30,9 @@ public:
     virtual ~OnTheFlyDG();
 
     //Dependency graph interface
-    virtual std::vector<DependencyGraph::Edge*> successors(DependencyGraph::Configuration *c) override;
+    virtual void successors(DependencyGraph::Configuration *c, std::vector<DependencyGraph::Edge*>& succs) override;
+    virtual void successors(DependencyGraph::Configuration *c, size_t worker, std::vector<DependencyGraph::Edge*>& succs) override;
+    virtual void setWorkers(size_t workers) override;
     virtual DependencyGraph::Configuration *initialConfiguration() override;
     virtual void cleanUp() override;
     void setQuery(Condition* query);
@@ -49,12 +54,26 @@ public:
 
 protected:
 
+    // the state of one caller of successors; the workers share the markings,
+    // the configurations and the edge allocator
+    struct worker_t {
+        worker_t(PetriEngine::PetriNet *net, size_t id);
+        AlignedEncoder encoder;
+        Marking working_marking;
+        Marking query_marking;
+        std::shared_ptr<PetriEngine::ReachabilityStubbornSet> stubborn;
+        PetriEngine::ReducingSuccessorGenerator redgen;
+        std::stack<DependencyGraph::Edge*> recycle;
+        // holds the targets that do not fit inline in the edges
+        DependencyGraph::TargetArena arena;
+        // values of the compiled query in the markings evaluated by this worker
+        PetriEngine::PQL::QueryProgram::scratch_t scratch;
+        size_t id;
+    };
+
     //initialized from constructor
-    AlignedEncoder encoder;
     PetriEngine::PetriNet *net = nullptr;
     PetriConfig* initial_config;
-    Marking working_marking;
-    Marking query_marking;
     uint32_t n_transitions = 0;
     uint32_t n_places = 0;
     size_t _markingCount = 0;
@@ -63,26 +82,41 @@ protected:
     //used after query is set
     Condition* query = nullptr;
 
-    Condition::Result fastEval(Condition* query, Marking* unfolded);
-    Condition::Result fastEval(const Condition_ptr& query, Marking* unfolded)
+    Condition::Result fastEval(worker_t& worker, Condition* query, Marking* unfolded);
+    Condition::Result fastEval(worker_t& worker, const Condition_ptr& query, Marking* unfolded)
     {
-        return fastEval(query.get(), unfolded);
+        return fastEval(worker, query.get(), unfolded);
     }
-    void nextStates(Marking& t_marking, Condition*,
-    std::function<void ()> pre,
-    std::function<bool (Marking&)> foreach,
-    std::function<void ()> post);
-    template<typename T>
-    void dowork(T& gen, bool& first,
-    std::function<void ()>& pre,
-    std::function<bool (Marking&)>& foreach)
+    // copies the marking of the worker and tells whether the successors of
+    // the query may be reduced by the stubborn set
+    bool prepareNextStates(worker_t& worker, Condition* query);
+    // the callbacks are template parameters so they are inlined per case
+    template<typename Pre, typename ForEach, typename Post>
+    void nextStates(worker_t& worker, Condition* query, Pre&& pre, ForEach&& foreach, Post&& post)
     {
-        gen.prepare(&query_marking);
+        bool first = true;
+        if(prepareNextStates(worker, query))
+        {
+            worker.redgen.setQuery(query);
+            dowork(worker, worker.redgen, first, pre, foreach);
+        }
+        else
+        {
+            PetriEngine::SuccessorGenerator PNGen(*net);
+            dowork(worker, PNGen, first, pre, foreach);
+        }
 
-        while(gen.next(working_marking)){
+        if(!first) post();
+    }
+    template<typename T, typename Pre, typename ForEach>
+    void dowork(worker_t& worker, T& gen, bool& first, Pre& pre, ForEach& foreach)
+    {
+        gen.prepare(&worker.query_marking);
+
+        while(gen.next(worker.working_marking)){
             if(first) pre();
             first = false;
-            if(!foreach(working_marking))
+            if(!foreach(worker.working_marking))
             {
                 gen.reset();
                 break;
@@ -94,19 +128,28 @@ protected:
     {
         return createConfiguration(marking, own, query.get());
     }
-    size_t createMarking(Marking &marking);
+    size_t createMarking(worker_t& worker, Marking &marking);
     void markingStats(const uint32_t* marking, size_t& sum, bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last);
 
-    DependencyGraph::Edge* newEdge(DependencyGraph::Configuration &t_source, uint32_t weight);
+    DependencyGraph::Edge* newEdge(worker_t& worker, DependencyGraph::Configuration &t_source, uint32_t weight);
+    void release(worker_t& worker, DependencyGraph::Edge* e);
+
+    // the lock is only taken when there is more than one worker
+    std::unique_lock<std::mutex> lockShared();
 
-    std::stack<DependencyGraph::Edge*> recycle;
+    std::vector<std::unique_ptr<worker_t>> _workers;
     ptrie::map<ptrie::uchar, std::vector<PetriConfig*> > trie;
     linked_bucket_t<DependencyGraph::Edge,1024*10>* edge_alloc = nullptr;
 
     // Problem  with linked bucket and complex constructor
     linked_bucket_t<char[sizeof(PetriConfig)], 1024*1024>* conf_alloc = nullptr;
 
-    PetriEngine::ReducingSuccessorGenerator _redgen;
+    // guards the trie, the configurations and the statistics
+    std::mutex _lock;
+    // guards the query annotations set by the stubborn sets when the query is not thread-safe
+    std::mutex _queryLock;
+    // the query and all of its subformulas, compiled by setQuery
+    std::shared_ptr<const PetriEngine::PQL::QueryProgram> _program;
     bool _partial_order = false;
 
 };
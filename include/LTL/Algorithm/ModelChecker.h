@@ -94,6 +94,15 @@ namespace LTL {
             return LTLPartialOrder::None;
         }
 
+        /** True if visited states are stored approximately and states may have been omitted */
+        virtual bool is_approximate() const {
+            return false;
+        }
+
+        virtual double omission_probability() const {
+            return 0;
+        }
+
 
     protected:
         size_t _explored = 0;
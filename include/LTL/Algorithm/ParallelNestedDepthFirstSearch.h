@@ -0,0 +1,125 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
+#define VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
+
+#include "ModelChecker.h"
+#include "LTL/Structures/ConcurrentProductStateSet.h"
+#include "LTL/Structures/FlatBuchiAutomaton.h"
+#include "PetriEngine/SuccessorGenerator.h"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace LTL {
+
+    /**
+     * Multi-core nested depth-first search (CNDFS). Every worker runs its own
+     * blue and red search over the shared product state set, visiting successors
+     * in a worker specific random order; red (fully explored) states are shared
+     * so workers prune each other's nested searches. Based on
+     * <p>
+     *   Sami Evangelista, Alfons Laarman, Laure Petrucci and Jaco van de Pol,<br>
+     *   Improved Multi-Core Nested Depth-First Search,<br>
+     *   https://doi.org/10.1007/978-3-642-33386-6_14
+     * </p>
+     * Partial order reduction, heuristics, traces and hyper-LTL are not supported.
+     */
+    class ParallelNestedDepthFirstSearch : public ModelChecker {
+    public:
+        ParallelNestedDepthFirstSearch(const PetriEngine::PetriNet& net, const PetriEngine::PQL::Condition_ptr &query,
+                                       const Structures::BuchiAutomaton &buchi, uint32_t kbound,
+                                       uint32_t hyper_traces, uint32_t threads);
+
+        bool check() override;
+
+        void print_stats(std::ostream &os) const override;
+
+        size_t max_tokens() const override;
+
+        size_t get_discovered() const override;
+
+        size_t get_markings() const override;
+
+        size_t get_configurations() const override;
+
+    private:
+        using State = LTL::Structures::ProductState;
+        using state_set_t = LTL::Structures::ConcurrentProductStateSet<>;
+
+        static constexpr uint8_t CYAN = 1;
+        static constexpr uint8_t BLUE = 2;
+
+        struct frame_t {
+            Structures::stateid_t _id;
+            size_t _next;
+            std::vector<Structures::stateid_t> _successors;
+        };
+
+        struct alignas(64) worker_t {
+            worker_t(const PetriEngine::PetriNet& net, const Structures::FlatBuchiAutomaton& automaton,
+                     State parent, State working, size_t id)
+            : _id(id), _generator(net), _parent(std::move(parent)), _working(std::move(working)),
+              _valuation(net, automaton), _rng(id) {}
+
+            size_t _id;
+            PetriEngine::SuccessorGenerator _generator;
+            State _parent;
+            State _working;
+            Structures::FlatBuchiAutomaton::valuation_t _valuation;
+            // local colors, absent states are white
+            std::unordered_map<Structures::stateid_t, uint8_t> _colors;
+            // states visited by the current red search
+            std::unordered_set<Structures::stateid_t> _pink;
+            // frames are kept between searches to reuse their successor vectors
+            std::vector<frame_t> _blue_stack;
+            std::vector<frame_t> _red_stack;
+            std::default_random_engine _rng;
+            size_t _expanded = 0;
+        };
+
+        void run(worker_t& worker, state_set_t& states, std::vector<Structures::stateid_t> initial);
+        void blue_dfs(worker_t& worker, state_set_t& states, Structures::stateid_t init);
+        void red_dfs(worker_t& worker, state_set_t& states, Structures::stateid_t seed);
+        frame_t& push(worker_t& worker, state_set_t& states, std::vector<frame_t>& stack, size_t& depth,
+                      Structures::stateid_t id);
+        void expand(worker_t& worker, state_set_t& states, Structures::stateid_t id,
+                    std::vector<Structures::stateid_t>& successors);
+        void add_successors(worker_t& worker, state_set_t& states, uint32_t buchi_state,
+                            std::vector<Structures::stateid_t>& successors);
+        void report_violation();
+
+        const uint32_t _kbound = 0;
+        const uint32_t _hyper_traces = 0;
+        const uint32_t _threads = 1;
+        Structures::FlatBuchiAutomaton _automaton;
+        size_t _discovered = 0;
+        size_t _max_tokens = 0;
+        size_t _markings = 0;
+        size_t _configurations = 0;
+        std::atomic<bool> _found{false};
+        std::atomic<bool> _stop{false};
+        std::mutex _errorLock;
+        std::exception_ptr _error;
+    };
+}
+
+#endif //VERIFYPN_PARALLELNESTEDDEPTHFIRSTSEARCH_H
@@ -22,6 +22,7 @@
 #include "LTL/Algorithm/ModelChecker.h"
 #include "LTL/Structures/ProductStateFactory.h"
 #include "LTL/Structures/BitProductStateSet.h"
+#include "LTL/Structures/ApproximateProductStateSet.h"
 #include "LTL/SuccessorGeneration/ResumingSuccessorGenerator.h"
 #include "LTL/SuccessorGeneration/SpoolingSuccessorGenerator.h"
 #include "utils/structures/light_deque.h"
@@ -29,6 +30,7 @@
 #include <ptrie/ptrie.h>
 
 #include <limits>
+#include <vector>
 
 namespace LTL {
 
@@ -48,14 +50,14 @@ namespace LTL {
         TarjanModelChecker(const PetriEngine::PetriNet& net, const PetriEngine::PQL::Condition_ptr &cond,
                            const Structures::BuchiAutomaton &buchi,
                            uint32_t kbound, uint32_t hyper_traces)
-                : ModelChecker(net, cond, buchi), _k_bound(kbound), _hyper_traces(hyper_traces)
+                : ModelChecker(net, cond, buchi), _chash(size_t{1} << _initial_hash_bits, std::numeric_limits<idx_t>::max()),
+                  _k_bound(kbound), _hyper_traces(hyper_traces)
         {
             if (buchi.buchi().num_states() > 1048576) {
                 throw base_error("Cannot handle Büchi automata larger than 2^20 states");
             }
             if(_hyper_traces > 1)
                 throw base_error("Hyper-LTL not supported for Tarjans algorithm (yet).");
-            _chash.fill(std::numeric_limits<idx_t>::max());
         }
 
         bool check() override;
@@ -72,6 +74,24 @@ namespace LTL {
 
         virtual void set_partial_order(LTLPartialOrder);
 
+        /**
+         * Remember completed states by fingerprint only, see ApproximateProductStateSet.
+         * @param storage the kind of fingerprint table, Exact disables the approximation.
+         * @param memory the size of the fingerprint table in MB.
+         */
+        void set_state_storage(StateStorage storage, size_t memory) {
+            _storage = storage;
+            _memory_budget = memory;
+        }
+
+        bool is_approximate() const override {
+            return _storage != StateStorage::Exact;
+        }
+
+        double omission_probability() const override {
+            return _omission_probability;
+        }
+
         LTLPartialOrder used_partial_order() const {
             return _order;
         }
@@ -80,26 +100,38 @@ namespace LTL {
         template<typename SuccGen>
         bool select_trace_compute(SuccGen& successorGenerator);
 
-        template<bool TRACE, typename SuccGen>
+        template<bool TRACE, bool APPROXIMATE, typename SuccGen>
         bool compute(SuccGen& successorGenerator);
 
+        template<typename StateSet>
+        StateSet make_state_set() const {
+            if constexpr (std::is_same_v<StateSet, Structures::ApproximateProductStateSet<>>)
+                return StateSet(_net, _k_bound, _storage, _memory_budget * 1024 * 1024);
+            else
+                return StateSet(_net, _k_bound);
+        }
+
         using State = LTL::Structures::ProductState;
         using idx_t = size_t;
-        // 64 MB hash table
-        static constexpr idx_t _hash_sz = 16777216;
+        // 8 KB to start with, doubled whenever the cstack outgrows it
+        static constexpr size_t _initial_hash_bits = 10;
 
         ptrie::set<idx_t,17,32,8> _store;
 
         // rudimentary hash table of state IDs. chash[hash(state)] is the top index in cstack
         // corresponding to state. Collisions are resolved using linked list via CEntry::next.
-        std::array<idx_t, _hash_sz> _chash;
-        static_assert(sizeof(_chash) == (1U << 27U));
+        std::vector<idx_t> _chash;
+        size_t _hash_bits = _initial_hash_bits;
 
-        static inline idx_t hash(idx_t buchi_state, idx_t marking_id)
+        inline idx_t hash(idx_t stateid) const
         {
-            return (buchi_state xor marking_id) % _hash_sz;
+            // the product id keeps the Büchi state in its low bits, so mix before taking the top bits
+            return (stateid * 0x9E3779B97F4A7C15ULL) >> (64 - _hash_bits);
         }
 
+        template<typename T>
+        void grow_chash(light_deque<T>& cstack);
+
         struct plain_centry_t {
             idx_t _lowlink = std::numeric_limits<idx_t>::max();
             idx_t _stateid = std::numeric_limits<idx_t>::max();
@@ -138,6 +170,10 @@ namespace LTL {
         const uint32_t _k_bound = 0;
         const uint32_t _hyper_traces = 0;
         LTLPartialOrder _order = LTLPartialOrder::None;
+        StateStorage _storage = StateStorage::Exact;
+        // in MB
+        size_t _memory_budget = 0;
+        double _omission_probability = 0;
 
         // TODO, instead of this template hell, we should really just have a templated state that we shuffle around.
         template<typename StateSet, typename T, typename D, typename S>
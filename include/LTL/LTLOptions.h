@@ -23,7 +23,7 @@
 namespace LTL {
 
     enum class Algorithm {
-        NDFS, Tarjan, None = -1
+        NDFS, Tarjan, ParallelNDFS, None = -1
     };
 
     enum class BuchiOutType {
@@ -65,6 +65,8 @@ namespace LTL {
                 return "NDFS";
             case Algorithm::Tarjan:
                 return "TARJAN";
+            case Algorithm::ParallelNDFS:
+                return "PNDFS";
             case Algorithm::None:
             default:
                 throw base_error("to_string: Invalid LTL Algorithm ", static_cast<int> (alg));
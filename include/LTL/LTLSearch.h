@@ -62,7 +62,10 @@ namespace LTL {
                 const Strategy search_strategy = Strategy::HEUR,
                 const LTLHeuristic heuristics = LTLHeuristic::Automaton,
                 const bool utilize_weak = true,
-                const uint64_t seed = 0);
+                const uint64_t seed = 0,
+                const StateStorage storage = StateStorage::Exact,
+                const size_t memory_budget = 0, // MB, for the approximate state storages
+                const uint32_t threads = 1);
         void print_buchi(std::ostream& out, const BuchiOutType type = BuchiOutType::Dot);
         void print_stats(std::ostream& out);
 
@@ -78,6 +81,14 @@ namespace LTL {
             return _checker->max_tokens();
         }
 
+        bool is_approximate() const {
+            return _checker->is_approximate();
+        }
+
+        double omission_probability() const {
+            return _checker->omission_probability();
+        }
+
         size_t configurations() const {
             return _checker->get_configurations();
         }
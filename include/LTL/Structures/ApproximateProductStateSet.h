@@ -0,0 +1,210 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_APPROXIMATEPRODUCTSTATESET_H
+#define VERIFYPN_APPROXIMATEPRODUCTSTATESET_H
+
+#include "PetriEngine/Structures/ApproximateStateSet.h"
+#include "LTL/Structures/BitProductStateSet.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace LTL { namespace Structures {
+
+    /**
+     * Product state set for Tarjan's algorithm where completed states are only
+     * remembered by a fingerprint.
+     *
+     * States on the Tarjan stack are stored exactly, their markings are shared
+     * between Büchi states as in BitProductStateSet and ids use the same layout.
+     * When a state is released (its SCC is completed) it is moved to a
+     * FingerprintTable and its marking is freed once no live state uses it,
+     * after which the id may be reused. A fingerprint collision can only make
+     * a new state look completed, so states may be omitted but no spurious
+     * cycles are reported.
+     *
+     * Adding a state that is completed still yields a decodable id; the most
+     * recently added or released state stays decodable until the next call,
+     * which is what Tarjan needs to resume the successor generation of the
+     * top of the search stack.
+     */
+    template<uint8_t nbits = 20>
+    class ApproximateProductStateSet {
+    public:
+        ApproximateProductStateSet(const PetriEngine::PetriNet& net, uint32_t kbound,
+                                   StateStorage storage, size_t bytes)
+        : _net(net), _kbound(kbound), _encoder(net.numberOfPlaces(), kbound), _completed(storage, bytes)
+        {
+        }
+
+        static_assert(nbits <= 32, "Only up to 2^32 Büchi states supported");
+
+        static size_t get_buchi_state(stateid_t id) { return id & BUCHI_MASK; }
+
+        static size_t get_marking_id(stateid_t id) { return id >> MARKING_SHIFT; }
+
+        static stateid_t get_product_id(size_t markingId, size_t buchiState)
+        {
+            return (buchiState & BUCHI_MASK) | (markingId << MARKING_SHIFT);
+        }
+
+        /**
+         * Insert a product state into the state set.
+         * @return tripple of [is_new, ID, 0]; is_new is false both for states
+         *         on the stack and for completed states.
+         */
+        result_t add(const LTL::Structures::ProductState &state)
+        {
+            ++_discovered;
+            constexpr auto err = std::numeric_limits<size_t>::max();
+            uint64_t sum;
+            bool allsame;
+            uint32_t val, active, last;
+            AlignedEncoder::markingStats(state.marking(), _net.numberOfPlaces(), sum, allsame, val, active, last);
+            _max_tokens = std::max<size_t>(_max_tokens, sum);
+            if (_kbound != 0 && sum > _kbound)
+                return {false, err, err};
+
+            auto type = _encoder.getType(sum, active, allsame, val);
+            auto length = _encoder.encode(state.marking(), type);
+            std::string encoding(reinterpret_cast<const char*>(_encoder.scratchpad().const_raw()), length);
+
+            auto mit = _live_markings.find(encoding);
+            size_t marking = mit == _live_markings.end() ? err : mit->second;
+            if (marking != err) {
+                auto id = get_product_id(marking, state.get_buchi_state());
+                if (_live.count(id) > 0) {
+                    pin(id);
+                    return {false, id, 0};
+                }
+            }
+
+            bool completed = _completed.exists(product_hash(encoding, state.get_buchi_state()));
+            if (marking == err)
+                marking = acquire(std::move(encoding));
+            auto id = get_product_id(marking, state.get_buchi_state());
+            pin(id);
+            if (completed)
+                return {false, id, 0};
+            _live.insert(id);
+            ++_slots[marking]._refs;
+            ++_configurations;
+            return {true, id, 0};
+        }
+
+        void decode(LTL::Structures::ProductState &state, stateid_t id)
+        {
+            auto& slot = _slots[get_marking_id(id)];
+            assert(slot._refs > 0);
+            _encoder.decode(state.marking(), reinterpret_cast<const unsigned char*>(slot._encoding.data()));
+            state.set_buchi_state(get_buchi_state(id));
+        }
+
+        /**
+         * Marks a state on the stack as completed. The state stays decodable
+         * until the next call to add() or release().
+         */
+        void release(stateid_t id)
+        {
+            auto marking = get_marking_id(id);
+            assert(_live.count(id) > 0);
+            _completed.insert(product_hash(_slots[marking]._encoding, get_buchi_state(id)));
+            _live.erase(id);
+            pin(id);
+            unref(marking);
+        }
+
+        size_t discovered() const { return _discovered; }
+
+        size_t max_tokens() const { return _max_tokens; }
+
+        // markings are not stored once completed, so only product states are counted
+        size_t markings() const { return _configurations; }
+
+        size_t configurations() const { return _configurations; }
+
+        const PetriEngine::Structures::FingerprintTable& table() const { return _completed; }
+
+    private:
+        static constexpr auto BUCHI_MASK = ~(std::numeric_limits<size_t>::max() << (nbits));
+        static constexpr auto MARKING_SHIFT = nbits;
+
+        struct slot_t {
+            std::string _encoding;
+            size_t _refs = 0;
+        };
+
+        static uint64_t product_hash(const std::string& encoding, size_t buchi_state)
+        {
+            auto h = PetriEngine::Structures::FingerprintTable::hash(
+                reinterpret_cast<const unsigned char*>(encoding.data()), encoding.size());
+            return h ^ ((buchi_state + 1) * 0x9e3779b97f4a7c15ULL);
+        }
+
+        size_t acquire(std::string&& encoding)
+        {
+            size_t marking;
+            if (_free.empty()) {
+                marking = _slots.size();
+                _slots.emplace_back();
+            } else {
+                marking = _free.back();
+                _free.pop_back();
+            }
+            _live_markings.emplace(encoding, marking);
+            _slots[marking]._encoding = std::move(encoding);
+            return marking;
+        }
+
+        void unref(size_t marking)
+        {
+            auto& slot = _slots[marking];
+            assert(slot._refs > 0);
+            if (--slot._refs > 0)
+                return;
+            _live_markings.erase(slot._encoding);
+            std::string().swap(slot._encoding);
+            _free.push_back(marking);
+        }
+
+        // keep the marking of id alive until the next pin
+        void pin(stateid_t id)
+        {
+            auto marking = get_marking_id(id);
+            ++_slots[marking]._refs;
+            if (_pinned != std::numeric_limits<size_t>::max())
+                unref(_pinned);
+            _pinned = marking;
+        }
+
+        const PetriEngine::PetriNet& _net;
+        uint32_t _kbound;
+        AlignedEncoder _encoder;
+        PetriEngine::Structures::FingerprintTable _completed;
+        std::unordered_map<std::string, size_t> _live_markings;
+        std::unordered_set<stateid_t> _live;
+        std::vector<slot_t> _slots;
+        std::vector<size_t> _free;
+        size_t _pinned = std::numeric_limits<size_t>::max();
+
+        size_t _discovered = 0;
+        size_t _configurations = 0;
+        size_t _max_tokens = 0;
+    };
+} }
+
+#endif //VERIFYPN_APPROXIMATEPRODUCTSTATESET_H
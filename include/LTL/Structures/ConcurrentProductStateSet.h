@@ -0,0 +1,130 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_CONCURRENTPRODUCTSTATESET_H
+#define VERIFYPN_CONCURRENTPRODUCTSTATESET_H
+
+#include "PetriEngine/Structures/ConcurrentStateSet.h"
+#include "LTL/Structures/ProductState.h"
+#include "LTL/Structures/BitProductStateSet.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace LTL { namespace Structures {
+
+    /**
+     * Product state set shared between the workers of a parallel LTL search.
+     * Markings are kept in a ConcurrentStateSet and product ids are composed as
+     * in BitProductStateSet. Every product state carries a shared red flag,
+     * kept in independently locked shards.
+     * All operations taking a worker index may be called concurrently as long
+     * as each worker uses its own index.
+     */
+    template<uint8_t nbits = 20>
+    class ConcurrentProductStateSet {
+    private:
+        struct alignas(64) shard_t {
+            std::mutex _lock;
+            // product id -> red
+            std::unordered_map<stateid_t, bool> _states;
+        };
+
+    public:
+        ConcurrentProductStateSet(const PetriEngine::PetriNet& net, uint32_t kbound, size_t workers)
+        : _markings(net, kbound, workers, false),
+          _nshards(_markings.shards() * 4), _shards(std::make_unique<shard_t[]>(_nshards))
+        {
+        }
+
+        static size_t get_buchi_state(stateid_t id) { return id & BUCHI_MASK; }
+
+        static size_t get_marking_id(stateid_t id) { return id >> nbits; }
+
+        static stateid_t get_product_id(size_t markingId, size_t buchiState)
+        {
+            return (buchiState & BUCHI_MASK) | (markingId << nbits);
+        }
+
+        /**
+         * Insert a product state into the state set.
+         * @return pair of [is_new, ID], where ID is the max value if the
+         *         marking exceeds the k-bound.
+         */
+        std::pair<bool, stateid_t> add(const ProductState& state, size_t worker)
+        {
+            const auto res = _markings.add(state, worker);
+            if (res.second == std::numeric_limits<size_t>::max())
+                return res;
+            const stateid_t id = get_product_id(res.second, state.get_buchi_state());
+            auto& shard = shard_of(id);
+            std::lock_guard<std::mutex> guard(shard._lock);
+            bool is_new = shard._states.emplace(id, false).second;
+            if (is_new)
+                _configurations.fetch_add(1, std::memory_order_relaxed);
+            return std::make_pair(is_new, id);
+        }
+
+        void decode(ProductState& state, stateid_t id, size_t worker)
+        {
+            _markings.decode(state, get_marking_id(id), worker);
+            state.set_buchi_state(get_buchi_state(id));
+        }
+
+        bool is_red(stateid_t id)
+        {
+            auto& shard = shard_of(id);
+            std::lock_guard<std::mutex> guard(shard._lock);
+            auto it = shard._states.find(id);
+            return it != shard._states.end() && it->second;
+        }
+
+        void set_red(stateid_t id)
+        {
+            auto& shard = shard_of(id);
+            std::lock_guard<std::mutex> guard(shard._lock);
+            shard._states[id] = true;
+        }
+
+        // must not be called while workers are adding states
+        void sync_statistics() { _markings.syncStatistics(); }
+
+        size_t discovered() const { return _markings.discovered(); }
+
+        size_t max_tokens() const { return _markings.maxTokens(); }
+
+        size_t markings() const { return _markings.size(); }
+
+        size_t configurations() const { return _configurations.load(); }
+
+    private:
+        static constexpr auto BUCHI_MASK = ~(std::numeric_limits<size_t>::max() << (nbits));
+
+        shard_t& shard_of(stateid_t id)
+        {
+            // the low bits hold the Büchi state, so mix before picking a shard
+            return _shards[((id * 0x9E3779B97F4A7C15ULL) >> 32) % _nshards];
+        }
+
+        PetriEngine::Structures::ConcurrentStateSet _markings;
+        size_t _nshards;
+        std::unique_ptr<shard_t[]> _shards;
+        std::atomic<size_t> _configurations{0};
+    };
+} }
+
+#endif //VERIFYPN_CONCURRENTPRODUCTSTATESET_H
@@ -0,0 +1,249 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_FLATBUCHIAUTOMATON_H
+#define VERIFYPN_FLATBUCHIAUTOMATON_H
+
+#include "LTL/Structures/BuchiAutomaton.h"
+#include "PetriEngine/PQL/Evaluation.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace LTL { namespace Structures {
+
+    /**
+     * Immutable copy of a Büchi automaton in plain arrays, with the edge guards
+     * compiled from their BDDs. A guard over at most MAX_TABLE_APS atomic
+     * propositions becomes a truth table indexed by the values of its
+     * propositions, larger guards become decision diagrams. The propositions
+     * are evaluated at most once per marking through a valuation_t.
+     * Spot and BuDDy keep shared reference counts and iterator caches, so a
+     * BuchiAutomaton may only be used by one thread at a time; this copy may be
+     * read by any number of threads once constructed.
+     */
+    class FlatBuchiAutomaton {
+    public:
+        // constant guards, all other values index _guards
+        static constexpr uint32_t FALSE_GUARD = std::numeric_limits<uint32_t>::max() - 1;
+        static constexpr uint32_t TRUE_GUARD = std::numeric_limits<uint32_t>::max();
+        // a table of 2^12 bits takes 512 bytes
+        static constexpr uint32_t MAX_TABLE_APS = 12;
+
+        struct edge_t {
+            uint32_t _dst;
+            uint32_t _guard;
+        };
+
+        /**
+         * Values of the atomic propositions in one marking, evaluated on demand.
+         * Must be reset whenever the marking changes.
+         */
+        class valuation_t {
+        public:
+            valuation_t(const PetriEngine::PetriNet& net, const FlatBuchiAutomaton& aut)
+            : _net(&net), _known((aut.num_aps() + 63) / 64, 0), _value(_known.size(), 0) {}
+
+            void reset(const PetriEngine::MarkVal* marking)
+            {
+                _ctx = PetriEngine::PQL::EvaluationContext{marking, _net};
+                std::fill(_known.begin(), _known.end(), 0);
+            }
+
+        private:
+            friend class FlatBuchiAutomaton;
+            const PetriEngine::PetriNet* _net;
+            PetriEngine::PQL::EvaluationContext _ctx;
+            std::vector<uint64_t> _known;
+            std::vector<uint64_t> _value;
+        };
+
+        explicit FlatBuchiAutomaton(const BuchiAutomaton& aut)
+        : _initial(aut.buchi().get_init_state_number())
+        {
+            std::unordered_map<int, uint32_t> ap_index;
+            for (auto& [var, ap] : aut.ap_info()) {
+                ap_index.emplace(var, _aps.size());
+                _aps.push_back(ap._expression);
+            }
+            const auto& buchi = aut.buchi();
+            std::unordered_map<int, uint32_t> nodes;
+            std::unordered_map<int, uint32_t> guards;
+            _offsets.push_back(0);
+            for (uint32_t state = 0; state < buchi.num_states(); ++state) {
+                bool self_loop = false;
+                for (auto& e : buchi.out(state)) {
+                    _edges.push_back(edge_t{e.dst, compile_guard(e.cond, ap_index, nodes, guards)});
+                    self_loop |= e.dst == state && e.cond == bddtrue;
+                }
+                _offsets.push_back(_edges.size());
+                _accepting.push_back(buchi.state_is_accepting(state));
+                _self_loop.push_back(self_loop);
+            }
+        }
+
+        uint32_t initial_state() const { return _initial; }
+
+        size_t num_states() const { return _accepting.size(); }
+
+        size_t num_aps() const { return _aps.size(); }
+
+        bool is_accepting(uint32_t state) const { return _accepting[state]; }
+
+        bool has_invariant_self_loop(uint32_t state) const { return _self_loop[state]; }
+
+        const edge_t* begin(uint32_t state) const { return _edges.data() + _offsets[state]; }
+
+        const edge_t* end(uint32_t state) const { return _edges.data() + _offsets[state + 1]; }
+
+        bool guard_valid(valuation_t& valuation, uint32_t guard) const
+        {
+            if (guard >= FALSE_GUARD)
+                return guard == TRUE_GUARD;
+            const auto& g = _guards[guard];
+            if (g._table != NO_TABLE) {
+                size_t index = 0;
+                for (uint32_t i = 0; i < g._nsupport; ++i)
+                    if (value(valuation, _support[g._support + i]))
+                        index |= size_t{1} << i;
+                return (_tables[g._table + index / 64] >> (index % 64)) & 1;
+            }
+            auto node = g._root;
+            while (node < FALSE_GUARD) {
+                const auto& n = _nodes[node];
+                node = value(valuation, n._ap) ? n._high : n._low;
+            }
+            return node == TRUE_GUARD;
+        }
+
+    private:
+        static constexpr uint32_t NO_TABLE = std::numeric_limits<uint32_t>::max();
+
+        struct node_t {
+            uint32_t _ap;
+            uint32_t _low;
+            uint32_t _high;
+        };
+
+        struct guard_t {
+            uint32_t _root;
+            // the propositions of the guard are _support[_support, _support + _nsupport)
+            uint32_t _support;
+            uint32_t _nsupport;
+            // offset of the truth table in _tables, bit i is the value under assignment i
+            uint32_t _table;
+        };
+
+        bool value(valuation_t& valuation, uint32_t ap) const
+        {
+            const uint64_t bit = uint64_t{1} << (ap % 64);
+            auto& known = valuation._known[ap / 64];
+            auto& value = valuation._value[ap / 64];
+            if ((known & bit) == 0) {
+                known |= bit;
+                using PetriEngine::PQL::Condition;
+                switch (PetriEngine::PQL::evaluate(_aps[ap].get(), valuation._ctx)) {
+                    case Condition::RTRUE:
+                        value |= bit;
+                        break;
+                    case Condition::RFALSE:
+                        value &= ~bit;
+                        break;
+                    default:
+                        throw base_error("Unexpected unknown answer from evaluating query!");
+                }
+            }
+            return (value & bit) != 0;
+        }
+
+        uint32_t compile_node(const bdd& b, const std::unordered_map<int, uint32_t>& ap_index,
+                              std::unordered_map<int, uint32_t>& compiled)
+        {
+            if (b == bddtrue) return TRUE_GUARD;
+            if (b == bddfalse) return FALSE_GUARD;
+            auto it = compiled.find(b.id());
+            if (it != compiled.end())
+                return it->second;
+            auto low = compile_node(bdd_low(b), ap_index, compiled);
+            auto high = compile_node(bdd_high(b), ap_index, compiled);
+            uint32_t id = _nodes.size();
+            _nodes.push_back(node_t{ap_index.at(bdd_var(b)), low, high});
+            compiled.emplace(b.id(), id);
+            return id;
+        }
+
+        uint32_t compile_guard(const bdd& b, const std::unordered_map<int, uint32_t>& ap_index,
+                               std::unordered_map<int, uint32_t>& nodes, std::unordered_map<int, uint32_t>& compiled)
+        {
+            if (b == bddtrue) return TRUE_GUARD;
+            if (b == bddfalse) return FALSE_GUARD;
+            auto it = compiled.find(b.id());
+            if (it != compiled.end())
+                return it->second;
+
+            guard_t g{compile_node(b, ap_index, nodes), static_cast<uint32_t>(_support.size()), 0, NO_TABLE};
+            std::vector<uint32_t> support;
+            std::vector<uint32_t> waiting{g._root};
+            std::vector<bool> seen(_nodes.size(), false);
+            while (!waiting.empty()) {
+                auto n = waiting.back();
+                waiting.pop_back();
+                if (n >= FALSE_GUARD || seen[n]) continue;
+                seen[n] = true;
+                support.push_back(_nodes[n]._ap);
+                waiting.push_back(_nodes[n]._low);
+                waiting.push_back(_nodes[n]._high);
+            }
+            std::sort(support.begin(), support.end());
+            support.erase(std::unique(support.begin(), support.end()), support.end());
+            g._nsupport = support.size();
+            _support.insert(_support.end(), support.begin(), support.end());
+
+            if (g._nsupport <= MAX_TABLE_APS) {
+                g._table = _tables.size();
+                const size_t rows = size_t{1} << g._nsupport;
+                _tables.resize(_tables.size() + (rows + 63) / 64, 0);
+                for (size_t row = 0; row < rows; ++row) {
+                    auto node = g._root;
+                    while (node < FALSE_GUARD) {
+                        auto pos = std::lower_bound(support.begin(), support.end(), _nodes[node]._ap) - support.begin();
+                        node = (row >> pos) & 1 ? _nodes[node]._high : _nodes[node]._low;
+                    }
+                    if (node == TRUE_GUARD)
+                        _tables[g._table + row / 64] |= uint64_t{1} << (row % 64);
+                }
+            }
+            uint32_t id = _guards.size();
+            _guards.push_back(g);
+            compiled.emplace(b.id(), id);
+            return id;
+        }
+
+        uint32_t _initial;
+        std::vector<PetriEngine::PQL::Condition_ptr> _aps;
+        std::vector<uint32_t> _offsets;
+        std::vector<edge_t> _edges;
+        std::vector<node_t> _nodes;
+        std::vector<guard_t> _guards;
+        std::vector<uint32_t> _support;
+        std::vector<uint64_t> _tables;
+        std::vector<bool> _accepting;
+        std::vector<bool> _self_loop;
+    };
+} }
+
+#endif //VERIFYPN_FLATBUCHIAUTOMATON_H
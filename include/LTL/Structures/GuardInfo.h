@@ -20,6 +20,7 @@
 
 #include "PetriEngine/PQL/PQL.h"
 #include "LTL/Structures/BuchiAutomaton.h"
+#include "LTL/Structures/FlatBuchiAutomaton.h"
 #include "LTL/Simplification/SpotToPQL.h"
 
 #include <vector>
@@ -35,6 +36,8 @@ namespace LTL {
             PetriEngine::PQL::Condition_ptr _condition;
             bdd _bdd;
             uint32_t _dest;
+            // the compiled guard, only set if from_automaton was given the flat automaton
+            uint32_t _guard = Structures::FlatBuchiAutomaton::FALSE_GUARD;
 
             explicit operator bool () {
                 return _condition != nullptr;
@@ -49,7 +52,8 @@ namespace LTL {
         bool _is_accepting;
 
 
-        static std::vector<guard_info_t> from_automaton(const Structures::BuchiAutomaton &aut) {
+        static std::vector<guard_info_t> from_automaton(const Structures::BuchiAutomaton &aut,
+                                                        const Structures::FlatBuchiAutomaton* flat = nullptr) {
             std::vector<guard_info_t> state_guards;
             std::vector<AtomicProposition> aps;
             aps.reserve(aut.ap_info().size());
@@ -57,12 +61,17 @@ namespace LTL {
                 aps.emplace_back(ap);
             for (decltype(aut.buchi().num_states()) state = 0; state < aut.buchi().num_states(); ++state) {
                 state_guards.emplace_back(state, aut.buchi().state_is_accepting(state));
+                // the flat automaton lists the edges of a state in the same order
+                auto flat_edge = flat ? flat->begin(state) : nullptr;
                 for (auto &e : aut.buchi().out(state)) {
                     auto formula = spot::bdd_to_formula(e.cond, aut.buchi().get_dict());
+                    guard_t guard{toPQL(formula, aps), e.cond, e.dst};
+                    if (flat)
+                        guard._guard = (flat_edge++)->_guard;
                     if (e.dst == state) {
-                        state_guards.back()._retarding = guard_t{toPQL(formula, aps), e.cond, state};
+                        state_guards.back()._retarding = std::move(guard);
                     } else {
-                        state_guards.back()._progressing.push_back(guard_t{toPQL(formula, aps), e.cond, e.dst});
+                        state_guards.back()._progressing.push_back(std::move(guard));
                     }
                 }
                 if (!state_guards.back()._retarding) {
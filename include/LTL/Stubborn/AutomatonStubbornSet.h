@@ -31,7 +31,8 @@ namespace LTL {
     public:
         explicit AutomatonStubbornSet(const PetriEngine::PetriNet &net, const Structures::BuchiAutomaton &aut)
         : PetriEngine::StubbornSet(net), _retarding_stubborn_set(net,false),
-            _state_guards(std::move(guard_info_t::from_automaton(aut))),
+            _flat(aut), _valuation(net, _flat),
+            _state_guards(std::move(guard_info_t::from_automaton(aut, &_flat))),
             _aut(aut),
             _place_checkpoint(new bool[net.numberOfPlaces()]),
             _gen(_net)
@@ -65,6 +66,8 @@ namespace LTL {
     private:
 
         PetriEngine::ReachabilityStubbornSet _retarding_stubborn_set;
+        const Structures::FlatBuchiAutomaton _flat;
+        Structures::FlatBuchiAutomaton::valuation_t _valuation;
         const std::vector<guard_info_t> _state_guards;
         const Structures::BuchiAutomaton &_aut;
         std::unique_ptr<bool[]> _place_checkpoint;
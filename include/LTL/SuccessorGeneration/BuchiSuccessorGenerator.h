@@ -20,6 +20,7 @@
 
 #include "PetriEngine/SuccessorGenerator.h"
 #include "LTL/Structures/BuchiAutomaton.h"
+#include "LTL/Structures/FlatBuchiAutomaton.h"
 #include "LTL/LTLOptions.h"
 
 #include <spot/twa/twagraph.hh>
@@ -34,81 +35,63 @@ namespace LTL {
     class BuchiSuccessorGenerator {
     public:
         explicit BuchiSuccessorGenerator(Structures::BuchiAutomaton automaton)
-                : _aut(std::move(automaton)), _self_loops(_aut.buchi().num_states(), InvariantSelfLoop::UNKNOWN)
+                : _aut(std::move(automaton)), _flat(_aut)
         {
-            _deleter = SuccIterDeleter{&_aut};
         }
 
         void prepare(size_t state)
         {
-            auto curstate = _aut.buchi().state_from_number(state);
-            _succ = _succ_iter{_aut.buchi().succ_iter(curstate), SuccIterDeleter{&_aut}};
-            _succ->first();
+            _succ = _flat.begin(state);
+            _end = _flat.end(state);
         }
 
-        bool next(size_t &state, bdd &cond)
+        /**
+         * @param[out] state the destination of the next edge
+         * @param[out] guard the guard of the next edge, to be checked with guard_valid
+         */
+        bool next(size_t &state, uint32_t &guard)
         {
-            if (!_succ->done()) {
-                auto dst = _succ->dst();
-                state = _aut.buchi().state_number(dst);
-                cond = _succ->cond();
-                _succ->next();
-                dst->destroy();
+            if (_succ != _end) {
+                state = _succ->_dst;
+                guard = _succ->_guard;
+                ++_succ;
                 return true;
             }
             return false;
         }
 
+        bool guard_valid(Structures::FlatBuchiAutomaton::valuation_t& valuation, uint32_t guard) const
+        {
+            return _flat.guard_valid(valuation, guard);
+        }
+
         [[nodiscard]] bool is_accepting(size_t state) const
         {
-            return _aut.buchi().state_is_accepting(state);
+            return _flat.is_accepting(state);
         }
 
         [[nodiscard]] size_t initial_state_number() const
         {
-            return _aut.buchi().get_init_state_number();
+            return _flat.initial_state();
         }
 
-        bool has_invariant_self_loop(size_t state) {
-            if (_self_loops[state] != InvariantSelfLoop::UNKNOWN)
-                return _self_loops[state] == InvariantSelfLoop::TRUE;
-            auto it = std::unique_ptr<spot::twa_succ_iterator>{
-                    _aut.buchi().succ_iter(_aut.buchi().state_from_number(state))};
-            for (it->first(); !it->done(); it->next()) {
-                auto dest_id = _aut.buchi().state_number(it->dst());
-                bdd cond = it->cond();
-                if (state == dest_id && cond == bddtrue) {
-                    _self_loops[state] = InvariantSelfLoop::TRUE;
-                    return true;
-                }
-            }
-            _self_loops[state] = InvariantSelfLoop::FALSE;
-            return false;
+        bool has_invariant_self_loop(size_t state) const {
+            return _flat.has_invariant_self_loop(state);
         }
 
         const Structures::BuchiAutomaton& automaton() const {
             return _aut;
         }
 
+        const Structures::FlatBuchiAutomaton& flat_automaton() const {
+            return _flat;
+        }
 
     private:
-        struct SuccIterDeleter {
-            Structures::BuchiAutomaton *_aut;
-
-            void operator()(spot::twa_succ_iterator *iter) const
-            {
-                _aut->buchi().release_iter(iter);
-            }
-        };
-
-        enum class InvariantSelfLoop {
-            TRUE, FALSE, UNKNOWN
-        };
         Structures::BuchiAutomaton _aut;
-        std::vector<InvariantSelfLoop> _self_loops;
-        SuccIterDeleter _deleter{};
-        using _succ_iter = std::unique_ptr<spot::twa_succ_iterator, SuccIterDeleter>;
-        _succ_iter _succ = nullptr;
+        Structures::FlatBuchiAutomaton _flat;
+        const Structures::FlatBuchiAutomaton::edge_t* _succ = nullptr;
+        const Structures::FlatBuchiAutomaton::edge_t* _end = nullptr;
     };
 }
 #endif //VERIFYPN_BUCHISUCCESSORGENERATOR_H
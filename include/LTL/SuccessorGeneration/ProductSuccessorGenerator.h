@@ -46,7 +46,7 @@ namespace LTL {
                                   const Structures::BuchiAutomaton& buchi,
                                   SuccessorGen& successorGen)
                 : _successor_generator(successorGen), _net(net),
-                  _buchi_succ_gen(buchi)
+                  _buchi_succ_gen(buchi), _valuation(net, _buchi_succ_gen.flat_automaton())
         {
 
         }
@@ -55,6 +55,7 @@ namespace LTL {
         {
             if (_fresh_marking) {
                 _fresh_marking = false;
+                _valuation_stale = true;
                 if (!_successor_generator->next(state)) {
                     // This is a fresh marking, so if there is no more successors for the state the state is deadlocked.
                     // The semantics for deadlock is to just loop the marking so return true without changing the value of state.
@@ -69,6 +70,7 @@ namespace LTL {
                 // Try next marking(s) and see if we find a successor.
             else {
                 while (_successor_generator->next(state)) {
+                    _valuation_stale = true;
                     // reset buchi successors
                     _buchi_succ_gen.prepare(_buchi_parent);
                     if (next_buchi_succ(state)) {
@@ -98,6 +100,7 @@ namespace LTL {
             state.setMarking(buf);
             state.set_buchi_state(_buchi_succ_gen.initial_state_number());
             _buchi_succ_gen.prepare(state.get_buchi_state());
+            _valuation_stale = true;
             while (next_buchi_succ(state)) {
                 states.emplace_back(&_buchi_succ_gen.automaton());
                 states.back().setMarking(new PetriEngine::MarkVal[_successor_generator.state_size()]);
@@ -118,13 +121,15 @@ namespace LTL {
             _fresh_marking = sucinfo.fresh();
             _buchi_succ_gen.prepare(state->get_buchi_state());
             _buchi_parent = state->get_buchi_state();
+            // resumed iterations continue on the marking of the last successor
+            _valuation_stale = true;
             if (!_fresh_marking) {
                 assert(sucinfo._buchi_state != std::numeric_limits<size_t>::max());
                 // spool Büchi successors until last state found.
                 // TODO is there perhaps a good way to avoid this, perhaps using raw edge vector?
                 // Caveat: it seems like there usually are not that many successors, so this is probably cheap regardless
                 size_t tmp;
-                while (_buchi_succ_gen.next(tmp, _cond)) {
+                while (_buchi_succ_gen.next(tmp, _guard)) {
                     if (tmp == sucinfo._buchi_state) {
                         break;
                     }
@@ -143,6 +148,7 @@ namespace LTL {
         {
             if (_fresh_marking) {
                 _fresh_marking = false;
+                _valuation_stale = true;
                 if (!_successor_generator.next(state, sucinfo)) {
                     // This is a fresh marking, so if there are no more successors for the state the state is deadlocked.
                     // The semantics for deadlock is to just loop the marking so return true without changing the value of state.
@@ -160,6 +166,7 @@ namespace LTL {
                 // Try next marking(s) and see if we find a successor.
             else {
                 while (_successor_generator.next(state, sucinfo)) {
+                    _valuation_stale = true;
                     // reset buchi successors
                     _buchi_succ_gen.prepare(_buchi_parent);
                     if (next_buchi_succ(state)) {
@@ -195,10 +202,12 @@ namespace LTL {
         const PetriEngine::PetriNet& _net;
         BuchiSuccessorGenerator _buchi_succ_gen;
 
-        bdd _cond;
+        uint32_t _guard;
+        // values of the atomic propositions in the marking of the successor being generated
+        Structures::FlatBuchiAutomaton::valuation_t _valuation;
+        bool _valuation_stale = true;
         size_t _buchi_parent;
         bool _fresh_marking = true;
-        std::vector<guard_info_t> _stateToGuards;
         /**
          * Evaluate binary decision diagram (BDD) representation of transition guard in given state.
          */
@@ -214,9 +223,13 @@ namespace LTL {
 
         bool next_buchi_succ(LTL::Structures::ProductState &state)
         {
+            if (_valuation_stale) {
+                _valuation.reset(state.marking());
+                _valuation_stale = false;
+            }
             size_t tmp;
-            while (_buchi_succ_gen.next(tmp, _cond)) {
-                if (guard_valid(state, _cond)) {
+            while (_buchi_succ_gen.next(tmp, _guard)) {
+                if (_buchi_succ_gen.guard_valid(_valuation, _guard)) {
                     state.set_buchi_state(tmp);
                     return true;
                 }
@@ -27,6 +27,10 @@
 #include <utility>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <iostream>
 #include <cassert>
 
@@ -190,16 +194,37 @@ namespace PetriEngine {
             }
         };
 
+        /**
+         * The colors of a product type are identified by the mixed-radix number of
+         * the ids of their constituents, the first constituent being the least
+         * significant digit. Color objects are only created when a color is first
+         * accessed, and are found again through a two-level table indexed by that
+         * number: a directory of directories of pages, each allocated on first use.
+         * Products too large for the top directory use a hash map instead.
+         */
         class ProductType : public ColorType {
         private:
+            static constexpr size_t PAGE_BITS = 12;
+            static constexpr size_t PAGE_SIZE = size_t{1} << PAGE_BITS;
+            static constexpr size_t DIRECTORY_BITS = 12;
+            static constexpr size_t DIRECTORY_SIZE = size_t{1} << DIRECTORY_BITS;
+            static constexpr size_t MAX_DIRECTORIES = size_t{1} << 16;
+            typedef std::atomic<const Color*> slot_t;
+            typedef std::atomic<slot_t*> page_t;
+
             std::vector<const ColorType*> _constituents;
+            // directories of DIRECTORY_SIZE pages of PAGE_SIZE colors, filled on demand,
+            // possibly by several unfolding threads at once
+            mutable std::unique_ptr<std::atomic<page_t*>[]> _directories;
+            mutable size_t _ndirectories = 0;
+            mutable std::once_flag _directoriesAllocated;
+            // used instead of the directories when there would be more than MAX_DIRECTORIES
             mutable std::unordered_map<size_t,Color> _cache;
+            mutable std::shared_mutex _cacheLock;
 
         public:
             ProductType(const std::string& name = "Undefined") : ColorType(name) {}
-            ~ProductType() {
-                _cache.clear();
-            }
+            ~ProductType();
 
             void addType(const ColorType* type) {
                 _constituents.push_back(type);
@@ -6,6 +6,8 @@
 #include "ArcIntervals.h"
 #include "EquivalenceClass.h"
 
+#include <limits>
+
 namespace PetriEngine {
     namespace Colored {
         class EquivalenceVec{
@@ -45,7 +47,8 @@ namespace PetriEngine {
                     _diagonalTuplePositions.push_back(val);
                 }
 
-                void addColorToEqClassMap(const Color *color);
+                // maps every color of the type to its equivalence class
+                void assignColors(const ColorType *colorType);
 
                 void setDiagonalTuplePosition(uint32_t position, bool value){
                     _diagonalTuplePositions[position] = value;
@@ -55,13 +58,20 @@ namespace PetriEngine {
                     _diagonalTuplePositions = diagonalPositions;
                 }
 
-                const std::unordered_map<const Colored::Color *, EquivalenceClass *> &getColorEqClassMap() const{
-                    return _colorEQClassMap;
+                // the equivalence class of a color id, nullptr if it has none
+                const EquivalenceClass* getEquivalenceClass(uint32_t colorId) const{
+                    if(colorId >= _colorEqClass.size() || _colorEqClass[colorId] == NO_CLASS){
+                        return nullptr;
+                    }
+                    return &_equivalenceClasses[_colorEqClass[colorId]];
                 }
 
             private:
+                static constexpr uint32_t NO_CLASS = std::numeric_limits<uint32_t>::max();
+
                 std::vector<EquivalenceClass> _equivalenceClasses;
-                std::unordered_map<const Colored::Color *, EquivalenceClass *> _colorEQClassMap;
+                // index in _equivalenceClasses of each color id
+                std::vector<uint32_t> _colorEqClass;
                 std::vector<bool> _diagonalTuplePositions;
                 bool _diagonal = false;
         };
@@ -56,12 +56,21 @@ namespace PetriEngine {
             std::vector<uint32_t> _placeFixpointQueue;
             std::vector<Colored::ColorFixpoint> _placeColorFixpoints;
             const PartitionBuilder& _partition;
+            // the intervals a transition adds to each of its output places, in the order of its output arcs
+            using OutputIntervals = std::vector<std::pair<uint32_t, std::vector<interval_vector_t>>>;
+
             std::unordered_map<uint32_t, Colored::ArcIntervals> setupTransitionVars(size_t tid) const;
-            void processInputArcs(const Colored::Transition& transition, uint32_t currentPlaceId, uint32_t transitionId, bool &transitionActivated, uint32_t max_intervals);
+            void propagate(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout);
+            void propagateParallel(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout, uint32_t threads);
+            void processInputArcs(const Colored::Transition& transition, uint32_t transitionId, bool &transitionActivated);
             void processOutputArcs(const Colored::Transition& transition, size_t transition_id);
+            // only touches the variable maps of the transition, so may run concurrently for distinct transitions
+            bool computeOutputIntervals(const Colored::Transition& transition, size_t transition_id, OutputIntervals& output);
+            void addOutputIntervals(OutputIntervals& output);
             void removeInvalidVarmaps(size_t tid);
             void addTransitionVars(size_t tid);
-            void getArcIntervals(const Colored::Transition& transition, bool &transitionActivated, uint32_t max_intervals, uint32_t transitionId);
+            void restrictInputPlaces(const Colored::Transition& transition, uint32_t max_intervals);
+            void getArcIntervals(const Colored::Transition& transition, bool &transitionActivated, uint32_t transitionId);
             void add_place(const Colored::Place& place);
             void init();
         public:
@@ -70,7 +79,12 @@ namespace PetriEngine {
             }
 
             void printPlaceTable() const;
-            void compute(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout);
+            /**
+             * Computes the color fixed point. With more than one thread, the transitions
+             * enabled by the places in the queue are evaluated in rounds, in parallel,
+             * and their output is added to the places in transition order.
+             */
+            void compute(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout, uint32_t threads = 1);
 
             double time() const {
                 return _fixPointCreationTime;
@@ -80,6 +80,10 @@ namespace PetriEngine {
             std::string toString() const;
 
         private:
+            // the multiplicity of a color id, the arithmetic works on ids so no colors are created
+            uint32_t count(uint32_t id) const;
+            uint32_t& count(uint32_t id);
+
             Internal _set;
             const ColorType* _type;
         };
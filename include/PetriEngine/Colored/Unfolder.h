@@ -33,47 +33,102 @@
 #include "SymmetryVisitor.h"
 #include "ForwardFixedPoint.h"
 #include "PetriEngine/PetriNetBuilder.h"
+#include "PetriEngine/StreamingPnmlBuilder.h"
 #include "VariableSymmetry.h"
 
+#include <algorithm>
+
 
 namespace PetriEngine {
     class ColoredPetriNetBuilder;
     namespace Colored {
         class Unfolder {
         private:
+            // an unfolded arc, the place is created when the arc is added to the PetriNetBuilder
+            struct unfolded_arc_t {
+                // nullptr for the arc to the sum place of an inhibited place
+                const Colored::Color* _color;
+                uint32_t _place;
+                uint32_t _id;
+                uint32_t _weight;
+                bool _input;
+            };
+
+            struct unfolded_binding_t {
+                shared_const_string _name;
+                // only kept when printing bindings
+                Colored::BindingMap _binding;
+                size_t _arcs_end;
+            };
+
+            /**
+             * The unfolding of one colored transition. Computing it only reads the
+             * colored net, so fragments may be computed concurrently; they are added
+             * to the PetriNetBuilder in transition order, which keeps the unfolded
+             * net identical to a sequential unfolding.
+             */
+            struct fragment_t {
+                std::vector<unfolded_binding_t> _bindings;
+                std::vector<unfolded_arc_t> _arcs;
+            };
+
             const ColoredPetriNetBuilder& _builder;
             void getArcIntervals(const Colored::Transition& transition, bool &transitionActivated, uint32_t max_intervals, uint32_t transitionId);
 
-            void unfoldPlace(PetriNetBuilder& ptBuilder, const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t unfoldPlace, uint32_t id);
-            void unfoldTransition(PetriNetBuilder& builder, uint32_t transitionId);
-            void handleOrphanPlace(PetriNetBuilder& ptBuilder, const Colored::Place& place, const shared_name_index_map& unfoldedPlaceMap);
+            // the builder is either a PetriNetBuilder or a StreamingPnmlBuilder
+            template<typename Builder>
+            void unfoldNet(Builder& ptBuilder);
+            template<typename Builder>
+            void unfoldPlace(Builder& ptBuilder, const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t unfoldPlace, uint32_t id);
+            template<typename Builder>
+            void unfoldTransitions(Builder& ptBuilder);
+            template<typename Builder>
+            void unfoldTransitionsParallel(Builder& ptBuilder);
+            void unfoldTransition(fragment_t& fragment, uint32_t transitionId) const;
+            template<typename Builder>
+            void addTransition(Builder& ptBuilder, uint32_t transitionId, const fragment_t& fragment);
+            template<typename Builder>
+            void handleOrphanPlace(Builder& ptBuilder, const Colored::Place& place, uint32_t placeId);
             void createPartionVarmaps();
-            void unfoldInhibitorArc(PetriNetBuilder& ptBuilder, const shared_const_string &oldname, const shared_const_string &newname);
+            template<typename Builder>
+            void unfoldInhibitorArc(Builder& ptBuilder, const shared_const_string &oldname, const shared_const_string &newname);
             std::string arc_to_string(const Colored::Arc& arc) const;
-            void unfoldArc(PetriNetBuilder& ptBuilder, const Colored::Arc& arc, const Colored::BindingMap& binding, const shared_const_string& name);
+            void unfoldArc(fragment_t& fragment, const Colored::Arc& arc, const Colored::BindingMap& binding) const;
+            template<typename Builder>
+            void addArc(Builder& ptBuilder, const unfolded_arc_t& arc, const shared_const_string& tName);
             double _time = 0;
             shared_place_color_map _ptplacenames;
             shared_name_name_map _pttransitionnames;
             uint32_t _nptarcs = 0;
             std::vector<shared_const_string> _sumPlacesNames;
+            // tokens in the unfolded places of each colored place
+            std::vector<size_t> _unfoldedTokens;
             const VariableSymmetry& _symmetry;
             const PartitionBuilder& _partition;
             const ForwardFixedPoint& _fixed_point;
             
             bool _print_bindings;
+            uint32_t _threads;
             std::unordered_map<std::string, Colored::BindingMap> _transitionBinding;
             void storeBinding(const shared_const_string& name, const Colored::BindingMap& binding);
             
         public:
-            Unfolder(const ColoredPetriNetBuilder& b, const PartitionBuilder& partition, const VariableSymmetry& symmetry, const ForwardFixedPoint& fixed_point, bool print_bindings)
+            Unfolder(const ColoredPetriNetBuilder& b, const PartitionBuilder& partition, const VariableSymmetry& symmetry, const ForwardFixedPoint& fixed_point, bool print_bindings, uint32_t threads = 1)
             : _builder(b),
               _symmetry(symmetry),
               _partition(partition),
               _fixed_point(fixed_point),
-              _print_bindings(print_bindings) {}
+              _print_bindings(print_bindings),
+              _threads(std::max<uint32_t>(threads, 1)) {}
 
             PetriNetBuilder unfold();
 
+            /**
+             * Unfold directly into a PNML stream, without keeping the unfolded net.
+             * Transition names are not recorded.
+             */
+            void unfold(StreamingPnmlBuilder& ptBuilder);
+
             size_t number_of_arcs() const { return _nptarcs; }
 
             const shared_place_color_map& place_names() const {
@@ -1,9 +1,14 @@
 #ifndef COLORED_SEARCH_TYPES_H
 #define COLORED_SEARCH_TYPES_H
 
+#include <optional>
 #include <queue>
 #include <random>
+#include <stack>
+#include <type_traits>
+#include <ptrie/ptrie_stable.h>
 #include "PetriEngine/ExplicitColored/Visitors/HeuristicVisitor.h"
+#include "PetriEngine/ExplicitColored/ColoredEncoder.h"
 
 namespace PetriEngine::ExplicitColored {
     template <typename T>
@@ -128,14 +133,21 @@ namespace PetriEngine::ExplicitColored {
         }
 
         void add(T state) {
-            const MarkingCount_t weight = _query->distance(state.marking, _negQuery);
+            const MarkingCount_t weight = distance(state);
+            add(std::move(state), weight);
+        }
 
+        void add(T state, const MarkingCount_t weight) {
             _queue.push(WeightedState<T> {
                 std::move(state),
                 weight
             });
         }
 
+        [[nodiscard]] MarkingCount_t distance(const T& state) const {
+            return _query->distance(state.marking, _negQuery);
+        }
+
         [[nodiscard]] bool empty() const {
             return _queue.empty();
         }
@@ -151,6 +163,105 @@ namespace PetriEngine::ExplicitColored {
         std::shared_ptr<ExplicitQueryProposition> _query;
         bool _negQuery;
     };
+    // Waiting-list entry of the compact mode; the cursor and id of the state are kept while the
+    // marking is dropped and decoded from the passed list again when the state is expanded.
+    // Without an encoding id (the encoding was truncated) the entry keeps its marking.
+    template <typename T>
+    struct CompactState : T {
+        CompactState(T state, const std::optional<size_t> encodingId) : T(std::move(state)), encodingId(encodingId) {}
+        std::optional<size_t> encodingId;
+    };
+
+    // Wraps one of the structures above such that at most one waiting state (the one being
+    // expanded) holds its marking. Requires the passed list to be a ptrie::set_stable.
+    template <template <typename> typename WaitingList>
+    struct Compact {
+        template <typename T>
+        class Structure {
+        public:
+            static constexpr bool compact = true;
+
+            template <typename... Args>
+            explicit Structure(Args&&... args)
+                : _waiting(std::forward<Args>(args)...), _buffer(std::numeric_limits<uint16_t>::max() + 1) {}
+
+            void attach(ptrie::set_stable<uint8_t>& passed, const ColoredEncoder& encoder) {
+                _passed = &passed;
+                _encoder = &encoder;
+            }
+
+            T& next() {
+                auto& top = _waiting.next();
+                if (&top != _decoded) {
+                    _strip();
+                    if (top.encodingId) {
+                        _passed->unpack(*top.encodingId, _buffer.data());
+                        top.marking = _encoder->decode(_buffer.data());
+                        _decoded = &top;
+                    }
+                }
+                return top;
+            }
+
+            void remove() {
+                if (&_waiting.next() == _decoded) {
+                    _decoded = nullptr;
+                }
+                _waiting.remove();
+            }
+
+            void add(T state, const std::optional<size_t> encodingId) {
+                CompactState<T> entry {std::move(state), encodingId};
+                if constexpr (_weighted) {
+                    // the weight needs the marking, and pushing may move the decoded state
+                    const auto weight = _waiting.distance(entry);
+                    _strip();
+                    if (entry.encodingId) {
+                        entry.marking = {};
+                    }
+                    _waiting.add(std::move(entry), weight);
+                } else {
+                    if (entry.encodingId) {
+                        entry.marking = {};
+                    }
+                    _waiting.add(std::move(entry));
+                }
+            }
+
+            [[nodiscard]] bool empty() const {
+                return _waiting.empty();
+            }
+
+            [[nodiscard]] uint32_t size() const {
+                return _waiting.size();
+            }
+
+            void shuffle() {
+                _waiting.shuffle();
+            }
+        private:
+            static constexpr bool _weighted = std::is_same_v<WaitingList<T>, BestFSStructure<T>>;
+
+            void _strip() {
+                if (_decoded != nullptr) {
+                    _decoded->marking = {};
+                    _decoded = nullptr;
+                }
+            }
+
+            WaitingList<CompactState<T>> _waiting;
+            ptrie::set_stable<uint8_t>* _passed = nullptr;
+            const ColoredEncoder* _encoder = nullptr;
+            std::vector<uint8_t> _buffer;
+            T* _decoded = nullptr;
+        };
+    };
+
+    template <typename W, typename = void>
+    struct IsCompactStructure : std::false_type {};
+
+    template <typename W>
+    struct IsCompactStructure<W, std::void_t<decltype(W::compact)>> : std::true_type {};
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef CONCURRENT_PASSED_SET_H
+#define CONCURRENT_PASSED_SET_H
+
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <ptrie/ptrie.h>
+
+namespace PetriEngine::ExplicitColored {
+    // Passed list shared by the workers of a parallel search, split into
+    // independently locked ptrie shards selected by a hash of the encoding.
+    class ConcurrentPassedSet {
+    public:
+        explicit ConcurrentPassedSet(const size_t workers) : _nshards(_shardCount(workers)),
+            _shards(std::make_unique<Shard[]>(_nshards)) {}
+
+        // Returns true if the encoding was not seen before
+        bool insert(const uint8_t* data, const size_t size) {
+            auto& shard = _shards[_shardOf(data, size)];
+            std::lock_guard guard(shard.lock);
+            return shard.passed.insert(data, size).first;
+        }
+
+        [[nodiscard]] bool exists(const uint8_t* data, const size_t size) const {
+            auto& shard = _shards[_shardOf(data, size)];
+            std::lock_guard guard(shard.lock);
+            return shard.passed.exists(data, size).first;
+        }
+    private:
+        struct alignas(64) Shard {
+            mutable std::mutex lock;
+            ptrie::set<uint8_t> passed;
+        };
+
+        static size_t _shardCount(const size_t workers) {
+            size_t n = 1;
+            while (n < workers * 4) n <<= 1;
+            return n;
+        }
+
+        [[nodiscard]] size_t _shardOf(const uint8_t* data, const size_t size) const {
+            return std::hash<std::string_view>{}(
+                std::string_view(reinterpret_cast<const char*>(data), size)) & (_nshards - 1);
+        }
+
+        size_t _nshards;
+        std::unique_ptr<Shard[]> _shards;
+    };
+}
+
+#endif
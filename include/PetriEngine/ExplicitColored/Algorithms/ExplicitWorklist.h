@@ -36,7 +36,9 @@ namespace PetriEngine::ExplicitColored {
             const std::unordered_map<std::string, uint32_t>& placeNameIndices,
             const std::unordered_map<std::string, Transition_t>& transitionNameIndices,
             size_t seed,
-            bool createTrace
+            bool createTrace,
+            uint32_t threads = 1,
+            bool compactWaiting = false
         );
 
         bool check(Strategy searchStrategy, ColoredSuccessorGeneratorOption coloredSuccessorGeneratorOption);
@@ -52,6 +54,8 @@ namespace PetriEngine::ExplicitColored {
         const size_t _seed;
         bool _fullStatespace = true;
         bool _createTrace;
+        uint32_t _threads;
+        bool _compactWaiting;
         StateMap _stateMap;
         SearchStatistics _searchStatistics;
         template <typename SuccessorGeneratorState>
@@ -69,6 +73,8 @@ namespace PetriEngine::ExplicitColored {
 
         template <template <typename> typename WaitingList, typename T>
         [[nodiscard]] bool _genericSearch(WaitingList<T> waiting);
+        template <template <typename> typename WaitingList, typename T, typename F>
+        [[nodiscard]] bool _parallelSearch(F makeWaiting);
         [[nodiscard]] bool _getResult(bool found, bool fullStatespace) const;
     };
 }
@@ -18,6 +18,14 @@ namespace PetriEngine::ExplicitColored {
                                               Structures::State& state, searchstate_t& ss,
                                               Structures::StateSetInterface* states) override;
 
+        // queries are evaluated for fireability by checkQueries, one marking at a time
+        bool evaluateBatch(std::vector<std::shared_ptr<PQL::Condition > >&,
+                           const std::vector<ResultPrinter::Result>&,
+                           const Structures::MarkingBatch&,
+                           std::vector<PQL::Condition::Result>&) override {
+            return false;
+        }
+
         std::pair<ResultPrinter::Result,bool> doCallback(
             std::shared_ptr<PQL::Condition>& query, size_t i,
             ResultPrinter::Result r,
@@ -115,6 +115,11 @@ namespace PetriEngine::ExplicitColored {
             return _fullStatespace;
         }
 
+        //Whether an encoding of the size returned by encode holds the whole marking
+        [[nodiscard]] static bool isComplete(const size_t size) {
+            return size < UINT16_MAX;
+        }
+
     private:
         scratchpad_t _scratchpad;
         const std::vector<ColoredPetriNetPlace>& _places;
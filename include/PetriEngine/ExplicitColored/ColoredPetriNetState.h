@@ -59,13 +59,11 @@ namespace PetriEngine::ExplicitColored {
 
     struct ColoredPetriNetStateEven {
         ColoredPetriNetStateEven(const ColoredPetriNetStateEven& oldState, const size_t& numberOfTransitions) : marking(
-            oldState.marking) {
-            _map = std::vector<Binding_t>(numberOfTransitions);
+            oldState.marking), _transitionCount(numberOfTransitions) {
         }
 
         ColoredPetriNetStateEven(ColoredPetriNetMarking marking, const size_t& numberOfTransitions) : marking(
-            std::move(marking)) {
-            _map = std::vector<Binding_t>(numberOfTransitions);
+            std::move(marking)), _transitionCount(numberOfTransitions) {
         }
 
         ColoredPetriNetStateEven(ColoredPetriNetStateEven&& state) = default;
@@ -79,6 +77,10 @@ namespace PetriEngine::ExplicitColored {
             if (done()) {
                 return {tid, bid};
             }
+            // the binding map is only allocated once the state is expanded, keeping waiting states small
+            if (_map.empty()) {
+                _map = std::vector<Binding_t>(_transitionCount);
+            }
             auto it = _map.begin() + _currentIndex;
             while (it != _map.end() && *it == std::numeric_limits<Binding_t>::max()) {
                 ++it;
@@ -130,6 +132,7 @@ namespace PetriEngine::ExplicitColored {
     private:
         bool _done = false;
         std::vector<Binding_t> _map;
+        size_t _transitionCount;
         uint32_t _currentIndex = 0;
         uint32_t _completedTransitions = 0;
     };
@@ -5,6 +5,7 @@
 #include "PossibleValues.h"
 #include "../ColoredPetriNet.h"
 #include "../ColoredPetriNetState.h"
+#include <atomic>
 #include <limits>
 #include <utils/MathExt.h>
 
@@ -25,6 +26,8 @@ namespace PetriEngine::ExplicitColored {
     class ColoredSuccessorGenerator {
     public:
         explicit ColoredSuccessorGenerator(const ColoredPetriNet& net);
+        // Generators of a parallel search draw state ids from a shared counter so ids stay unique
+        ColoredSuccessorGenerator(const ColoredPetriNet& net, std::atomic<size_t>& sharedIds);
         ~ColoredSuccessorGenerator() = default;
 
         std::pair<ColoredPetriNetStateFixed, TraceMapStep> next(ColoredPetriNetStateFixed& state) const {
@@ -57,6 +60,7 @@ namespace PetriEngine::ExplicitColored {
     private:
         mutable std::map<size_t, ConstraintData> _constraintData;
         mutable size_t _nextId = 1;
+        std::atomic<size_t>* _sharedIds = nullptr;
         const ColoredPetriNet& _net;
         std::map<size_t, ConstraintData>::iterator _calculateConstraintData(const ColoredPetriNetMarking& marking, size_t id, Transition_t transition, bool& noPossibleBinding) const;
         [[nodiscard]] bool _hasMinimalCardinality(const ColoredPetriNetMarking& marking, Transition_t tid) const;
@@ -79,7 +83,7 @@ namespace PetriEngine::ExplicitColored {
                 const auto nextBid = findNextValidBinding(state.marking, tid, bid, totalBindings, binding, state.id);
                 if (nextBid != std::numeric_limits<Binding_t>::max()) {
                     auto newState = ColoredPetriNetStateFixed(state.marking);
-                    newState.id = _nextId++;
+                    newState.id = _newId();
                     fire(newState.marking, tid, binding);
                     state.nextBinding(nextBid);
                     return std::make_pair(newState, TraceMapStep {
@@ -106,7 +110,7 @@ namespace PetriEngine::ExplicitColored {
                 state.updatePair(tid, nextBid);
                 if (nextBid != std::numeric_limits<Binding_t>::max()) {
                     auto newState = ColoredPetriNetStateEven{state, _net.getTransitionCount()};
-                    newState.id = _nextId++;
+                    newState.id = _newId();
                     fire(newState.marking, tid, binding);
 
                     return std::make_pair(newState, TraceMapStep {
@@ -122,6 +126,13 @@ namespace PetriEngine::ExplicitColored {
             return std::make_pair(ColoredPetriNetStateEven {{}, 0}, TraceMapStep {});
         }
 
+        [[nodiscard]] size_t _newId() const {
+            if (_sharedIds != nullptr) {
+                return _sharedIds->fetch_add(1, std::memory_order_relaxed);
+            }
+            return _nextId++;
+        }
+
         [[nodiscard]] static uint64_t _getKey(const size_t stateId, const Transition_t transition) {
             return ((stateId & 0xFFFF'FFFF'FFFF) << 16) | ((static_cast<uint64_t>(transition) & 0xFFFF));
         }
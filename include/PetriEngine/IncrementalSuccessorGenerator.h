@@ -0,0 +1,82 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCREMENTALSUCCESSORGENERATOR_H
+#define INCREMENTALSUCCESSORGENERATOR_H
+
+#include "SuccessorGenerator.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace PetriEngine {
+
+    /**
+     * Successor generator keeping the set of enabled transitions of the last
+     * prepared marking as a bitset.
+     *
+     * On prepare the new marking is compared to the previous one and only the
+     * transitions having a changed place in their preset (including inhibitor
+     * arcs) are rechecked. Consecutive markings in a search are often related
+     * by a single firing (the last successor in DFS, every step of a random
+     * walk), so usually only the neighbourhood of one transition is visited.
+     * If the markings differ too much, the enabled set is rebuilt as in
+     * SuccessorGenerator.
+     *
+     * Successors are produced in the same order as by SuccessorGenerator.
+     */
+    class IncrementalSuccessorGenerator : public SuccessorGenerator {
+    public:
+        IncrementalSuccessorGenerator(const PetriNet& net);
+        IncrementalSuccessorGenerator(const PetriNet& net, const std::shared_ptr<StubbornSet>&);
+        IncrementalSuccessorGenerator(const PetriNet& net, std::vector<std::shared_ptr<PQL::Condition> >& queries);
+        IncrementalSuccessorGenerator(const PetriNet& net, const std::shared_ptr<PQL::Condition> &query);
+
+        bool prepare(const Structures::State& state) override { return prepare(&state); }
+        bool prepare(const Structures::State* state) override;
+        bool next(Structures::State& write) override;
+
+        bool enabled(uint32_t t) const {
+            return (_enabled[t / 64] >> (t % 64)) & 1;
+        }
+
+        /** Number of full rebuilds and incremental updates of the enabled set */
+        size_t rebuilds() const { return _rebuilds; }
+        size_t updates() const { return _updates; }
+
+    private:
+        void rebuild();
+        bool update(const MarkVal* marking);
+        void set(uint32_t t, bool value) {
+            auto mask = uint64_t{1} << (t % 64);
+            _enabled[t / 64] = value ? (_enabled[t / 64] | mask) : (_enabled[t / 64] & ~mask);
+        }
+
+        // place -> transitions with an arc (inhibitor or not) from the place
+        std::vector<uint32_t> _consumerPtrs;
+        std::vector<uint32_t> _consumers;
+
+        std::vector<uint64_t> _enabled;
+        std::vector<MarkVal> _marking;
+        std::vector<uint32_t> _changed;
+        bool _valid = false;
+        uint32_t _cursor = 0;
+        size_t _rebuilds = 0;
+        size_t _updates = 0;
+    };
+}
+
+#endif /* INCREMENTALSUCCESSORGENERATOR_H */
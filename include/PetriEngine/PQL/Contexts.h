@@ -186,7 +186,7 @@ namespace PetriEngine {
                 _negated = false;
                 _marking = marking;
                 _net = net;
-                _base_lp = buildBase();
+                // built on first use, isImpossible uses the state equation kept by the cache
                 _start = std::chrono::high_resolution_clock::now();
                 _cache = cache;
                 _markingOutOfBounds = false;
@@ -0,0 +1,164 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VERIFYPN_QUERYPROGRAM_H
+#define VERIFYPN_QUERYPROGRAM_H
+
+#include "PQL.h"
+#include "Contexts.h"
+#include "../Structures/MarkingBatch.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace PetriEngine { namespace PQL {
+
+    class QueryCompiler;
+    class DistanceCompiler;
+
+    /**
+     * Conditions lowered to a flat list of instructions over place indices and
+     * constants, evaluated with the semantics of PQL::evaluate. Every node of
+     * the conditions owns a slot in a scratch_t, where its value from the last
+     * evaluation can be read back, as evaluateAndSet leaves it in the tree.
+     * The code of a subformula is contiguous, so any compiled subformula can be
+     * evaluated on its own.
+     * The program is immutable once compiled and may be shared by any number
+     * of threads, each with its own scratch_t, unless it contains upper bounds:
+     * these record the bound seen so far in the query itself, so they are
+     * evaluated on the tree and is_thread_safe() is false.
+     *
+     * The queries also get code for Condition::distance, where negation is
+     * resolved at compile time. Both kinds of code can be run on a whole
+     * MarkingBatch at once; each instruction is then applied to every
+     * marking of the batch in a loop over the columns of the batch, using
+     * AVX2 when the CPU supports it.
+     */
+    class QueryProgram {
+    public:
+        class scratch_t {
+        public:
+            scratch_t() = default;
+        private:
+            friend class QueryProgram;
+            std::vector<int64_t> _values;
+            // the slots of every marking of the last batch, slot-major
+            std::vector<int64_t> _lanes;
+        };
+
+        QueryProgram() = default;
+        explicit QueryProgram(const Condition* query);
+        explicit QueryProgram(const std::vector<Condition_ptr>& queries);
+
+        scratch_t make_scratch() const;
+
+        /** Evaluates the first condition of the program */
+        Condition::Result evaluate(const EvaluationContext& context, scratch_t& scratch) const;
+
+        /** Evaluates a compiled condition, other conditions are evaluated on the tree */
+        Condition::Result evaluate(const Condition* condition, const EvaluationContext& context, scratch_t& scratch) const;
+
+        bool contains(const Condition* condition) const {
+            return _conditions.count(condition) > 0;
+        }
+
+        /** Evaluates a compiled condition on every marking of the batch */
+        void evaluate(const Condition* condition, const Structures::MarkingBatch& batch, const PetriNet* net,
+                      scratch_t& scratch, Condition::Result* results) const;
+
+        /** The distance of a query, as Condition::distance; other conditions use the tree */
+        uint32_t distance(const Condition* query, const EvaluationContext& context, scratch_t& scratch) const;
+
+        /** The distance of a query for every marking of the batch */
+        void distance(const Condition* query, const Structures::MarkingBatch& batch, const PetriNet* net,
+                      scratch_t& scratch, uint32_t* distances) const;
+
+        /** The value of a condition from the last evaluation of the code containing it */
+        Condition::Result result(const Condition* condition, const scratch_t& scratch) const;
+
+        /** The value of an expression from the last evaluation of the code containing it */
+        int64_t value(const Expr* expr, const scratch_t& scratch) const;
+
+        bool is_thread_safe() const {
+            return _fallbacks.empty();
+        }
+
+        size_t size() const {
+            return _code.size();
+        }
+
+        /** Enables or disables the AVX2 batch kernels (enabled if the CPU supports them) */
+        static void set_vectorized(bool enable);
+        static bool vectorized();
+
+    private:
+        friend class QueryCompiler;
+        friend class DistanceCompiler;
+
+        enum class op_t : uint8_t {
+            LITERAL, PLACE, SUM, PRODUCT, SUBTRACT, NEGATE,
+            SET, EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, CONJUNCTION, DEADLOCK, NOT,
+            AND, OR, EVENTUALLY, ALWAYS, UNTIL, UNTIL_ELSE, JUMP, FALLBACK,
+            // distances, stored as uint32_t in the slots
+            DELTA_EQUAL, DELTA_LESS, DELTA_LESS_EQUAL, DISTANCE_CONJUNCTION,
+            DISTANCE_SUM, DISTANCE_MIN, DISTANCE_FALLBACK
+        };
+
+        struct instruction_t {
+            op_t _op;
+            // the slot written by the instruction
+            uint32_t _dst = 0;
+            // operands, slots, offsets into _operands or _constraints, or jump targets
+            uint32_t _a = 0;
+            uint32_t _b = 0;
+            uint32_t _c = 0;
+            int64_t _value = 0;
+        };
+
+        struct constraint_t {
+            uint32_t _place;
+            uint32_t _lower;
+            uint32_t _upper;
+        };
+
+        struct range_t {
+            uint32_t _begin;
+            uint32_t _end;
+            uint32_t _slot;
+        };
+
+        struct lanes_t;
+
+        void run(const range_t& range, const EvaluationContext& context, scratch_t& scratch) const;
+        void run(const range_t& range, const Structures::MarkingBatch& batch, const PetriNet* net,
+                 scratch_t& scratch) const;
+
+        std::vector<instruction_t> _code;
+        std::vector<uint32_t> _operands;
+        std::vector<constraint_t> _constraints;
+        std::vector<Condition*> _fallbacks;
+        // conditions whose distance is computed on the tree, which does not modify them
+        std::vector<const Condition*> _distance_fallbacks;
+        // the value of every slot before the first evaluation
+        std::vector<int64_t> _initial;
+        std::vector<range_t> _roots;
+        std::unordered_map<const Condition*, range_t> _conditions;
+        // the distance code of the queries
+        std::unordered_map<const Condition*, range_t> _distances;
+        std::unordered_map<const Expr*, uint32_t> _expressions;
+    };
+} }
+
+#endif //VERIFYPN_QUERYPROGRAM_H
@@ -0,0 +1,221 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKEDSUCCESSORGENERATOR_H
+#define PACKEDSUCCESSORGENERATOR_H
+
+#include "SuccessorGenerator.h"
+#include "utils/errors.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace PetriEngine {
+
+    /**
+     * Successor generator for ordinary nets, i.e. nets where every arc,
+     * including inhibitor arcs, has weight one.
+     *
+     * In such nets enabledness only depends on which places are marked, so
+     * the parent marking is packed into a bitset of marked places and each
+     * transition is enabled iff its preset mask is covered (and, with
+     * Inhibitors, its inhibitor mask is disjoint from the bitset). The masks
+     * are stored sparsely as (word, bits) pairs, so a check touches at most
+     * one word per input arc. Firing only adds and subtracts one per arc,
+     * without looking at arc weights or inhibitor flags.
+     *
+     * Successors are produced in the same order as by SuccessorGenerator.
+     */
+    template<bool Inhibitors>
+    class PackedSuccessorGenerator : public SuccessorGenerator {
+    public:
+        PackedSuccessorGenerator(const PetriNet& net)
+        : SuccessorGenerator(net), _marked((net._nplaces + 63) / 64, 0)
+        {
+            _prePtrs.push_back(0);
+            _inhibPtrs.push_back(0);
+            _consumePtrs.push_back(0);
+            _producePtrs.push_back(0);
+            for (uint32_t t = 0; t < _net._ntransitions; ++t) {
+                const TransPtr& ptr = _net._transitions[t];
+                for (uint32_t i = ptr.inputs; i < ptr.outputs; ++i) {
+                    const Invariant& inv = _net._invariants[i];
+                    if (inv.inhibitor) {
+                        addMask(_inhibMasks, _inhibPtrs.back(), inv.place);
+                    } else {
+                        addMask(_preMasks, _prePtrs.back(), inv.place);
+                        _consume.push_back(inv.place);
+                    }
+                }
+                for (uint32_t i = ptr.outputs; i < _net._transitions[t + 1].inputs; ++i)
+                    _produce.push_back(_net._invariants[i].place);
+                _prePtrs.push_back(_preMasks.size());
+                _inhibPtrs.push_back(_inhibMasks.size());
+                _consumePtrs.push_back(_consume.size());
+                _producePtrs.push_back(_produce.size());
+            }
+        }
+
+        PackedSuccessorGenerator(const PetriNet& net, const std::shared_ptr<StubbornSet>&)
+        : PackedSuccessorGenerator(net) {}
+
+        PackedSuccessorGenerator(const PetriNet& net, std::vector<std::shared_ptr<PQL::Condition> >&)
+        : PackedSuccessorGenerator(net) {}
+
+        PackedSuccessorGenerator(const PetriNet& net, const std::shared_ptr<PQL::Condition>&)
+        : PackedSuccessorGenerator(net) {}
+
+        /**
+         * The generator is exact for nets where all arcs have weight one and
+         * no transition has two input arcs from the same place.
+         */
+        static bool applicable(const PetriNet& net)
+        {
+            if (!Inhibitors && net.has_inhibitor())
+                return false;
+            std::vector<uint32_t> last(net._nplaces, std::numeric_limits<uint32_t>::max());
+            for (uint32_t t = 0; t < net._ntransitions; ++t) {
+                const TransPtr& ptr = net._transitions[t];
+                for (uint32_t i = ptr.inputs; i < net._transitions[t + 1].inputs; ++i) {
+                    const Invariant& inv = net._invariants[i];
+                    if (inv.tokens != 1)
+                        return false;
+                    if (i < ptr.outputs && !inv.inhibitor) {
+                        if (last[inv.place] == t)
+                            return false;
+                        last[inv.place] = t;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool prepare(const Structures::State& state) override { return prepare(&state); }
+
+        bool prepare(const Structures::State* state) override
+        {
+            SuccessorGenerator::prepare(state, 0);
+            const MarkVal* marking = state->marking();
+            const uint32_t nplaces = _net._nplaces;
+            for (uint32_t w = 0; w < _marked.size(); ++w) {
+                const uint32_t base = w * 64;
+                const uint32_t n = std::min<uint32_t>(64, nplaces - base);
+                uint64_t bits = 0;
+                for (uint32_t i = 0; i < n; ++i)
+                    bits |= uint64_t{marking[base + i] != 0} << i;
+                _marked[w] = bits;
+            }
+            return true;
+        }
+
+        bool next(Structures::State& write) override
+        {
+            constexpr auto none = std::numeric_limits<uint32_t>::max();
+            // orphans are under place 0, so it is visited even if unmarked
+            for (; _suc_pcounter < _net._nplaces; _suc_pcounter = nextMarked(_suc_pcounter + 1)) {
+                if (_suc_tcounter == none)
+                    _suc_tcounter = _net._placeToPtrs[_suc_pcounter];
+                const uint32_t last = _net._placeToPtrs[_suc_pcounter + 1];
+                for (; _suc_tcounter != last; ++_suc_tcounter) {
+                    if (!enabled(_suc_tcounter)) continue;
+                    fire(write, _suc_tcounter);
+                    return true;
+                }
+                _suc_tcounter = none;
+            }
+            return false;
+        }
+
+        bool enabled(uint32_t t) const
+        {
+            for (uint32_t i = _prePtrs[t]; i < _prePtrs[t + 1]; ++i) {
+                const mask_t& m = _preMasks[i];
+                if ((_marked[m.word] & m.bits) != m.bits)
+                    return false;
+            }
+            if constexpr (Inhibitors) {
+                for (uint32_t i = _inhibPtrs[t]; i < _inhibPtrs[t + 1]; ++i) {
+                    const mask_t& m = _inhibMasks[i];
+                    if ((_marked[m.word] & m.bits) != 0)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct mask_t {
+            uint32_t word;
+            uint64_t bits;
+        };
+
+        // consecutive arcs to places in the same word share a mask
+        static void addMask(std::vector<mask_t>& masks, size_t first, uint32_t place)
+        {
+            const uint32_t word = place / 64;
+            const uint64_t bit = uint64_t{1} << (place % 64);
+            if (masks.size() > first && masks.back().word == word)
+                masks.back().bits |= bit;
+            else
+                masks.push_back({word, bit});
+        }
+
+        uint32_t nextMarked(uint32_t p) const
+        {
+            const uint32_t nplaces = _net._nplaces;
+            if (p >= nplaces)
+                return nplaces;
+            uint32_t w = p / 64;
+            uint64_t bits = _marked[w] & (~uint64_t{0} << (p % 64));
+            while (bits == 0) {
+                if (++w == _marked.size())
+                    return nplaces;
+                bits = _marked[w];
+            }
+            return w * 64 + __builtin_ctzll(bits);
+        }
+
+        void fire(Structures::State& write, uint32_t t)
+        {
+            _suc_tcounter = t + 1; // make sure "fired()" call reflects this now
+            MarkVal* marking = write.marking();
+            memcpy(marking, _parent->marking(), _net._nplaces * sizeof(MarkVal));
+            for (uint32_t i = _consumePtrs[t]; i < _consumePtrs[t + 1]; ++i)
+                --marking[_consume[i]];
+            for (uint32_t i = _producePtrs[t]; i < _producePtrs[t + 1]; ++i) {
+                MarkVal& m = marking[_produce[i]];
+                if (m >= std::numeric_limits<uint32_t>::max() - 1)
+                    throw base_error("Exceeded 2**32 limit of tokens in a single place (", size_t{m} + 1, ")");
+                ++m;
+            }
+        }
+
+        std::vector<uint64_t> _marked;
+        std::vector<mask_t> _preMasks;
+        std::vector<mask_t> _inhibMasks;
+        std::vector<uint32_t> _prePtrs;
+        std::vector<uint32_t> _inhibPtrs;
+        std::vector<uint32_t> _consume;
+        std::vector<uint32_t> _produce;
+        std::vector<uint32_t> _consumePtrs;
+        std::vector<uint32_t> _producePtrs;
+    };
+}
+
+#endif /* PACKEDSUCCESSORGENERATOR_H */
@@ -147,6 +147,8 @@ namespace PetriEngine {
         friend class PetriNetBuilder;
         friend class Reducer;
         friend class SuccessorGenerator;
+        friend class IncrementalSuccessorGenerator;
+        template<bool> friend class PackedSuccessorGenerator;
         friend class ReducingSuccessorGenerator;
         friend class STSolver;
         friend class StubbornSet;
@@ -136,6 +136,16 @@ namespace PetriEngine {
                     int reductiontype, bool reconstructTrace, const PetriNet* net, int timeout,
                     std::vector<uint32_t>& reductions);
 
+        /**
+         * Groups the queries still to be verified (results Unknown) by the places
+         * they use. A copy of the builder reduced for the queries of one group
+         * only preserves those, and is often much smaller than the net reduced
+         * for all queries.
+         */
+        std::vector<std::vector<size_t>> queryGroups(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                                     const std::vector<Reachability::ResultPrinter::Result>& results,
+                                                     const PetriNet* net);
+
         void printStats(std::ostream& out)
         {
             reducer.printStats(out);
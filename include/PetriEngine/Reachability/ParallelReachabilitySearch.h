@@ -0,0 +1,277 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PARALLELREACHABILITYSEARCH_H
+#define PARALLELREACHABILITYSEARCH_H
+
+#include "ReachabilitySearch.h"
+#include "../Structures/ConcurrentStateSet.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        /**
+         * Multi-threaded variant of ReachabilitySearch. Every worker owns a
+         * successor generator and a queue, all workers share a single
+         * ConcurrentStateSet, and idle workers steal from the queues of the
+         * others. Strategies without a parallel implementation (RPFS and
+         * RandomWalk) fall back to the sequential search.
+         */
+        class ParallelReachabilitySearch : public ReachabilitySearch {
+        public:
+            ParallelReachabilitySearch(PetriNet& net, AbstractHandler& callback, uint32_t threads, int kbound = 0)
+            : ReachabilitySearch(net, callback, kbound), _threads(std::max<uint32_t>(threads, 1)) {
+            }
+
+            bool reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    Strategy strategy,
+                    bool usestubborn,
+                    bool statespacesearch,
+                    StatisticsLevel printstats,
+                    bool keep_trace,
+                    size_t seed);
+
+            static bool supports(Strategy strategy);
+
+        private:
+            template<typename Q>
+            struct worker_queue_t {
+                std::mutex _lock;
+                Q _queue;
+                explicit worker_queue_t(size_t seed) : _queue(seed) {}
+            };
+
+            struct alignas(64) worker_stats_t {
+                std::atomic<size_t> _expanded{0};
+                std::atomic<size_t> _explored{0};
+                std::vector<size_t> _enabledTransitionsCount;
+            };
+
+            template<typename Q, typename G>
+            bool tryReachParallel(
+                std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                std::vector<ResultPrinter::Result>& results,
+                bool usequeries,
+                bool keep_trace,
+                StatisticsLevel statisticsLevel,
+                size_t seed);
+
+            template<typename Q>
+            size_t pop(std::vector<std::unique_ptr<worker_queue_t<Q>>>& queues, size_t worker);
+
+            bool checkQueries(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                              std::vector<ResultPrinter::Result>& results,
+                              Structures::State& state, size_t id,
+                              Structures::ConcurrentStateSet& states,
+                              PQL::QueryProgram::scratch_t& scratch);
+
+            searchstate_t collectStats(bool withTransitions) const;
+
+            uint32_t _threads;
+            std::vector<worker_stats_t> _stats;
+            std::unique_ptr<std::atomic<bool>[]> _solved;
+            std::atomic<bool> _stop{false};
+            std::atomic<bool> _done{false};
+            std::atomic<size_t> _pending{0};
+            std::atomic<size_t> _heurquery{0};
+            std::mutex _resultLock;
+            std::mutex _queryLock;
+            std::exception_ptr _error;
+        };
+
+        template <typename G>
+        inline G _makeParallelSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex*) {
+            return G{net, queries};
+        }
+        template <>
+        inline ReducingSuccessorGenerator _makeParallelSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex* querylock) {
+            auto stubset = std::make_shared<ReachabilityStubbornSet>(net, queries);
+            stubset->setInterestingVisitor<InterestingTransitionVisitor>();
+            stubset->setQueryLock(querylock);
+            return ReducingSuccessorGenerator{net, stubset};
+        }
+
+        template<typename Q>
+        size_t ParallelReachabilitySearch::pop(std::vector<std::unique_ptr<worker_queue_t<Q>>>& queues, size_t worker)
+        {
+            {
+                auto& own = *queues[worker];
+                std::lock_guard<std::mutex> guard(own._lock);
+                auto id = own._queue.pop();
+                if(id != Structures::Queue::EMPTY)
+                    return id;
+            }
+            // steal from the other workers, but never wait for a busy queue
+            for(size_t n = 1; n < queues.size(); ++n)
+            {
+                auto& other = *queues[(worker + n) % queues.size()];
+                std::unique_lock<std::mutex> guard(other._lock, std::try_to_lock);
+                if(!guard.owns_lock())
+                    continue;
+                auto id = other._queue.pop();
+                if(id != Structures::Queue::EMPTY)
+                    return id;
+            }
+            return Structures::Queue::EMPTY;
+        }
+
+        template<typename Q, typename G>
+        bool ParallelReachabilitySearch::tryReachParallel(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                        std::vector<ResultPrinter::Result>& results, bool usequeries, bool keep_trace,
+                                        StatisticsLevel statisticsLevel, size_t seed)
+        {
+            // set up shared state
+            _stats = std::vector<worker_stats_t>(_threads);
+            for(auto& s : _stats)
+                s._enabledTransitionsCount.resize(_net.numberOfTransitions(), 0);
+            _solved = std::make_unique<std::atomic<bool>[]>(queries.size());
+            for(size_t i = 0; i < queries.size(); ++i)
+                _solved[i] = results[i] != ResultPrinter::Unknown;
+            _stop = false;
+            _done = false;
+            _pending = 0;
+            _heurquery = queries.size() >= 2 ? std::rand() % queries.size() : 0;
+            _error = nullptr;
+            _initial.setMarking(_net.makeInitialMarking());
+            // the compiled queries are shared, every worker evaluates them into its own scratch
+            _program = PQL::QueryProgram(queries);
+            std::vector<PQL::QueryProgram::scratch_t> scratch(_threads, _program.make_scratch());
+
+            Structures::ConcurrentStateSet states(_net, _kbound, _threads, keep_trace);
+
+            std::vector<std::unique_ptr<worker_queue_t<Q>>> queues;
+            std::vector<G> generators;
+            generators.reserve(_threads);
+            for(size_t w = 0; w < _threads; ++w)
+            {
+                queues.emplace_back(std::make_unique<worker_queue_t<Q>>(seed + w));
+                generators.emplace_back(_makeParallelSucGen<G>(_net, queries, &_queryLock));
+            }
+
+            Structures::State initial;
+            initial.setMarking(_net.makeInitialMarking());
+            auto r = states.add(initial, 0);
+            // this can fail due to reductions; we push tokens around and violate K
+            if(r.first)
+            {
+                if(usequeries && checkQueries(queries, results, initial, r.second, states, scratch[0]))
+                    _stop = true;
+                else
+                {
+                    PQL::DistanceContext dc(&_net, initial.marking());
+                    _pending = 1;
+                    queues[0]->_queue.push(r.second, &dc, queries[_heurquery].get());
+                }
+            }
+
+            auto worker = [&](size_t w) {
+                try {
+                    Structures::State state;
+                    Structures::State working;
+                    state.setMarking(_net.makeInitialMarking());
+                    working.setMarking(_net.makeInitialMarking());
+                    auto& generator = generators[w];
+                    auto& stats = _stats[w];
+                    auto& queue = *queues[w];
+
+                    while(!_stop)
+                    {
+                        auto nid = pop(queues, w);
+                        if(nid == Structures::Queue::EMPTY)
+                        {
+                            // work is still being expanded elsewhere and may produce successors
+                            if(_pending.load() == 0)
+                                break;
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        states.decode(state, nid, w);
+                        generator.prepare(&state);
+
+                        while(!_stop && generator.next(working)){
+                            ++stats._enabledTransitionsCount[generator.fired()];
+                            auto res = states.add(working, w);
+                            // If we have not seen this state before
+                            if (res.first) {
+                                // the history must be complete before the state is visible to other workers
+                                states.setHistory(res.second, nid, generator.fired());
+                                stats._explored.fetch_add(1, std::memory_order_relaxed);
+                                if(usequeries && checkQueries(queries, results, working, res.second, states, scratch[w]))
+                                {
+                                    _stop = true;
+                                    break;
+                                }
+                                ++_pending;
+                                PQL::DistanceContext dc(&_net, working.marking());
+                                std::lock_guard<std::mutex> guard(queue._lock);
+                                queue._queue.push(res.second, &dc, queries[_heurquery].get());
+                            }
+                        }
+                        stats._expanded.fetch_add(1, std::memory_order_relaxed);
+                        --_pending;
+                    }
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> guard(_resultLock);
+                    if(!_error)
+                        _error = std::current_exception();
+                    _stop = true;
+                }
+            };
+
+            if(!_stop && r.first)
+            {
+                std::vector<std::thread> workers;
+                for(size_t w = 1; w < _threads; ++w)
+                    workers.emplace_back(worker, w);
+                worker(0);
+                for(auto& t : workers)
+                    t.join();
+            }
+
+            if(_error)
+                std::rethrow_exception(_error);
+
+            states.syncStatistics();
+            auto ss = collectStats(true);
+            if(!_done)
+            {
+                // no more successors, print last results
+                for(size_t i= 0; i < queries.size(); ++i)
+                {
+                    if(results[i] == ResultPrinter::Unknown)
+                    {
+                        results[i] = doCallback(queries[i], i, ResultPrinter::NotSatisfied, ss, &states).first;
+                    }
+                }
+            }
+
+            if(statisticsLevel != StatisticsLevel::None)
+                printStats(ss, &states, statisticsLevel);
+            _max_tokens = states.maxTokens();
+            return _done;
+        }
+    }
+}
+
+#endif // PARALLELREACHABILITYSEARCH_H
@@ -0,0 +1,100 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PORTFOLIOREACHABILITYSEARCH_H
+#define PORTFOLIOREACHABILITYSEARCH_H
+
+#include "ReachabilitySearch.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PetriEngine {
+    class Reducer;
+    namespace Reachability {
+
+        /**
+         * Runs several reachability engines on their own threads, sharing one
+         * net and one vector of queries. The first answer to a query is passed
+         * on to the callback together with the engine that found it; the other
+         * engines pick the answer up and stop working on that query, and all
+         * engines stop once every query is answered.
+         *
+         * Engines are named as the search strategies (BestFS, BFS, DFS, RDFS,
+         * RPFS and RandomWalk) or TAR. An engine listed more than once is run
+         * with a different seed for each occurrence.
+         */
+        class PortfolioReachabilitySearch {
+        public:
+            PortfolioReachabilitySearch(PetriNet& net, AbstractHandler& callback, Reducer* reducer, int kbound = 0)
+            : _net(net), _callback(callback), _reducer(reducer), _kbound(kbound) {
+            }
+
+            /** Returns true if every query was answered */
+            bool reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    const std::vector<std::string>& engines,
+                    bool usestubborn,
+                    StatisticsLevel printstats,
+                    size_t seed,
+                    int64_t depthRandomWalk = 50000,
+                    const int64_t incRandomWalk = 5000);
+
+            static bool supports(const std::string& engine);
+
+            /** Name of the engine that answered query i, empty if it was not answered by the portfolio */
+            const std::string& winner(size_t i) const { return _winners[i]; }
+
+        private:
+            class handler_t;
+            class engine_t;
+
+            void run(size_t engine,
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    const std::vector<ResultPrinter::Result>& results,
+                    bool usestubborn, size_t seed,
+                    int64_t depthRandomWalk, int64_t incRandomWalk);
+
+            std::pair<AbstractHandler::Result, bool> answer(size_t engine, size_t index, PQL::Condition* query,
+                    AbstractHandler::Result result, const std::vector<uint32_t>* maxPlaceBound,
+                    size_t expandedStates, size_t exploredStates, size_t discoveredStates, int maxTokens,
+                    Structures::StateSetInterface* stateset, size_t lastmarking, const MarkVal* initialMarking,
+                    bool trace);
+
+            PetriNet& _net;
+            AbstractHandler& _callback;
+            Reducer* _reducer;
+            int _kbound;
+            StatisticsLevel _printstats = StatisticsLevel::None;
+            bool _upperBounds = false;
+            std::vector<std::string> _engines;
+            std::vector<std::string> _labels;
+            std::vector<ResultPrinter::Result> _answers;
+            std::vector<std::string> _winners;
+            std::unique_ptr<std::atomic<bool>[]> _solved;
+            std::atomic<bool> _stop{false};
+            size_t _unanswered = 0;
+            std::mutex _resultLock;
+            std::mutex _queryLock;
+            std::exception_ptr _error;
+        };
+    }
+}
+
+#endif /* PORTFOLIOREACHABILITYSEARCH_H */
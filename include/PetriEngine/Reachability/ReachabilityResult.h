@@ -100,9 +100,30 @@ namespace PetriEngine {
         // The entire result-printer workflow is overdue a refactor.
         class TarResultPrinter : public AbstractHandler {
         private:
-            ResultPrinter& _printer;
+            AbstractHandler& _printer;
         public:
-            TarResultPrinter(ResultPrinter& printer) : _printer(printer) {}
+            TarResultPrinter(AbstractHandler& printer) : _printer(printer) {}
+            std::pair<Result, bool> handle(
+                size_t index,
+                PQL::Condition* query,
+                Result result,
+                const std::vector<uint32_t>* maxPlaceBound = nullptr,
+                size_t expandedStates = 0,
+                size_t exploredStates = 0,
+                size_t discoveredStates = 0,
+                int maxTokens = 0,
+                Structures::StateSetInterface* stateset = nullptr, size_t lastmarking = 0, const MarkVal* initialMarking = nullptr, bool trace = true) override;
+        };
+
+        // Passes the results of a search over the queries of one query group on
+        // to the printer, under their index in the full list of queries.
+        class QueryGroupResultPrinter : public AbstractHandler {
+        private:
+            AbstractHandler& _printer;
+            const std::vector<size_t>& _indices;
+        public:
+            QueryGroupResultPrinter(AbstractHandler& printer, const std::vector<size_t>& indices)
+            : _printer(printer), _indices(indices) {}
             std::pair<Result, bool> handle(
                 size_t index,
                 PQL::Condition* query,
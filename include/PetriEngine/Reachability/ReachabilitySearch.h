@@ -27,13 +27,21 @@
 #include "../Structures/StateSet.h"
 #include "../Structures/Queue.h"
 #include "../Structures/PotencyQueue.h"
+#include "../Structures/ExternalStateSet.h"
+#include "../Structures/ApproximateStateSet.h"
+#include "../Structures/MarkingBatch.h"
 #include "../SuccessorGenerator.h"
+#include "../IncrementalSuccessorGenerator.h"
+#include "../PackedSuccessorGenerator.h"
 #include "../ReducingSuccessorGenerator.h"
 #include "PetriEngine/Stubborn/ReachabilityStubbornSet.h"
+#include "PetriEngine/PQL/QueryProgram.h"
 
 #include "PetriEngine/options.h"
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 
@@ -67,6 +75,28 @@ namespace PetriEngine {
                     const int64_t incRandomWalk = 5000,
                     const std::vector<MarkVal>& initPotencies = std::vector<MarkVal>());
             size_t maxTokens() const;
+
+            /** Location and memory (in MB) of the ExternalBFS strategy */
+            void setExternalMemory(const std::string& directory, size_t memory) {
+                _externalDirectory = directory;
+                _externalMemory = memory;
+            }
+
+            /** Storage of visited markings and its memory budget (in MB) */
+            void setStateStorage(StateStorage storage, size_t memory) {
+                _storage = storage;
+                _memoryBudget = memory;
+            }
+
+            /** Lock taken while queries are evaluated in place, needed when the queries are shared between threads */
+            void setQueryLock(std::mutex* lock) {
+                _queryLock = lock;
+            }
+
+            /** Polled by searches that never run out of states (RandomWalk), which stop once it returns true */
+            void setCancellation(std::function<bool()> cancelled) {
+                _cancelled = std::move(cancelled);
+            }
         protected:
             struct searchstate_t {
                 size_t expandedStates = 0;
@@ -87,6 +117,23 @@ namespace PetriEngine {
                 const int64_t incRandomWalk,
                 const std::vector<MarkVal>& initPotencies);
 
+            template<typename W>
+            W makeStateSet() const {
+                if constexpr (std::is_same_v<W, Structures::ApproximateStateSet>)
+                    return W(_net, _kbound, _storage, _memoryBudget * 1024 * 1024);
+                else
+                    return W(_net, _kbound);
+            }
+
+            void printApproximation(const Structures::ApproximateStateSet& states) const;
+
+            template<typename G>
+            bool tryReachExternal(
+                std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                std::vector<ResultPrinter::Result>& results,
+                bool usequeries,
+                StatisticsLevel statisticsLevel);
+
             template<typename Q, typename W = Structures::StateSet, typename G>
             bool tryReach(
                 std::vector<std::shared_ptr<PQL::Condition > >& queries,
@@ -103,6 +150,22 @@ namespace PetriEngine {
                               Structures::State&, searchstate_t&,
                               Structures::StateSetInterface*);
 
+            /** As checkQueries, where satisfied[i] is the value of query i in the marking, read for unanswered queries */
+            bool checkResults(std::vector<std::shared_ptr<PQL::Condition > >&,
+                              std::vector<ResultPrinter::Result>&,
+                              const PQL::Condition::Result* satisfied, searchstate_t&,
+                              Structures::StateSetInterface*);
+
+            /**
+             * Evaluates the unanswered queries on every marking of the batch, the values of
+             * marking l are stored from satisfied[l * queries.size()]. Returns false if the
+             * search checks queries in its own way, each marking then goes through checkQueries.
+             */
+            virtual bool evaluateBatch(std::vector<std::shared_ptr<PQL::Condition > >&,
+                              const std::vector<ResultPrinter::Result>&,
+                              const Structures::MarkingBatch&,
+                              std::vector<PQL::Condition::Result>& satisfied);
+
             virtual std::pair<ResultPrinter::Result,bool> doCallback(
                 std::shared_ptr<PQL::Condition>& query, size_t i,
                 ResultPrinter::Result r, searchstate_t &ss,
@@ -114,16 +177,27 @@ namespace PetriEngine {
             Structures::State _initial;
             AbstractHandler& _callback;
             size_t _max_tokens = 0;
+            std::string _externalDirectory;
+            size_t _externalMemory = 1024;
+            StateStorage _storage = StateStorage::Exact;
+            size_t _memoryBudget = 1024;
+            std::mutex* _queryLock = nullptr;
+            std::function<bool()> _cancelled;
+            // the queries of the current search, compiled once it starts
+            PQL::QueryProgram _program;
+            PQL::QueryProgram::scratch_t _scratch;
+            std::vector<PQL::Condition::Result> _satisfied;
         };
 
         template <typename G>
-        inline G _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries) {
+        inline G _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex*) {
             return G{net, queries};
         }
         template <>
-        inline ReducingSuccessorGenerator _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries) {
+        inline ReducingSuccessorGenerator _makeSucGen(PetriNet &net, std::vector<PQL::Condition_ptr> &queries, std::mutex* querylock) {
             auto stubset = std::make_shared<ReachabilityStubbornSet>(net, queries);
             stubset->setInterestingVisitor<InterestingTransitionVisitor>();
+            stubset->setQueryLock(querylock);
             return ReducingSuccessorGenerator{net, stubset};
         }
 
@@ -149,7 +223,7 @@ namespace PetriEngine {
             state.setMarking(_net.makeInitialMarking());
             working.setMarking(_net.makeInitialMarking());
 
-            W states(_net, _kbound); // stateset
+            W states = makeStateSet<W>(); // stateset
 
             Q queue(seed); // Working queue
             if constexpr (std::is_base_of_v<Structures::PotencyQueue, Q>) {
@@ -157,7 +231,7 @@ namespace PetriEngine {
                     queue = Q(initPotencies, seed);
             }
 
-            G generator = _makeSucGen<G>(_net, queries); // successor generator
+            G generator = _makeSucGen<G>(_net, queries, _queryLock); // successor generator
             auto r = states.add(state);
             // this can fail due to reductions; we push tokens around and violate K
             if(r.first){
@@ -180,32 +254,72 @@ namespace PetriEngine {
                     queue.push(r.second, &dc, queries[ss.heurquery].get());
                 }
 
+                // the new successors of an expansion are collected, so their distances
+                // and queries are computed for all of them at once
+                constexpr bool heuristic = std::is_base_of_v<Structures::HeuristicQueue, Q> ||
+                                           std::is_base_of_v<Structures::PotencyQueue, Q>;
+                Structures::MarkingBatch batch(_net.numberOfPlaces());
+                std::vector<std::pair<size_t, uint32_t>> successors; // id and fired transition
+                std::vector<uint32_t> distances;
+                std::vector<PQL::Condition::Result> satisfied;
+
                 // Search!
                 for(auto nid = queue.pop(); nid != Structures::Queue::EMPTY; nid = queue.pop()) {
                     states.decode(state, nid);
                     generator.prepare(&state);
 
+                    batch.clear();
+                    successors.clear();
                     while(generator.next(working)){
                         ss.enabledTransitionsCount[generator.fired()]++;
                         auto res = states.add(working);
                         // If we have not seen this state before
                         if (res.first) {
-                            {
-                                PQL::DistanceContext dc(&_net, working.marking());
-                                if constexpr (std::is_same_v<Q, Structures::RandomPotencyQueue>)
-                                    queue.push(res.second, &dc, queries[ss.heurquery].get(), generator.fired());
-                                else
-                                    queue.push(res.second, &dc, queries[ss.heurquery].get());
-                            }
-                            states.setHistory(res.second, generator.fired());
-                            _satisfyingMarking = res.second;
-                            ss.exploredStates++;
-                            if (checkQueries(queries, results, working, ss, &states)) {
-                                if(statisticsLevel != StatisticsLevel::None)
-                                    printStats(ss, &states, statisticsLevel);
-                                _max_tokens = states.maxTokens();
-                                return true;
+                            batch.push(working.marking());
+                            successors.emplace_back(res.second, generator.fired());
+                        }
+                    }
+                    if (batch.empty()) {
+                        ss.expandedStates++;
+                        continue;
+                    }
+
+                    size_t heurquery = ss.heurquery;
+                    if constexpr (heuristic) {
+                        distances.resize(batch.size());
+                        _program.distance(queries[heurquery].get(), batch, &_net, _scratch, distances.data());
+                    }
+                    const bool batched = ss.usequeries && evaluateBatch(queries, results, batch, satisfied);
+                    for (uint32_t lane = 0; lane < batch.size(); ++lane) {
+                        auto [id, fired] = successors[lane];
+                        if constexpr (heuristic) {
+                            // a query was answered and another one guides the search
+                            if (heurquery != ss.heurquery) {
+                                heurquery = ss.heurquery;
+                                _program.distance(queries[heurquery].get(), batch, &_net, _scratch, distances.data());
                             }
+                            if constexpr (std::is_same_v<Q, Structures::RandomPotencyQueue>)
+                                queue.push(id, distances[lane], fired);
+                            else
+                                queue.push(id, distances[lane]);
+                        }
+                        else
+                            queue.push(id, nullptr, nullptr);
+                        states.setHistory(id, fired);
+                        _satisfyingMarking = id;
+                        ss.exploredStates++;
+                        bool done;
+                        if (batched)
+                            done = checkResults(queries, results, satisfied.data() + lane * queries.size(), ss, &states);
+                        else {
+                            working.copy(batch.marking(lane), _net.numberOfPlaces());
+                            done = checkQueries(queries, results, working, ss, &states);
+                        }
+                        if (done) {
+                            if(statisticsLevel != StatisticsLevel::None)
+                                printStats(ss, &states, statisticsLevel);
+                            _max_tokens = states.maxTokens();
+                            return true;
                         }
                     }
                     ss.expandedStates++;
@@ -221,6 +335,69 @@ namespace PetriEngine {
                 }
             }
 
+            if constexpr (std::is_same_v<W, Structures::ApproximateStateSet>)
+                printApproximation(states);
+            if(statisticsLevel != StatisticsLevel::None)
+                printStats(ss, &states, statisticsLevel);
+            _max_tokens = states.maxTokens();
+            return false;
+        }
+
+        template<typename G>
+        bool ReachabilitySearch::tryReachExternal(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                                  std::vector<ResultPrinter::Result>& results, bool usequeries,
+                                                  StatisticsLevel statisticsLevel)
+        {
+            // set up state
+            searchstate_t ss;
+            ss.enabledTransitionsCount.resize(_net.numberOfTransitions(), 0);
+            ss.expandedStates = 0;
+            ss.exploredStates = 0;
+            ss.heurquery = queries.size() >= 2 ? std::rand() % queries.size() : 0;
+            ss.usequeries = usequeries;
+
+            // set up working area
+            Structures::State state;
+            Structures::State working;
+            _initial.setMarking(_net.makeInitialMarking());
+            state.setMarking(_net.makeInitialMarking());
+            working.setMarking(_net.makeInitialMarking());
+
+            Structures::ExternalStateSet states(_net, _kbound, _externalDirectory, _externalMemory * 1024 * 1024);
+            G generator = _makeSucGen<G>(_net, queries, _queryLock); // successor generator
+
+            // this can fail due to reductions; we push tokens around and violate K
+            if(states.add(state))
+            {
+                // markings are only known to be new once their layer is read back, so queries are checked there
+                while(states.next(state))
+                {
+                    ss.exploredStates++;
+                    if(checkQueries(queries, results, state, ss, &states))
+                    {
+                        if(statisticsLevel != StatisticsLevel::None)
+                            printStats(ss, &states, statisticsLevel);
+                        _max_tokens = states.maxTokens();
+                        return true;
+                    }
+                    generator.prepare(&state);
+                    while(generator.next(working)){
+                        ss.enabledTransitionsCount[generator.fired()]++;
+                        states.add(working);
+                    }
+                    ss.expandedStates++;
+                }
+            }
+
+            // no more successors, print last results
+            for(size_t i= 0; i < queries.size(); ++i)
+            {
+                if(results[i] == ResultPrinter::Unknown)
+                {
+                    results[i] = doCallback(queries[i], i, ResultPrinter::NotSatisfied, ss, &states).first;
+                }
+            }
+
             if(statisticsLevel != StatisticsLevel::None)
                 printStats(ss, &states, statisticsLevel);
             _max_tokens = states.maxTokens();
@@ -251,7 +428,7 @@ namespace PetriEngine {
             currentStepState.setMarking(_net.makeInitialMarking());
 
             W states(_net, _kbound, query, initPotencies, seed); // RandomWalk State Set
-            G generator = _makeSucGen<G>(_net, queries); // Successor generator
+            G generator = _makeSucGen<G>(_net, queries, _queryLock); // Successor generator
 
             // Check initial marking
             if(ss.usequeries)
@@ -270,8 +447,19 @@ namespace PetriEngine {
                 _satisfyingMarking = 1;
             }
 
+            // the candidates of a step are collected, so their distances and queries are computed at once
+            Structures::MarkingBatch batch(_net.numberOfPlaces());
+            std::vector<uint32_t> fired;
+            std::vector<uint32_t> distances;
+            std::vector<PQL::Condition::Result> satisfied;
+
             const int64_t maxDepthValue = std::numeric_limits<int64_t>::max() - incRandomWalk;
             while(true) {
+                if(_cancelled && _cancelled())
+                {
+                    _max_tokens = states.maxTokens();
+                    return true;
+                }
                 // Start a new random walk
                 states.newWalk();
 
@@ -288,8 +476,18 @@ namespace PetriEngine {
                         states.addStepTrace();
                     }
 
+                    batch.clear();
+                    fired.clear();
                     while(generator.next(candidate)) {
                         ss.enabledTransitionsCount[generator.fired()]++;
+                        batch.push(candidate.marking());
+                        fired.push_back(generator.fired());
+                    }
+                    distances.resize(batch.size());
+                    _program.distance(query, batch, &_net, _scratch, distances.data());
+                    const bool batched = ss.usequeries && evaluateBatch(queries, results, batch, satisfied);
+
+                    for (uint32_t lane = 0; lane < batch.size(); ++lane) {
                         ss.exploredStates++;
 
                         if constexpr (std::is_same_v<W, Structures::TracableRandomWalkStateSet>) {
@@ -299,10 +497,17 @@ namespace PetriEngine {
                             // We have to pretend that the current candidate transition is fired.
                             // Then checkQueries will work for this candidate. In particular, it will
                             // be able to print the correct trace.
-                            states.setHistory(static_cast<size_t>(generator.fired()));
+                            states.setHistory(static_cast<size_t>(fired[lane]));
                         }
 
-                        if (checkQueries(queries, results, candidate, ss, &states)) {
+                        bool done;
+                        if (batched)
+                            done = checkResults(queries, results, satisfied.data() + lane * queries.size(), ss, &states);
+                        else {
+                            candidate.copy(batch.marking(lane), _net.numberOfPlaces());
+                            done = checkQueries(queries, results, candidate, ss, &states);
+                        }
+                        if (done) {
                             if(statisticsLevel != StatisticsLevel::None)
                                 printStats(ss, &states, statisticsLevel);
                             _max_tokens = states.maxTokens();
@@ -310,13 +515,13 @@ namespace PetriEngine {
                         } else {
                             if constexpr (std::is_same_v<W, Structures::TracableRandomWalkStateSet>) {
                                 // Returns false if the candidate is not a better candidate to be the next marking
-                                if (!states.computeCandidate(candidate.marking(), query, generator.fired())) {
+                                if (!states.computeCandidate(batch.marking(lane), distances[lane], fired[lane])) {
                                     // The candidate does not satisfy the queries and is not marked as a better
                                     // candidate to be the next marking, so we restore the previous queued transition
                                     states.setHistory(states.getPreviousTransition());
                                 }
                             } else {
-                                states.computeCandidate(candidate.marking(), query, generator.fired());
+                                states.computeCandidate(batch.marking(lane), distances[lane], fired[lane]);
                             }
                         }
                     }
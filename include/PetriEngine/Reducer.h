@@ -18,6 +18,8 @@
 #include "../PetriParse/PNMLParser.h"
 #include "NetStructures.h"
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include <optional>
 
@@ -88,6 +90,100 @@ namespace PetriEngine {
         size_t weight;
    };
 
+    /**
+     * The nodes a reduction rule has to examine on its next pass: every node on
+     * the first pass, after that only the nodes touched since they were last
+     * examined. A node touched during a pass ahead of the node being examined is
+     * examined in the same pass, so the rule meets the nodes in the same order
+     * as a full scan would. Nodes at or above the size of a pass are left for
+     * the first pass that reaches them.
+     */
+    class ReductionCandidates {
+    public:
+        // starts a pass over the nodes [0, size)
+        void begin(uint32_t size)
+        {
+            // a pass cut short by the timeout may have dropped candidates
+            if (_active)
+                touchAll();
+            _active = true;
+            _size = size;
+            _cursor = -1;
+            _scan = _dirty_from;
+            _current.clear();
+            size_t kept = 0;
+            for (auto n : _next) {
+                if (n < size) {
+                    _queued_next[n] = false;
+                    _current.push_back(n);
+                }
+                else _next[kept++] = n;
+            }
+            _next.resize(kept);
+            std::make_heap(_current.begin(), _current.end(), std::greater<uint32_t>());
+            _dirty_from = std::max(_dirty_from, size);
+        }
+
+        bool next(uint32_t& node)
+        {
+            // the heap only holds nodes below the untouched range [_scan, _size)
+            while (!_current.empty()) {
+                std::pop_heap(_current.begin(), _current.end(), std::greater<uint32_t>());
+                node = _current.back();
+                _current.pop_back();
+                if ((int64_t)node <= _cursor) continue; // touched more than once
+                _cursor = node;
+                return true;
+            }
+            if (_scan < _size) {
+                node = _scan++;
+                _cursor = node;
+                return true;
+            }
+            _active = false;
+            return false;
+        }
+
+        void touch(uint32_t node)
+        {
+            if (_active && (int64_t)node > _cursor && node < _size) {
+                if (node < _scan) {
+                    _current.push_back(node);
+                    std::push_heap(_current.begin(), _current.end(), std::greater<uint32_t>());
+                }
+                return;
+            }
+            if (node >= _dirty_from) return;
+            if (node >= _queued_next.size())
+                _queued_next.resize(node + 1, false);
+            if (!_queued_next[node]) {
+                _queued_next[node] = true;
+                _next.push_back(node);
+            }
+        }
+
+        // the next pass examines every node
+        void touchAll()
+        {
+            _dirty_from = 0;
+            for (auto n : _next)
+                _queued_next[n] = false;
+            _next.clear();
+        }
+
+    private:
+        bool _active = false;
+        uint32_t _size = 0;
+        uint32_t _scan = 0;
+        int64_t _cursor = -1;
+        // every node from here on is a candidate
+        uint32_t _dirty_from = 0;
+        // min-heap of the touched nodes left in this pass
+        std::vector<uint32_t> _current;
+        std::vector<uint32_t> _next;
+        std::vector<bool> _queued_next;
+    };
+
     class Reducer {
     public:
         Reducer(PetriNetBuilder*);
@@ -140,6 +236,11 @@ namespace PetriEngine {
 
         void saveInitialNet();
 
+        // with incremental scans off, every rule examines the whole net on every pass
+        void setIncrementalScans(bool incremental) {
+            _incrementalScans = incremental;
+        }
+
     private:
         size_t _skippedPlaces= 0;
         std::vector<uint32_t> _skippedTransitions;
@@ -187,6 +288,32 @@ namespace PetriEngine {
         void skipInArc(uint32_t, uint32_t);
         void skipOutArc(uint32_t, uint32_t);
 
+        // the local rules only re-examine the neighbourhood of nodes whose arcs,
+        // inhibitor flag or initial marking changed; every change must touch the
+        // nodes at both ends of the arcs involved
+        void touchPlace(uint32_t);
+        void touchTransition(uint32_t);
+        void touchPlaceAndArcs(uint32_t);
+        void touchTransitionAndArcs(uint32_t);
+        // the next pass of every rule examines the whole net
+        void touchAll();
+        void beginPass(ReductionCandidates&, uint32_t size);
+        bool _incrementalScans = true;
+        ReductionCandidates _candidatesA;
+        ReductionCandidates _candidatesB;
+        ReductionCandidates _candidatesC;
+        ReductionCandidates _candidatesD;
+        ReductionCandidates _candidatesDEmpty;
+        ReductionCandidates _candidatesF;
+        ReductionCandidates _candidatesG;
+        ReductionCandidates _candidatesJ;
+        ReductionCandidates _candidatesL;
+        // the transition without arcs kept by rule D, if any
+        std::optional<uint32_t> _emptyTransition;
+        // counts the changes to the net; EFMNOP is only rerun when the net changed
+        size_t _changes = 0;
+        size_t _changesAtEFMNOP = 0;
+
         shared_const_string newTransName();
 
         bool consistent();
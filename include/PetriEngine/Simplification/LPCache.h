@@ -9,22 +9,49 @@
 #define LPFACTORY_H
 
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <glpk.h>
 #include "MurmurHash2.h"
 #include "Member.h"
 #include "Vector.h"
+#include "../PetriNet.h"
 
 
 namespace PetriEngine {
+    namespace PQL {
+        class SimplificationContext;
+    }
     namespace Simplification {
         class LinearProgram;
 
+        struct row_bounds_t
+        {
+            const Vector* row;
+            double lower;
+            double upper;
+
+            bool operator ==(const row_bounds_t& other) const
+            {
+                return row == other.row && lower == other.lower && upper == other.upper;
+            }
+        };
+
+        struct row_bounds_hash
+        {
+            size_t operator()(const std::vector<row_bounds_t>& rows) const
+            {
+                return MurmurHash64A(rows.data(), rows.size() * sizeof(row_bounds_t), 1337);
+            }
+        };
 
         class LPCache {
         public:
             LPCache();
             virtual ~LPCache();
+            LPCache(const LPCache&) = delete;
+            LPCache& operator=(const LPCache&) = delete;
             Vector* createAndCache(const std::vector<int64_t>& data)
             {
                 auto res = vectors.insert(Vector(data));
@@ -42,9 +69,41 @@ namespace PetriEngine {
             }
 
 
+            /**
+             * The state equation of the net from the marking of the context, set up
+             * for LinearProgram::isImpossible. It is built once and kept between
+             * queries and subformulas: the rows of a program are added after
+             * baseRows() and removed with restoreBase(), which keeps the basis of the
+             * last solve, so the next solve is warm-started from it.
+             * Returns nullptr if the state equation could not be built in time.
+             */
+            glp_prob* stateEquation(const PQL::SimplificationContext& context);
+
+            int baseRows() const { return _base_rows; }
+
+            void restoreBase();
+
+            /** The result of isImpossible for the rows, if it has been solved on this state equation */
+            const bool* impossible(const std::vector<row_bounds_t>& rows) const
+            {
+                auto it = _solved.find(rows);
+                return it == _solved.end() ? nullptr : &it->second;
+            }
+
+            void setImpossible(std::vector<row_bounds_t>&& rows, bool impossible)
+            {
+                _solved.emplace(std::move(rows), impossible);
+            }
+
         private:
             // unordered_map does not invalidate on insert, only erase
             std::unordered_set<Vector> vectors;
+
+            glp_prob* _state_equation = nullptr;
+            const PetriNet* _net = nullptr;
+            std::vector<MarkVal> _marking;
+            int _base_rows = 0;
+            std::unordered_map<std::vector<row_bounds_t>, bool, row_bounds_hash> _solved;
         };
 
     }
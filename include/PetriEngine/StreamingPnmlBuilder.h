@@ -0,0 +1,78 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMINGPNMLBUILDER_H
+#define STREAMINGPNMLBUILDER_H
+
+#include "AbstractPetriNetBuilder.h"
+#include "utils/structures/shared_string.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace PetriEngine {
+
+    /**
+     * Builder writing a P/T net as PNML while it is being built, in the format
+     * of PetriNet::toXML. Only the arcs of the latest transition are kept in
+     * memory, so arcs must be added right after their transition; arcs
+     * between the same place and transition are merged as in PetriNetBuilder.
+     * The ids of places and transitions are not checked for duplicates.
+     */
+    class StreamingPnmlBuilder final : public AbstractPetriNetBuilder {
+    public:
+        explicit StreamingPnmlBuilder(std::ostream& out);
+
+        void addPlace(const std::string& name, uint32_t tokens, double x, double y) override;
+        void addPlace(const shared_const_string& name, uint32_t tokens, double x, double y);
+        void addTransition(const std::string& name, int32_t player, double x, double y) override;
+        void addTransition(const shared_const_string& name, int32_t player, double x, double y);
+        void addInputArc(const std::string& place, const std::string& transition, bool inhibitor, uint32_t weight) override;
+        void addInputArc(const shared_const_string& place, const shared_const_string& transition, bool inhibitor, uint32_t weight);
+        void addOutputArc(const std::string& transition, const std::string& place, uint32_t weight) override;
+        void addOutputArc(const shared_const_string& transition, const shared_const_string& place, uint32_t weight);
+
+        // the PNML is written in the order the net is built
+        void sort() override {}
+
+        /** Write the pending arcs and close the net, nothing may be added afterwards */
+        void finish();
+
+        size_t numberOfPlaces() const { return _nplaces; }
+        size_t numberOfTransitions() const { return _ntransitions; }
+        size_t numberOfArcs() const { return _narcs; }
+
+    private:
+        struct arc_t {
+            shared_const_string _place;
+            uint32_t _weight;
+            bool _inhibitor;
+        };
+
+        void checkTransition(const shared_const_string& transition) const;
+        void flushArcs();
+
+        std::ostream& _out;
+        shared_const_string _transition;
+        std::vector<arc_t> _pre;
+        std::vector<arc_t> _post;
+        size_t _nplaces = 0;
+        size_t _ntransitions = 0;
+        size_t _narcs = 0;
+        bool _finished = false;
+    };
+}
+
+#endif /* STREAMINGPNMLBUILDER_H */
@@ -35,6 +35,19 @@ class AlignedEncoder
         unsigned char getType(uint32_t sum, uint32_t pwt, bool same, uint32_t val) const;
 
         size_t size(const uchar* data) const;
+
+        /**
+         * Computes the statistics needed by getType in a single pass; sum of
+         * tokens, largest token count, whether all marked places hold the same
+         * count, the number of marked places and the largest marked place.
+         * Uses AVX2 when the CPU supports it.
+         */
+        static void markingStats(const uint32_t* marking, uint32_t places, uint64_t& sum,
+                                 bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last);
+
+        /** Enables or disables the vectorized kernels (enabled if the CPU supports them) */
+        static void setVectorized(bool enable);
+        static bool vectorized();
     private:
         uint32_t tokenBytes(uint32_t ntokens) const;
 
@@ -0,0 +1,136 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef APPROXIMATESTATESET_H
+#define APPROXIMATESTATESET_H
+
+#include "StateSet.h"
+#include "PetriEngine/options.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * Probabilistic set of 64-bit hashes within a fixed memory budget.
+         *
+         * With hash compaction the full hash is stored as a fingerprint in an
+         * open addressing table; with bitstate hashing three bits derived from
+         * the hash are set in a bit table. Both may report an unseen hash as
+         * seen, so a search using the table may omit states. The expected
+         * number of omissions is accumulated on each insertion.
+         */
+        class FingerprintTable {
+        public:
+            FingerprintTable(StateStorage storage, size_t bytes);
+
+            static uint64_t hash(const unsigned char* data, size_t length);
+
+            /** Returns true if the hash was not (believed to be) seen before */
+            bool insert(uint64_t hash);
+
+            bool exists(uint64_t hash) const;
+
+            size_t size() const { return _size; }
+
+            size_t bytes() const { return _table.size() * sizeof(uint64_t); }
+
+            /** Number of new hashes rejected because the table was full */
+            size_t dropped() const { return _dropped; }
+
+            /** Estimated probability that at least one state was omitted */
+            double omissionProbability() const;
+
+            StateStorage storage() const { return _storage; }
+
+        private:
+            static constexpr size_t BITSTATE_HASHES = 3;
+
+            size_t bit(uint64_t hash, size_t n) const;
+
+            StateStorage _storage;
+            std::vector<uint64_t> _table;
+            size_t _bits = 0;
+            size_t _mask = 0;
+            size_t _size = 0;
+            size_t _setBits = 0;
+            size_t _dropped = 0;
+            double _expectedOmissions = 0;
+        };
+
+        /**
+         * Visited set for the reachability search storing fingerprints only.
+         *
+         * Markings waiting to be expanded are kept in full until they are
+         * decoded, so each id can be decoded exactly once; ids are reused
+         * afterwards. The frontier is not part of the memory budget.
+         */
+        class ApproximateStateSet : public EncodingStateSetInterface {
+        public:
+            ApproximateStateSet(const PetriNet& net, uint32_t kbound, StateStorage storage, size_t bytes, int nplaces = -1)
+            : EncodingStateSetInterface(net, kbound, nplaces), _store(storage, bytes) {}
+
+            std::pair<bool, size_t> add(const State& state) override
+            {
+                return _add(state, _store);
+            }
+
+            void decode(State& state, size_t id) override
+            {
+                _decode(state, id, _store);
+            }
+
+            std::pair<bool, size_t> lookup(State& state) override
+            {
+                return _lookup(state, _store);
+            }
+
+            void setHistory(size_t id, size_t transition) override {}
+
+            std::pair<size_t, size_t> getHistory(size_t markingid) override
+            {
+                throw base_error("Traces are not supported with approximate state storage");
+            }
+
+            size_t size() const override {
+                return _store._table.size();
+            }
+
+            const FingerprintTable& table() const {
+                return _store._table;
+            }
+
+        private:
+            // the trie-like interface expected by EncodingStateSetInterface
+            struct store_t {
+                store_t(StateStorage storage, size_t bytes) : _table(storage, bytes) {}
+
+                std::pair<bool, size_t> insert(const unsigned char* data, size_t length);
+                std::pair<bool, size_t> exists(const unsigned char* data, size_t length) const;
+                void unpack(size_t id, unsigned char* destination);
+
+                FingerprintTable _table;
+                std::vector<std::vector<unsigned char>> _pending;
+                std::vector<size_t> _free;
+            };
+
+            store_t _store;
+        };
+    }
+}
+
+#endif // APPROXIMATESTATESET_H
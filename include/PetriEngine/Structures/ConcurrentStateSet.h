@@ -0,0 +1,271 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ * Copyright (C) 2016  Peter Gjøl Jensen <root@petergjoel.dk>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CONCURRENTSTATESET_H
+#define CONCURRENTSTATESET_H
+
+#include "StateSet.h"
+#include "utils/errors.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * State set shared between the workers of a multi-threaded search.
+         * All operations taking a worker index may be called concurrently as
+         * long as each worker uses its own index.
+         *
+         * Markings are encoded with a per-worker AlignedEncoder and stored in
+         * one of several independently locked ptrie shards, chosen by a hash of
+         * the encoding. Ids are stable and interleave the shards
+         * (local id * shards + shard); the first marking added always gets id 0
+         * so traces can be unwound as for the sequential sets.
+         *
+         * Statistics are collected per worker and only folded into the
+         * StateSetInterface counters by syncStatistics(), which must not be
+         * called concurrently with itself.
+         */
+        class ConcurrentStateSet : public EncodingStateSetInterface {
+        private:
+            using ptrie_t = ptrie::set_stable<ptrie::uchar,size_t,17,128,4>;
+
+            struct alignas(64) shard_t {
+                std::mutex _lock;
+                ptrie_t _trie;
+                std::vector<traceable_t> _history;
+            };
+
+            struct alignas(64) worker_t {
+                std::unique_ptr<AlignedEncoder> _encoder;
+                std::atomic<size_t> _discovered{0};
+                std::atomic<uint32_t> _maxTokens{0};
+                std::unique_ptr<std::atomic<uint32_t>[]> _maxPlaceBound;
+            };
+
+            static size_t shardCount(size_t workers)
+            {
+                // a few shards per worker keeps the chance of two workers meeting on a lock low
+                if(workers <= 1) return 1;
+                size_t n = 1;
+                while(n < workers * 4) n <<= 1;
+                return n;
+            }
+
+        public:
+            ConcurrentStateSet(const PetriNet& net, uint32_t kbound, size_t workers, bool tracable, int nplaces = -1)
+            : EncodingStateSetInterface(net, kbound, nplaces), _nshards(shardCount(workers)),
+              _shards(std::make_unique<shard_t[]>(_nshards)), _workers(std::max<size_t>(workers, 1)), _tracable(tracable)
+            {
+                for(auto& w : _workers)
+                {
+                    w._encoder = std::make_unique<AlignedEncoder>(_nplaces, kbound);
+                    w._maxPlaceBound = std::make_unique<std::atomic<uint32_t>[]>(net.numberOfPlaces());
+                    for(size_t p = 0; p < net.numberOfPlaces(); ++p)
+                        w._maxPlaceBound[p] = 0;
+                }
+            }
+
+            std::pair<bool, size_t> add(const State& state) override
+            {
+                return add(state, 0);
+            }
+
+            std::pair<bool, size_t> add(const State& state, size_t worker)
+            {
+                auto& w = _workers[worker];
+                // only the owning worker writes its statistics, so relaxed load/store suffices
+                w._discovered.store(w._discovered.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+                MarkVal sum = 0;
+                bool allsame = true;
+                uint32_t val = 0;
+                uint32_t active = 0;
+                uint32_t last = 0;
+                markingStats(state.marking(), sum, allsame, val, active, last);
+
+                if (w._maxTokens.load(std::memory_order_relaxed) < sum)
+                    w._maxTokens.store(sum, std::memory_order_relaxed);
+
+                //Check that we're within k-bound
+                if (_kbound != 0 && sum > _kbound)
+                    return std::pair<bool, size_t>(false, std::numeric_limits<size_t>::max());
+
+                auto& encoder = *w._encoder;
+                unsigned char type = encoder.getType(sum, active, allsame, val);
+                size_t length = encoder.encode(state.marking(), type);
+                if(length*8 >= std::numeric_limits<uint16_t>::max())
+                {
+                    throw base_error("Marking could not be encoded into less than 2^16 bytes, current limit of PTries");
+                }
+                binarywrapper_t bw = binarywrapper_t(encoder.scratchpad().raw(), length*8);
+                size_t h = hashOf(bw.raw(), length);
+                // rotate the shards such that the first marking added ends up with id 0
+                std::call_once(_first, [&]{ _rotation.store(h % _nshards, std::memory_order_release); });
+                size_t s = shardOf(h);
+                auto& shard = _shards[s];
+
+                size_t id;
+                {
+                    std::lock_guard<std::mutex> guard(shard._lock);
+                    auto tit = shard._trie.insert(bw.raw(), bw.size());
+                    if(!tit.first)
+                        return std::pair<bool, size_t>(false, tit.second * _nshards + s);
+                    if(_tracable)
+                        shard._history.emplace_back();
+                    id = tit.second * _nshards + s;
+                }
+
+                // update the max token bound for each place in the net (only for newly discovered markings)
+                for (uint32_t i = 0; i < _net.numberOfPlaces(); i++)
+                {
+                    if(w._maxPlaceBound[i].load(std::memory_order_relaxed) < state.marking()[i])
+                        w._maxPlaceBound[i].store(state.marking()[i], std::memory_order_relaxed);
+                }
+                return std::pair<bool, size_t>(true, id);
+            }
+
+            void decode(State& state, size_t id) override
+            {
+                decode(state, id, 0);
+            }
+
+            void decode(State& state, size_t id, size_t worker)
+            {
+                auto& encoder = *_workers[worker]._encoder;
+                auto& shard = _shards[id % _nshards];
+                {
+                    std::lock_guard<std::mutex> guard(shard._lock);
+                    shard._trie.unpack(id / _nshards, encoder.scratchpad().raw());
+                }
+                encoder.decode(state.marking(), encoder.scratchpad().raw());
+            }
+
+            std::pair<bool, size_t> lookup(State& state) override
+            {
+                return lookup(state, 0);
+            }
+
+            std::pair<bool, size_t> lookup(State& state, size_t worker)
+            {
+                MarkVal sum = 0;
+                bool allsame = true;
+                uint32_t val = 0;
+                uint32_t active = 0;
+                uint32_t last = 0;
+                markingStats(state.marking(), sum, allsame, val, active, last);
+
+                auto& encoder = *_workers[worker]._encoder;
+                unsigned char type = encoder.getType(sum, active, allsame, val);
+                size_t length = encoder.encode(state.marking(), type);
+                binarywrapper_t bw = binarywrapper_t(encoder.scratchpad().raw(), length*8);
+                size_t s = shardOf(hashOf(bw.raw(), length));
+                auto& shard = _shards[s];
+                std::lock_guard<std::mutex> guard(shard._lock);
+                auto tit = shard._trie.exists(bw.raw(), bw.size());
+                if (tit.first)
+                    return std::pair<bool, size_t>(true, tit.second * _nshards + s);
+                return std::pair<bool, size_t>(false, std::numeric_limits<size_t>::max());
+            }
+
+            void setHistory(size_t id, size_t transition) override
+            {
+                // the parent is not implicit when several workers decode concurrently
+                throw base_error("ConcurrentStateSet::setHistory requires the parent of the marking");
+            }
+
+            void setHistory(size_t id, size_t parent, size_t transition)
+            {
+                if(!_tracable) return;
+                auto& shard = _shards[id % _nshards];
+                std::lock_guard<std::mutex> guard(shard._lock);
+                auto& t = shard._history[id / _nshards];
+                t.parent = parent;
+                t.transition = transition;
+            }
+
+            std::pair<size_t, size_t> getHistory(size_t markingid) override
+            {
+                assert(_tracable);
+                auto& shard = _shards[markingid % _nshards];
+                std::lock_guard<std::mutex> guard(shard._lock);
+                auto& t = shard._history[markingid / _nshards];
+                return std::pair<size_t, size_t>(t.parent, t.transition);
+            }
+
+            size_t size() const override {
+                size_t n = 0;
+                for(size_t s = 0; s < _nshards; ++s)
+                {
+                    std::lock_guard<std::mutex> guard(_shards[s]._lock);
+                    n += _shards[s]._trie.size();
+                }
+                return n;
+            }
+
+            size_t workers() const {
+                return _workers.size();
+            }
+
+            size_t shards() const {
+                return _nshards;
+            }
+
+            /**
+             * Folds the per-worker statistics into discovered(), maxTokens()
+             * and maxPlaceBound(). Values are exact once all workers are done.
+             */
+            void syncStatistics()
+            {
+                _discovered = 0;
+                for(auto& w : _workers)
+                {
+                    _discovered += w._discovered.load(std::memory_order_relaxed);
+                    _maxTokens = std::max(_maxTokens, w._maxTokens.load(std::memory_order_relaxed));
+                    for(size_t p = 0; p < _net.numberOfPlaces(); ++p)
+                        _maxPlaceBound[p] = std::max(_maxPlaceBound[p], w._maxPlaceBound[p].load(std::memory_order_relaxed));
+                }
+            }
+
+        private:
+            size_t hashOf(const unsigned char* data, size_t length) const
+            {
+                if(_nshards == 1) return 0;
+                return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(data), length));
+            }
+
+            // the rotation is fixed by the first add; before that the set is empty and any shard will do
+            size_t shardOf(size_t h) const
+            {
+                return (h + _nshards - _rotation.load(std::memory_order_acquire)) % _nshards;
+            }
+
+            size_t _nshards;
+            std::unique_ptr<shard_t[]> _shards;
+            std::vector<worker_t> _workers;
+            std::once_flag _first;
+            std::atomic<size_t> _rotation{0};
+            bool _tracable;
+        };
+    }
+}
+
+#endif // CONCURRENTSTATESET_H
@@ -0,0 +1,111 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef EXTERNALSTATESET_H
+#define EXTERNALSTATESET_H
+
+#include "StateSet.h"
+#include "AlignedEncoder.h"
+#include "State.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * Visited set and frontier of a layered breadth-first search kept on disk.
+         *
+         * Successors are encoded with the AlignedEncoder and collected in a bounded
+         * buffer which is sorted and written as a run whenever it fills up. When a
+         * layer is exhausted the runs are merged and the visited markings are
+         * subtracted (delayed duplicate detection); what remains is the next layer.
+         * The visited set is kept as sorted runs, one per completed layer, which are
+         * merged lazily such that their sizes decrease geometrically; a marking is
+         * thus rewritten a logarithmic number of times. Only the buffer and a
+         * bounded cache of recently seen markings are kept in memory.
+         *
+         * Markings are not given ids, so traces cannot be reconstructed.
+         */
+        class ExternalStateSet : public StateSetInterface {
+        public:
+            ExternalStateSet(const PetriNet& net, uint32_t kbound, const std::string& directory, size_t memory);
+            ~ExternalStateSet() override;
+
+            /**
+             * Adds a marking to the next layer. Returns false if the marking
+             * violates the k-bound or is known to be visited already; a true
+             * result does not mean the marking is new, that is only known once
+             * it is read back by next().
+             */
+            bool add(const State& state);
+
+            /**
+             * Reads the next marking of the current layer into state, moving on
+             * to the next layer when the current one is exhausted. Returns false
+             * when no new markings remain.
+             */
+            bool next(State& state);
+
+            /** The number of markings in the completed layers */
+            size_t size() const override { return _visitedCount; }
+
+            size_t layers() const { return _layers; }
+
+            /** The number of sorted runs the visited markings are kept in */
+            size_t visitedRuns() const { return _visited.size(); }
+
+            std::pair<size_t, size_t> getHistory(size_t) override;
+
+        private:
+            using path_t = std::filesystem::path;
+
+            struct run_t {
+                path_t file;
+                size_t records;
+            };
+
+            bool nextLayer();
+            void addVisited(path_t file, size_t records);
+            void flush();
+            path_t merge(std::vector<path_t> runs);
+            path_t mergeAll(std::vector<path_t> runs);
+            path_t newFile();
+
+            AlignedEncoder _encoder;
+            path_t _directory;
+            size_t _fileCounter = 0;
+            size_t _bufferLimit;
+            size_t _bufferBytes = 0;
+            std::vector<std::string> _buffer;
+            std::vector<path_t> _runs;
+            std::unique_ptr<ptrie::set<ptrie::uchar>> _cache;
+            size_t _cacheLimit;
+            std::vector<run_t> _visited;
+            path_t _layer;
+            size_t _layerRecords = 0;
+            std::ifstream _layerIn;
+            std::string _record;
+            size_t _visitedCount = 0;
+            size_t _layers = 0;
+        };
+    }
+}
+
+#endif // EXTERNALSTATESET_H
@@ -0,0 +1,88 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MARKINGBATCH_H
+#define MARKINGBATCH_H
+
+#include "../PetriNet.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        /**
+         * A batch of markings, e.g. the new successors of one expansion.
+         * Every marking is kept as a row, as the rest of the engine reads it,
+         * and transposed into one column per place holding the tokens of that
+         * place in every marking of the batch, so kernels can process a place
+         * for the whole batch in one contiguous loop.
+         */
+        class MarkingBatch {
+        public:
+            explicit MarkingBatch(uint32_t places, uint32_t capacity = 16)
+            : _places(places), _capacity(std::max<uint32_t>(capacity, 1)),
+              _rows(size_t(_places) * _capacity), _columns(size_t(_places) * _capacity) {}
+
+            /** Adds a copy of the marking and returns its position in the batch */
+            uint32_t push(const MarkVal* marking)
+            {
+                if (_size == _capacity)
+                    grow();
+                const uint32_t lane = _size++;
+                std::copy(marking, marking + _places, _rows.data() + size_t(lane) * _places);
+                for (uint32_t p = 0; p < _places; ++p)
+                    _columns[size_t(p) * _capacity + lane] = marking[p];
+                return lane;
+            }
+
+            void clear() { _size = 0; }
+
+            uint32_t size() const { return _size; }
+            bool empty() const { return _size == 0; }
+            uint32_t places() const { return _places; }
+
+            const MarkVal* marking(uint32_t lane) const {
+                return _rows.data() + size_t(lane) * _places;
+            }
+
+            /** The tokens of the place in the markings of the batch, in order */
+            const MarkVal* column(uint32_t place) const {
+                return _columns.data() + size_t(place) * _capacity;
+            }
+
+        private:
+            void grow()
+            {
+                const uint32_t capacity = _capacity * 2;
+                std::vector<MarkVal> columns(size_t(_places) * capacity);
+                for (uint32_t p = 0; p < _places; ++p)
+                    std::copy(column(p), column(p) + _size, columns.data() + size_t(p) * capacity);
+                _columns.swap(columns);
+                _rows.resize(size_t(_places) * capacity);
+                _capacity = capacity;
+            }
+
+            uint32_t _places;
+            uint32_t _capacity;
+            uint32_t _size = 0;
+            std::vector<MarkVal> _rows;
+            std::vector<MarkVal> _columns;
+        };
+    }
+}
+
+#endif /* MARKINGBATCH_H */
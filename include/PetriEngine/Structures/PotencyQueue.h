@@ -34,6 +34,9 @@ namespace PetriEngine {
 
             void push(size_t id, PQL::DistanceContext *context, const PQL::Condition *query);
 
+            // with the distance of the marking already computed, after a push with a context
+            void push(size_t id, uint32_t distance);
+
             virtual void push(size_t id, PQL::DistanceContext *context, const PQL::Condition *query, uint32_t t) = 0;
 
         protected:
@@ -62,6 +65,8 @@ namespace PetriEngine {
 
             void push(size_t id, PQL::DistanceContext *context, const PQL::Condition *query, uint32_t t) override;
 
+            void push(size_t id, uint32_t distance, uint32_t t);
+
             size_t pop();
 
         private:
@@ -98,6 +98,8 @@ namespace PetriEngine {
             virtual size_t pop();
             virtual void push(size_t id, PQL::DistanceContext*,
                 const PQL::Condition* query);
+            // with the distance of the marking already computed
+            void push(size_t id, uint32_t distance);
             virtual bool empty() const override;
         private:
             std::priority_queue<weighted_t> _queue;
@@ -114,8 +114,13 @@ namespace PetriEngine {
              * @param t the transition
             */
             bool computeCandidate(const MarkVal* candidate, const PQL::Condition *query, uint32_t t) {
-                ++_discovered;
                 PQL::DistanceContext context(&_net, candidate);
+                return computeCandidate(candidate, query->distance(context), t);
+            }
+
+            /** As above, with the distance of the candidate to the query already computed */
+            bool computeCandidate(const MarkVal* candidate, uint32_t dist, uint32_t t) {
+                ++_discovered;
 
                 uint32_t sumMarking = _sumMarking(candidate);
                 if (_maxTokens < sumMarking) {
@@ -131,7 +136,6 @@ namespace PetriEngine {
                 }
 
                 // Update the potency of the transition
-                uint32_t dist = query->distance(context);
                 if (dist < _currentStepDistance) {
                     _potencies[t] += _currentStepDistance - dist;
                 } else {
@@ -426,21 +430,9 @@ namespace PetriEngine {
 
             void markingStats(const uint32_t* marking, MarkVal& sum, bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last)
             {
-                uint32_t cnt = 0;
-
-                for (uint32_t i = 0; i < _nplaces; i++)
-                {
-                    uint32_t old = val;
-                    if(marking[i] != 0)
-                    {
-                        ++cnt;
-                        last = std::max(last, i);
-                        val = std::max(marking[i], val);
-                        if(old != 0 && marking[i] != old) allsame = false;
-                        ++active;
-                        sum += marking[i];
-                    }
-                }
+                uint64_t total;
+                AlignedEncoder::markingStats(marking, _nplaces, total, allsame, val, active, last);
+                sum += total;
             }
         };
 
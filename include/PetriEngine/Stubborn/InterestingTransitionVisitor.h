@@ -18,6 +18,7 @@
 #ifndef VERIFYPN_INTERESTINGTRANSITIONVISITOR_H
 #define VERIFYPN_INTERESTINGTRANSITIONVISITOR_H
 
+#include "PetriEngine/PQL/QueryProgram.h"
 #include "PetriEngine/PQL/Visitor.h"
 #include "PetriEngine/Stubborn/StubbornSet.h"
 #include "utils/errors.h"
@@ -36,9 +37,37 @@ namespace PetriEngine {
 
         bool get_negated() const { return negated; }
 
+        /**
+         * Read the values of the query from the scratch of a compiled program
+         * instead of the values evaluateAndSet leaves in the query tree.
+         */
+        void set_evaluation(const PQL::QueryProgram* program, const PQL::QueryProgram::scratch_t* scratch)
+        {
+            _program = program;
+            _scratch = scratch;
+        }
+
     protected:
         PetriEngine::StubbornSet &_stubborn;
 
+        PQL::Condition::Result result(const PQL::Condition* element) const
+        {
+            return _program ? _program->result(element, *_scratch) : element->getSatisfied();
+        }
+
+        bool satisfied(const PQL::Condition* element) const
+        {
+            return result(element) == PQL::Condition::RTRUE;
+        }
+
+        int64_t value(const PQL::Expr_ptr& element) const
+        {
+            return _program ? _program->value(element.get(), *_scratch) : element->getEval();
+        }
+
+        const PQL::QueryProgram* _program = nullptr;
+        const PQL::QueryProgram::scratch_t* _scratch = nullptr;
+
         bool closure;
 
         void _accept(const PQL::NotCondition *element) override;
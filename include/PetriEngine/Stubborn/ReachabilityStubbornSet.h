@@ -21,6 +21,10 @@
 
 #include "PetriEngine/Stubborn/StubbornSet.h"
 #include "InterestingTransitionVisitor.h"
+#include "PetriEngine/PQL/QueryProgram.h"
+
+#include <memory>
+#include <mutex>
 
 namespace PetriEngine {
     class ReachabilityStubbornSet : public StubbornSet {
@@ -28,6 +32,7 @@ namespace PetriEngine {
         ReachabilityStubbornSet(const PetriNet &net, const std::vector<PQL::Condition_ptr> &queries, bool closure = true)
                 : StubbornSet(net, queries), _closure(closure) {
             setInterestingVisitor<InterestingTransitionVisitor>();
+            setProgram(std::make_shared<const PQL::QueryProgram>(queries));
         }
 
         ReachabilityStubbornSet(const PetriNet &net, bool closure = true)
@@ -43,10 +48,30 @@ namespace PetriEngine {
             _interesting = std::make_unique<TVisitor>(*this, _closure);
         }
 
+        /**
+         * Queries found in the program are evaluated by it, into a scratch
+         * area owned by this stubborn set. Other queries are analysed with
+         * evaluateAndSet, which annotates the query trees.
+         */
+        void setProgram(std::shared_ptr<const PQL::QueryProgram> program)
+        {
+            _program = std::move(program);
+            _scratch = _program ? _program->make_scratch() : PQL::QueryProgram::scratch_t{};
+        }
+
+        /**
+         * Stubborn sets sharing queries across threads must serialize the
+         * analysis of queries that are not thread-safe compiled programs.
+         */
+        void setQueryLock(std::mutex* lock) { _queryLock = lock; }
+
     private:
         std::unique_ptr<InterestingTransitionVisitor> _interesting;
 
         bool _closure;
+        std::mutex* _queryLock = nullptr;
+        std::shared_ptr<const PQL::QueryProgram> _program;
+        PQL::QueryProgram::scratch_t _scratch;
     };
 }
 
@@ -27,6 +27,9 @@
 #include "PetriEngine/Reachability/ReachabilitySearch.h"
 #include "PetriEngine/options.h"
 
+#include <functional>
+#include <mutex>
+
 namespace PetriEngine {
     namespace Reachability {
         class Solver;
@@ -50,7 +53,14 @@ namespace PetriEngine {
                 std::vector<std::shared_ptr<PQL::Condition > >& queries,
                 std::vector<ResultPrinter::Result>& results,
                 StatisticsLevel statisticsLevel, bool printtrace);
+
+            /** Lock taken while the solver evaluates a query in place, needed when the queries are shared between threads */
+            void setQueryLock(std::mutex* lock) { _queryLock = lock; }
+
+            /** Polled with the index of the current query; the query is given up once it returns true */
+            void setCancellation(std::function<bool(size_t)> cancelled) { _cancelled = std::move(cancelled); }
         private:
+            bool cancelled() const { return _cancelled && _cancelled(_query); }
 
             void printTrace(trace_t& stack);
             void nextEdge(AntiChain<uint32_t, size_t>& checked, state_t& state, trace_t& waiting, std::set<size_t>& nextinter);
@@ -73,6 +83,9 @@ namespace PetriEngine {
             PetriNet& _net;
             Reducer* _reducer;
             TraceSet _traceset;
+            std::mutex* _queryLock = nullptr;
+            std::function<bool(size_t)> _cancelled;
+            size_t _query = 0;
 
 #ifdef TAR_TIMING
             double _check_time = 0;
@@ -22,9 +22,16 @@ enum class Strategy {
     OverApprox,
     RPFS,
     RandomWalk,
+    ExternalBFS,
     DEFAULT
 };
 
+enum class StateStorage {
+    Exact,
+    HashCompaction,
+    Bitstate
+};
+
 enum class ColoredSuccessorGeneratorOption {
     FIXED,
     EVEN
@@ -57,6 +64,7 @@ struct options_t {
     std::vector<uint32_t> colreductions{};
     int reductionTimeout = 60;
     int colReductionTimeout = 30;
+    bool queryGroupReduction = false; // reduce and verify a net per group of reachability queries
     bool stubbornreduction = true;
     bool statespaceexploration = false;
     StatisticsLevel printstatistics = StatisticsLevel::Full;
@@ -68,8 +76,10 @@ struct options_t {
     uint32_t siphontrapTimeout = 0;
     uint32_t siphonDepth = 0;
     uint32_t cores = 1;
+    std::vector<std::string> portfolio;
     bool doVerification = true;
     bool doUnfolding = true;
+    bool unfoldOnly = false;
     int64_t depthRandomWalk = 50000;
     int64_t incRandomWalk = 5000;
 
@@ -118,6 +128,13 @@ struct options_t {
 
     bool explicit_colored = false;
     ColoredSuccessorGeneratorOption colored_sucessor_generator = ColoredSuccessorGeneratorOption::EVEN;
+    bool colored_compact_waiting = false;
+
+    std::string external_dir;
+    size_t external_memory = 1024;
+
+    StateStorage state_storage = StateStorage::Exact;
+    size_t memory_budget = 1024;
 
     std::string strategy_output;
 
@@ -117,7 +117,8 @@ unfold(ColoredPetriNetBuilder& cpnBuilder, bool compute_partiton,
        bool compute_symmetry, bool computed_fixed_point,
        std::ostream& out = std::cout, int32_t partitionTimeout = 0,
        int32_t max_intervals = 0, int32_t intervals_reduced = 0,
-       int32_t interval_timeout = 0, bool over_approx = false, bool print_bindings = false);
+       int32_t interval_timeout = 0, bool over_approx = false, bool print_bindings = false,
+       uint32_t threads = 1);
 
 ReturnValue contextAnalysis(bool colored, const shared_name_name_map& transition_names,
                             const shared_place_color_map& place_names,
@@ -145,6 +146,14 @@ Condition_ptr simplify_ltl_query(Condition_ptr query, options_t options,
 
 void outputNet(const PetriNetBuilder &builder, std::string out_file);
 
+// Unfolds the net directly into out_file without keeping the unfolded net
+void outputUnfoldedNet(ColoredPetriNetBuilder& cpnBuilder, std::string out_file,
+       bool compute_partiton, bool compute_symmetry, bool computed_fixed_point,
+       std::ostream& out = std::cout, int32_t partitionTimeout = 0,
+       int32_t max_intervals = 0, int32_t intervals_reduced = 0,
+       int32_t interval_timeout = 0, bool over_approx = false, bool print_bindings = false,
+       uint32_t threads = 1);
+
 void outputQueries(const PetriNetBuilder &builder,
                    const std::vector<PetriEngine::PQL::Condition_ptr> &queries,
                    std::vector<std::string> &querynames, std::string filename,
@@ -164,6 +173,21 @@ void initialize_potency(const MarkVal* marking, const PetriNet* net,
                         options_t& options, std::ostream& outstream,
                         std::vector<uint32_t> &potencies);
 
+// Reduces a copy of the builder for each group of queries, with up to options.cores groups at a time,
+// splitting options.reductionTimeout over the rounds of groups
+std::vector<std::unique_ptr<PetriNetBuilder>>
+reduceQueryGroups(const PetriNetBuilder& builder, const std::vector<std::vector<size_t>>& groups,
+                  std::vector<Condition_ptr>& queries,
+                  const std::vector<ResultPrinter::Result>& results,
+                  options_t& options);
+
+// Reduces the net for every group of queries and verifies each group on its own net. Results are
+// reported to printer and stored in results under the original query indexes.
+void verifyQueryGroups(const PetriNetBuilder& builder, const std::vector<std::vector<size_t>>& groups,
+                       std::vector<Condition_ptr>& queries, std::vector<ResultPrinter::Result>& results,
+                       bool colored, const shared_name_name_map& transition_names, const shared_place_color_map& place_names,
+                       AbstractHandler& printer, options_t& options);
+
 std::vector<Condition_ptr>
 parseXMLQueries(shared_string_set& string_set, std::vector<std::string>& qstrings,
                 std::istream& qfile, const std::set<size_t>& qnums, bool binary = false);
@@ -72,35 +72,23 @@ void Algorithm::CertainZeroFPA::checkEdge(Edge* e, bool only_assign)
     bool hasCZero = false;
     //auto pre_empty = e->targets.empty();
     Configuration *lastUndecided = nullptr;
+    for(auto t : e->targets)
     {
-        auto it = e->targets.begin();
-        auto pit = e->targets.before_begin();
-        while(it != e->targets.end())
+        // targets are linked into dependency sets, so assigned ones are skipped rather than erased
+        if (t->assignment == ONE) continue;
+        allOne = false;
+        if (t->assignment == CZERO) {
+            hasCZero = true;
+            //assert(e->assignment == CZERO || only_assign);
+            break;
+        }
+        else if(lastUndecided == nullptr)
         {
-            if ((*it)->assignment == ONE)
-            {
-                e->targets.erase_after(pit);
-                it = pit;
-            }
-            else
-            {
-                allOne = false;
-                if ((*it)->assignment == CZERO) {
-                    hasCZero = true;
-                    //assert(e->assignment == CZERO || only_assign);
-                    break;
-                }
-                else if(lastUndecided == nullptr)
-                {
-                    lastUndecided = *it;
-                }
-                else if(lastUndecided != nullptr && lastUndecided->assignment == UNKNOWN && (*it)->assignment == ZERO)
-                {
-                    lastUndecided = *it;
-                }
-            }
-            pit = it;
-            ++it;
+            lastUndecided = t;
+        }
+        else if(lastUndecided != nullptr && lastUndecided->assignment == UNKNOWN && t->assignment == ZERO)
+        {
+            lastUndecided = t;
         }
     }
     /*if(e->targets.empty())
@@ -158,8 +146,8 @@ void Algorithm::CertainZeroFPA::checkEdge(Edge* e, bool only_assign)
             if(!e->processed) {
                 if(!lastUndecided->isDone())
                 {
-                    for (auto t : e->targets)
-                        t->addDependency(e);
+                    for (auto it = e->targets.begin(); it != e->targets.end(); ++it)
+                        (*it)->addDependency(it.slot());
                 }
             }
             if (lastUndecided->assignment == UNKNOWN) {
@@ -217,7 +205,8 @@ void Algorithm::CertainZeroFPA::explore(Configuration *c)
     c->assignment = ZERO;
 
     {
-        auto succs = graph->successors(c);
+        auto& succs = _succs;
+        graph->successors(c, succs);
         c->nsuccs = succs.size();
 
         _exploredConfigurations += 1;
@@ -95,7 +95,8 @@ void Algorithm::LocalFPA::explore(DependencyGraph::Configuration *c)
 {
     assert(c->assignment == DependencyGraph::UNKNOWN);
     c->assignment = DependencyGraph::ZERO;
-    auto succs = graph->successors(c);
+    auto& succs = _succs;
+    graph->successors(c, succs);
 
     for (DependencyGraph::Edge *succ : succs) {
         strategy->pushEdge(succ);
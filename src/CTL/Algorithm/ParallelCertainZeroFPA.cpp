@@ -0,0 +1,312 @@
+#include "CTL/Algorithm/ParallelCertainZeroFPA.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+using namespace DependencyGraph;
+
+Algorithm::ParallelCertainZeroFPA::ParallelCertainZeroFPA(Strategy type, uint32_t threads)
+: FixedPointAlgorithm(type), _threads(std::max<uint32_t>(threads, 1)), _fifo(type == Strategy::BFS)
+{
+}
+
+bool Algorithm::ParallelCertainZeroFPA::search(DependencyGraph::BasicDependencyGraph &t_graph)
+{
+    graph = &t_graph;
+    graph->setWorkers(_threads);
+    vertex = graph->initialConfiguration();
+
+    _workers.clear();
+    for(size_t w = 0; w < _threads; ++w)
+        _workers.emplace_back(std::make_unique<worker_t>(w));
+    _negations.clear();
+    _pending = 0;
+    _stop = false;
+    _error = nullptr;
+
+    explore(*_workers[0], vertex);
+    if(!vertex->isDone())
+    {
+        std::vector<std::thread> threads;
+        for(size_t w = 1; w < _threads; ++w)
+            threads.emplace_back([this, w] { run(*_workers[w]); });
+        run(*_workers[0]);
+        for(auto& t : threads)
+            t.join();
+    }
+    if(_error)
+        std::rethrow_exception(_error);
+
+    for(auto& w : _workers)
+    {
+        _processedEdges += w->processedEdges;
+        _processedNegationEdges += w->processedNegationEdges;
+        _exploredConfigurations += w->exploredConfigurations;
+        _numberOfEdges += w->numberOfEdges;
+    }
+    return vertex->assignment == ONE;
+}
+
+void Algorithm::ParallelCertainZeroFPA::run(worker_t& worker)
+{
+    try
+    {
+        while(!_stop)
+        {
+            auto e = pop(worker);
+            if(e == nullptr)
+            {
+                // edges that are still being checked may push new ones
+                if(_pending.load() == 0)
+                    releaseNegationEdges(worker);
+                else
+                    std::this_thread::yield();
+                continue;
+            }
+            checkEdge(worker, e);
+            --_pending;
+        }
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> guard(_errorLock);
+        if(!_error)
+            _error = std::current_exception();
+        _stop = true;
+    }
+}
+
+void Algorithm::ParallelCertainZeroFPA::push(worker_t& worker, Edge* e)
+{
+    if(e->source->isDone()) return;
+    ++_pending;
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.queue.push_back(e);
+}
+
+Edge* Algorithm::ParallelCertainZeroFPA::pop(worker_t& worker)
+{
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if(!worker.queue.empty())
+        {
+            Edge* e;
+            if(_fifo)
+            {
+                e = worker.queue.front();
+                worker.queue.pop_front();
+            }
+            else
+            {
+                e = worker.queue.back();
+                worker.queue.pop_back();
+            }
+            return e;
+        }
+    }
+    // steal the oldest edge of another worker, but never wait for a busy queue
+    for(size_t n = 1; n < _workers.size(); ++n)
+    {
+        auto& other = *_workers[(worker.id + n) % _workers.size()];
+        std::unique_lock<std::mutex> guard(other.lock, std::try_to_lock);
+        if(!guard.owns_lock() || other.queue.empty())
+            continue;
+        auto e = other.queue.front();
+        other.queue.pop_front();
+        return e;
+    }
+    return nullptr;
+}
+
+void Algorithm::ParallelCertainZeroFPA::releaseNegationEdges(worker_t& worker)
+{
+    std::unique_lock<std::mutex> guard(_negationLock, std::try_to_lock);
+    // another worker is releasing, or found work meanwhile
+    if(!guard.owns_lock() || _pending.load() != 0 || _stop)
+    {
+        std::this_thread::yield();
+        return;
+    }
+
+    // negation edges whose target got assigned are checked as usual
+    bool trivial = false;
+    uint32_t dist = 0;
+    for(size_t i = 0; i < _negations.size();)
+    {
+        auto e = _negations[i];
+        if(e->source->isDone() || e->targets.front()->isDone())
+        {
+            if(!e->source->isDone())
+            {
+                push(worker, e);
+                trivial = true;
+            }
+            _negations[i] = _negations.back();
+            _negations.pop_back();
+            continue;
+        }
+        dist = std::max(dist, e->source->getDistance());
+        ++i;
+    }
+    if(trivial) return;
+    if(_negations.empty())
+    {
+        // fixed point reached
+        _stop = true;
+        return;
+    }
+
+    // every worker is idle, so the targets that are still undecided are zero
+    std::vector<Edge*> released;
+    for(size_t i = 0; i < _negations.size();)
+    {
+        if(_negations[i]->source->getDistance() >= dist)
+        {
+            released.push_back(_negations[i]);
+            _negations[i] = _negations.back();
+            _negations.pop_back();
+        }
+        else ++i;
+    }
+    for(auto e : released)
+    {
+        ++worker.processedNegationEdges;
+        if(e->targets.front()->isDone())
+            push(worker, e);
+        else
+            finalAssign(worker, e->source, ONE);
+    }
+}
+
+void Algorithm::ParallelCertainZeroFPA::checkEdge(worker_t& worker, Edge* e, bool only_assign)
+{
+    if(e->handled) return;
+    if(e->source->isDone()) return;
+
+    // the targets are read-only once the edge is published
+    bool allOne = true;
+    bool hasCZero = false;
+    Configuration *lastUndecided = nullptr;
+    for(auto t : e->targets)
+    {
+        auto a = t->assignment.load();
+        if(a == ONE) continue;
+        allOne = false;
+        if(a == CZERO)
+        {
+            hasCZero = true;
+            break;
+        }
+        if(lastUndecided == nullptr || (a == ZERO && lastUndecided->assignment == UNKNOWN))
+            lastUndecided = t;
+    }
+
+    if(e->is_negated)
+    {
+        ++worker.processedNegationEdges;
+        if(allOne)
+            killEdge(worker, e);
+        else if(hasCZero)
+            finalAssign(worker, e->source, ONE);
+        else
+        {
+            assert(lastUndecided != nullptr);
+            if(only_assign) return;
+            if(!e->processed.exchange(true))
+            {
+                if(!lastUndecided->pushDependency(e))
+                {
+                    // assigned meanwhile
+                    push(worker, e);
+                    return;
+                }
+                std::lock_guard<std::mutex> guard(_negationLock);
+                _negations.push_back(e);
+            }
+            if(lastUndecided->assignment == UNKNOWN)
+                explore(worker, lastUndecided);
+        }
+    }
+    else
+    {
+        ++worker.processedEdges;
+        if(allOne)
+            finalAssign(worker, e->source, ONE);
+        else if(hasCZero)
+            killEdge(worker, e);
+        else
+        {
+            assert(lastUndecided != nullptr);
+            if(only_assign) return;
+            if(!e->processed.exchange(true))
+            {
+                bool assigned = false;
+                for(auto it = e->targets.begin(); it != e->targets.end(); ++it)
+                    if((*it)->assignment != ONE && !(*it)->pushDependency(it.slot()))
+                        assigned = true;
+                if(assigned)
+                {
+                    push(worker, e);
+                    return;
+                }
+            }
+            if(lastUndecided->assignment == UNKNOWN)
+                explore(worker, lastUndecided);
+        }
+    }
+}
+
+void Algorithm::ParallelCertainZeroFPA::killEdge(worker_t& worker, Edge* e)
+{
+    if(e->handled.exchange(true)) return;
+    if(e->source->nsuccs.fetch_sub(1) == 1)
+        finalAssign(worker, e->source, CZERO);
+}
+
+void Algorithm::ParallelCertainZeroFPA::finalAssign(worker_t& worker, Configuration *c, Assignment a)
+{
+    assert(a == ONE || a == CZERO);
+    int8_t current = c->assignment.load();
+    do {
+        if(current == ONE || current == CZERO) return;
+    } while(!c->assignment.compare_exchange_weak(current, a));
+
+    if(c == vertex)
+    {
+        _stop = true;
+        return;
+    }
+    c->dependency_set.close([&](Edge* e) {
+        push(worker, e);
+    });
+}
+
+void Algorithm::ParallelCertainZeroFPA::explore(worker_t& worker, Configuration *c)
+{
+    int8_t expected = UNKNOWN;
+    if(!c->assignment.compare_exchange_strong(expected, ZERO)) return;
+
+    auto& succs = worker.succs;
+    graph->successors(c, worker.id, succs);
+    // no other worker sees the edges before they are pushed
+    c->nsuccs = succs.size();
+    worker.exploredConfigurations += 1;
+    worker.numberOfEdges += succs.size();
+
+    if(succs.empty())
+    {
+        finalAssign(worker, c, CZERO);
+        return;
+    }
+    // before we start exploring, lets check if any of them determine
+    // the outcome already!
+    for(auto it = succs.rbegin(); it != succs.rend(); ++it)
+    {
+        checkEdge(worker, *it, true);
+        if(c->isDone()) return;
+    }
+    for(auto e : succs)
+        if(!e->handled)
+            push(worker, e);
+}
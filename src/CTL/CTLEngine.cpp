@@ -5,6 +5,7 @@
 
 #include "CTL/Algorithm/CertainZeroFPA.h"
 #include "CTL/Algorithm/LocalFPA.h"
+#include "CTL/Algorithm/ParallelCertainZeroFPA.h"
 
 #include "utils/stopwatch.h"
 #include "PetriEngine/options.h"
@@ -27,7 +28,7 @@ using namespace PetriEngine::Reachability;
 using namespace PetriNets;
 
 ReturnValue getAlgorithm(std::shared_ptr<Algorithm::FixedPointAlgorithm>& algorithm,
-                         CTLAlgorithmType algorithmtype, Strategy search)
+                         CTLAlgorithmType algorithmtype, Strategy search, uint32_t threads)
 {
     switch(algorithmtype)
     {
@@ -37,6 +38,9 @@ ReturnValue getAlgorithm(std::shared_ptr<Algorithm::FixedPointAlgorithm>& algori
         case CTLAlgorithmType::CZero:
             algorithm = std::make_shared<Algorithm::CertainZeroFPA>(search);
             break;
+        case CTLAlgorithmType::ParallelCZero:
+            algorithm = std::make_shared<Algorithm::ParallelCertainZeroFPA>(search, threads);
+            break;
         default:
             throw base_error("Unknown or unsupported algorithm");
     }
@@ -45,19 +49,19 @@ ReturnValue getAlgorithm(std::shared_ptr<Algorithm::FixedPointAlgorithm>& algori
 
 bool CTLSingleSolve(const Condition_ptr& query, PetriNet* net,
                  CTLAlgorithmType algorithmtype,
-                 Strategy strategytype, bool partial_order, CTLResult& result)
+                 Strategy strategytype, bool partial_order, CTLResult& result, uint32_t threads)
 {
-    return CTLSingleSolve(query.get(), net, algorithmtype, strategytype, partial_order, result);
+    return CTLSingleSolve(query.get(), net, algorithmtype, strategytype, partial_order, result, threads);
 }
 
 bool CTLSingleSolve(Condition* query, PetriNet* net,
                  CTLAlgorithmType algorithmtype,
-                 Strategy strategytype, bool partial_order, CTLResult& result)
+                 Strategy strategytype, bool partial_order, CTLResult& result, uint32_t threads)
 {
     OnTheFlyDG graph(net, partial_order);
     graph.setQuery(query);
     std::shared_ptr<Algorithm::FixedPointAlgorithm> alg = nullptr;
-    getAlgorithm(alg, algorithmtype,  strategytype);
+    getAlgorithm(alg, algorithmtype,  strategytype, threads);
 
     stopwatch timer;
     timer.start();
@@ -305,7 +309,7 @@ bool recursiveSolve(Condition* query, PetriEngine::PetriNet* net,
     }
     //else
     {
-        return CTLSingleSolve(query, net, algorithmtype, strategytype, partial_order, result);
+        return CTLSingleSolve(query, net, algorithmtype, strategytype, partial_order, result, options.cores);
     }
 }
 
@@ -352,7 +356,7 @@ ReturnValue CTLMain(PetriNet* net,
         if(!solved)
         {
             if(options.strategy == Strategy::BFS || options.strategy == Strategy::RDFS)
-                result.result = CTLSingleSolve(result.query, net, algorithmtype, options.strategy, options.stubbornreduction, result);
+                result.result = CTLSingleSolve(result.query, net, algorithmtype, options.strategy, options.stubbornreduction, result, options.cores);
             else
                 result.result = recursiveSolve(result.query, net, algorithmtype, strategytype, partial_order, result, options);
         }
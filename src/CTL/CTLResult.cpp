@@ -12,7 +12,8 @@ void CTLResult::print(const std::string& qname, StatisticsLevel statisticslevel,
          << techniques
          << (options.isCPN ? "UNFOLDING_TO_PT " : "")
          << (options.stubbornreduction ? "STUBBORN_SETS " : "")
-         << (options.ctlalgorithm == CTL::CZero ? "CTL_CZERO " : "")
+         << (options.ctlalgorithm == CTL::CZero || options.ctlalgorithm == CTL::ParallelCZero ? "CTL_CZERO " : "")
+         << (options.ctlalgorithm == CTL::ParallelCZero && options.cores > 1 ? "PARALLEL_PROCESSING " : "")
          << (options.ctlalgorithm == CTL::Local ? "CTL_LOCAL " : "")
             << "\n\n";
     out << "Query index " << index << " was solved" << "\n";
@@ -3,22 +3,42 @@
 
 namespace DependencyGraph {
 
+    static target_t& slotOf(Edge* e, Configuration* c) {
+        auto it = e->targets.begin();
+        while(*it != c)
+        {
+            assert(it != e->targets.end());
+            ++it;
+        }
+        return it.slot();
+    }
+
     void Configuration::addDependency(Edge* e) {
+        addDependency(slotOf(e, this));
+    }
+
+    void Configuration::addDependency(target_t& slot) {
+        assert(slot.conf == this);
         if(assignment == ONE) return;
+        Edge* e = slot.edge;
         unsigned int sDist = e->is_negated ? e->source->getDistance() + 1 : e->source->getDistance();
         unsigned int tDist = getDistance();
 
         setDistance(std::max(sDist, tDist));
-        auto it = dependency_set.begin();
-        auto pit = dependency_set.before_begin();
-        while(it != dependency_set.end())
-        {
-            if(*it == e) return;
-            if(*it > e) break;
-            pit = it;
-            ++it;
-        }
-        dependency_set.insert_after(pit, e);
-        ++e->refcnt;
+        if(dependency_set.insert(slot))
+            ++e->refcnt;
+    }
+
+    bool Configuration::pushDependency(Edge* e) {
+        return pushDependency(slotOf(e, this));
+    }
+
+    bool Configuration::pushDependency(target_t& slot) {
+        assert(slot.conf == this);
+        Edge* e = slot.edge;
+        uint32_t sDist = e->is_negated ? e->source->getDistance() + 1 : e->source->getDistance();
+        uint32_t tDist = distance.load(std::memory_order_relaxed);
+        while(tDist < sDist && !distance.compare_exchange_weak(tDist, sDist, std::memory_order_relaxed)) {}
+        return dependency_set.push(slot);
     }
-}
\ No newline at end of file
+}
@@ -13,19 +13,59 @@
 #include "PetriEngine/Stubborn/ReachabilityStubbornSet.h"
 #include "PetriEngine/PQL/PredicateCheckers.h"
 #include "PetriEngine/PQL/Evaluation.h"
+#include "utils/errors.h"
 
 using namespace PetriEngine::PQL;
 using namespace DependencyGraph;
 
 namespace PetriNets {
 
-OnTheFlyDG::OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order) : encoder(t_net->numberOfPlaces(), 0),
+OnTheFlyDG::worker_t::worker_t(PetriEngine::PetriNet *net, size_t id) : encoder(net->numberOfPlaces(), 0),
+        stubborn(std::make_shared<PetriEngine::ReachabilityStubbornSet>(*net)),
+        redgen(*net, stubborn), id(id) {
+}
+
+OnTheFlyDG::OnTheFlyDG(PetriEngine::PetriNet *t_net, bool partial_order) :
         edge_alloc(new linked_bucket_t<DependencyGraph::Edge,1024*10>(1)),
         conf_alloc(new linked_bucket_t<char[sizeof(PetriConfig)], 1024*1024>(1)),
-        _redgen(*t_net, std::make_shared<PetriEngine::ReachabilityStubbornSet>(*t_net)), _partial_order(partial_order) {
+        _partial_order(partial_order) {
     net = t_net;
     n_places = t_net->numberOfPlaces();
     n_transitions = t_net->numberOfTransitions();
+    _workers.emplace_back(std::make_unique<worker_t>(t_net, 0));
+}
+
+void OnTheFlyDG::setWorkers(size_t workers)
+{
+    workers = std::max<size_t>(workers, 1);
+    if(workers == _workers.size()) return;
+    if(edge_alloc->size() != 0)
+        throw base_error("The workers of the dependency graph must be set before it is explored");
+    delete edge_alloc;
+    edge_alloc = new linked_bucket_t<DependencyGraph::Edge,1024*10>(workers);
+    _workers.resize(std::min(workers, _workers.size()));
+    while(_workers.size() < workers)
+    {
+        _workers.emplace_back(std::make_unique<worker_t>(net, _workers.size()));
+        _workers.back()->working_marking.setMarking(net->makeInitialMarking());
+        _workers.back()->query_marking.setMarking(net->makeInitialMarking());
+    }
+    for(auto& w : _workers)
+    {
+        w->stubborn->setQueryLock(workers > 1 ? &_queryLock : nullptr);
+        if(_program)
+        {
+            w->stubborn->setProgram(_program);
+            w->scratch = _program->make_scratch();
+        }
+    }
+}
+
+std::unique_lock<std::mutex> OnTheFlyDG::lockShared()
+{
+    if(_workers.size() > 1)
+        return std::unique_lock<std::mutex>(_lock);
+    return std::unique_lock<std::mutex>();
 }
 
 
@@ -46,30 +86,42 @@ OnTheFlyDG::~OnTheFlyDG()
 Condition::Result OnTheFlyDG::initialEval()
 {
     initialConfiguration();
-    EvaluationContext e(query_marking.marking(), net);
-    return PetriEngine::PQL::evaluate(query, e);
+    auto& w = *_workers[0];
+    return fastEval(w, query, &w.query_marking);
 }
 
-Condition::Result OnTheFlyDG::fastEval(Condition* query, Marking* unfolded)
+Condition::Result OnTheFlyDG::fastEval(worker_t& worker, Condition* query, Marking* unfolded)
 {
     EvaluationContext e(unfolded->marking(), net);
+    if(_program)
+        return _program->evaluate(query, e, worker.scratch);
     return PetriEngine::PQL::evaluate(query, e);
 }
 
-std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
+void OnTheFlyDG::successors(Configuration *c, std::vector<Edge*>& succs)
 {
+    successors(c, 0, succs);
+}
+
+void OnTheFlyDG::successors(Configuration *c, size_t worker, std::vector<Edge*>& succs)
+{
+    auto& w = *_workers[worker];
+    auto& query_marking = w.query_marking;
     PetriEngine::PQL::DistanceContext context(net, query_marking.marking());
     PetriConfig *v = static_cast<PetriConfig*>(c);
-    trie.unpack(v->marking, encoder.scratchpad().raw());
-    encoder.decode(query_marking.marking(), encoder.scratchpad().raw());
+    {
+        auto guard = lockShared();
+        trie.unpack(v->marking, w.encoder.scratchpad().raw());
+    }
+    w.encoder.decode(query_marking.marking(), w.encoder.scratchpad().raw());
     //    v->printConfiguration();
-    std::vector<Edge*> succs;
+    succs.clear();
     auto query_type = v->query->getQueryType();
     if(query_type == EVAL){
         assert(false);
         //assert(false && "Someone told me, this was a bad place to be.");
-        if (fastEval(query, &query_marking) == Condition::RTRUE){
-            succs.push_back(newEdge(*v, 0));///*v->query->distance(context))*/0);
+        if (fastEval(w, query, &query_marking) == Condition::RTRUE){
+            succs.push_back(newEdge(w, *v, 0));///*v->query->distance(context))*/0);
         }
     }
     else if (query_type == LOPERATOR){
@@ -77,14 +129,14 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             // no need to try to evaluate here -- this is already transient in other evaluations.
             auto cond = static_cast<NotCondition*>(v->query);
             Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
-            Edge* e = newEdge(*v, /*v->query->distance(context)*/0);
+            Edge* e = newEdge(w, *v, /*v->query->distance(context)*/0);
             e->is_negated = true;
-            if (!e->addTarget(c)) {
+            if (!e->addTarget(c, w.arena)) {
                 succs.push_back(e);
             }
             else {
                 --e->refcnt;
-                release(e);
+                release(w, e);
             }
         }
         else if(v->query->getQuantifier() == AND){
@@ -93,10 +145,10 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             std::vector<Condition*> conds;
             for(auto& c : *cond)
             {
-                auto res = fastEval(c.get(), &query_marking);
+                auto res = fastEval(w, c.get(), &query_marking);
                 if(res == Condition::RFALSE)
                 {
-                    return succs;
+                    return;
                 }
                 if(res == Condition::RUNKNOWN)
                 {
@@ -104,7 +156,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 }
             }
 
-            Edge *e = newEdge(*v, /*cond->distance(context)*/0);
+            Edge *e = newEdge(w, *v, /*cond->distance(context)*/0);
 
             //If we get here, then either both propositions are true (shouldn't be possible)
             //Or a temporal operator and a true proposition
@@ -112,12 +164,12 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             for(auto c : conds)
             {
                 assert(PetriEngine::PQL::isTemporal(c));
-                if (e->addTarget(createConfiguration(v->marking, v->getOwner(), c)))
+                if (e->addTarget(createConfiguration(v->marking, v->getOwner(), c), w.arena))
                     break;
             }
             if (e->handled) {
                 --e->refcnt;
-                release(e);
+                release(w, e);
             }
             else
                 succs.push_back(e);
@@ -128,11 +180,11 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             std::vector<Condition*> conds;
             for(auto& c : *cond)
             {
-                auto res = fastEval(c.get(), &query_marking);
+                auto res = fastEval(w, c.get(), &query_marking);
                 if(res == Condition::RTRUE)
                 {
-                    succs.push_back(newEdge(*v, 0));
-                    return succs;
+                    succs.push_back(newEdge(w, *v, 0));
+                    return;
                 }
                 if(res == Condition::RUNKNOWN)
                 {
@@ -146,10 +198,10 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             for(auto c : conds)
             {
                 assert(PetriEngine::PQL::isTemporal(c));
-                Edge *e = newEdge(*v, /*cond->distance(context)*/0);
-                if (e->addTarget(createConfiguration(v->marking, v->getOwner(), c))) {
+                Edge *e = newEdge(w, *v, /*cond->distance(context)*/0);
+                if (e->addTarget(createConfiguration(v->marking, v->getOwner(), c), w.arena)) {
                     --e->refcnt;
-                    release(e);
+                    release(w, e);
                 }
                 else
                     succs.push_back(e);
@@ -164,23 +216,23 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             if (v->query->getPath() == U){
                 auto cond = static_cast<AUCondition*>(v->query);
                 Edge *right = nullptr;
-                auto r1 = fastEval((*cond)[1], &query_marking);
+                auto r1 = fastEval(w, (*cond)[1], &query_marking);
                 if (r1 != Condition::RUNKNOWN){
                     //right side is not temporal, eval it right now!
                     if (r1 == Condition::RTRUE) {    //satisfied, no need to go through successors
-                        succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        succs.push_back(newEdge(w, *v, 0));
+                        return;
                     }//else: It's not valid, no need to add any edge, just add successors
                 }
                 else {
                     //right side is temporal, we need to evaluate it as normal
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[1]);
-                    right = newEdge(*v, /*(*cond)[1]->distance(context)*/0);
-                    right->addTarget(c);
+                    right = newEdge(w, *v, /*(*cond)[1]->distance(context)*/0);
+                    right->addTarget(c, w.arena);
                 }
                 bool valid = false;
                 Configuration *left = nullptr;
-                auto r0 = fastEval((*cond)[0], &query_marking);
+                auto r0 = fastEval(w, (*cond)[0], &query_marking);
                 if (r0 != Condition::RUNKNOWN) {
                     //left side is not temporal, eval it right now!
                     valid = r0 == Condition::RTRUE;
@@ -191,33 +243,33 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 if (valid || left != nullptr) {
                     //if left side is guaranteed to be not satisfied, skip successor generation
                     Edge* leftEdge = nullptr;
-                    nextStates (query_marking, cond,
-                                [&](){ leftEdge = newEdge(*v, std::numeric_limits<uint32_t>::max());},
+                    nextStates(w, cond,
+                                [&](){ leftEdge = newEdge(w, *v, std::numeric_limits<uint32_t>::max());},
                                 [&](Marking& mark){
-                                    auto res = fastEval(cond, &mark);
+                                    auto res = fastEval(w, cond, &mark);
                                     if(res == Condition::RTRUE) return true;
                                     if(res == Condition::RFALSE)
                                     {
                                         left = nullptr;
                                         --leftEdge->refcnt;
-                                        release(leftEdge);
+                                        release(w, leftEdge);
                                         leftEdge = nullptr;
                                         return false;
                                     }
                                     context.setMarking(mark.marking());
-                                    Configuration* c = createConfiguration(createMarking(mark), owner(mark, cond), cond);
-                                    return !leftEdge->addTarget(c);
+                                    Configuration* c = createConfiguration(createMarking(w, mark), owner(mark, cond), cond);
+                                    return !leftEdge->addTarget(c, w.arena);
                                 },
                                 [&]()
                                 {
                                     if(leftEdge)
                                     {
                                         if (left != nullptr) {
-                                            leftEdge->addTarget(left);
+                                            leftEdge->addTarget(left, w.arena);
                                         }
                                         if (leftEdge->handled){
                                             --leftEdge->refcnt;
-                                            release(leftEdge);
+                                            release(w, leftEdge);
                                             leftEdge = nullptr;
                                         }
                                         else
@@ -230,7 +282,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 if (right != nullptr) {
                     if (right->handled){
                         --right->refcnt;
-                        release(right);
+                        release(w, right);
                     }
                     else
                         succs.push_back(right);
@@ -239,45 +291,45 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             else if(v->query->getPath() == F){
                 auto cond = static_cast<AFCondition*>(v->query);
                 Edge *subquery = nullptr;
-                auto r = fastEval((*cond)[0], &query_marking);
+                auto r = fastEval(w, (*cond)[0], &query_marking);
                 if (r != Condition::RUNKNOWN) {
                     bool valid = r == Condition::RTRUE;
                     if (valid) {
-                        succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        succs.push_back(newEdge(w, *v, 0));
+                        return;
                     }
                 } else {
-                    subquery = newEdge(*v, /*cond->distance(context)*/0);
+                    subquery = newEdge(w, *v, /*cond->distance(context)*/0);
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
-                    subquery->addTarget(c); // cannot be self-loop since the formula is smaller
+                    subquery->addTarget(c, w.arena); // cannot be self-loop since the formula is smaller
                 }
                 Edge* e1 = nullptr;
-                nextStates(query_marking, cond,
-                        [&](){e1 = newEdge(*v, std::numeric_limits<uint32_t>::max());},
+                nextStates(w, cond,
+                        [&](){e1 = newEdge(w, *v, std::numeric_limits<uint32_t>::max());},
                         [&](Marking& mark)
                         {
-                            auto res = fastEval(cond, &mark);
+                            auto res = fastEval(w, cond, &mark);
                             if(res == Condition::RTRUE) return true;
                             if(res == Condition::RFALSE)
                             {
                                 if(subquery)
                                 {
                                     --subquery->refcnt;
-                                    release(subquery);
+                                    release(w, subquery);
                                     subquery = nullptr;
                                 }
                                 e1->targets.clear();
                                 return false;
                             }
                             context.setMarking(mark.marking());
-                            Configuration* c = createConfiguration(createMarking(mark), owner(mark, cond), cond);
-                            return !e1->addTarget(c);
+                            Configuration* c = createConfiguration(createMarking(w, mark), owner(mark, cond), cond);
+                            return !e1->addTarget(c, w.arena);
                         },
                         [&]()
                         {
                             if (e1->handled) {
                                 --e1->refcnt;
-                                release(e1);
+                                release(w, e1);
                             }
                             else
                                 succs.push_back(e1);
@@ -290,13 +342,13 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             }
             else if(v->query->getPath() == X){
                 auto cond = static_cast<AXCondition*>(v->query);
-                Edge* e = newEdge(*v, std::numeric_limits<uint32_t>::max());
+                Edge* e = newEdge(w, *v, std::numeric_limits<uint32_t>::max());
                 Condition::Result allValid = Condition::RTRUE;
                 // no possible self-loops from AX q
-                nextStates(query_marking, cond,
+                nextStates(w, cond,
                         [](){},
                         [&](Marking& mark){
-                            auto res = fastEval((*cond)[0], &mark);
+                            auto res = fastEval(w, (*cond)[0], &mark);
                             if(res != Condition::RUNKNOWN)
                             {
                                 if (res == Condition::RFALSE) {
@@ -308,8 +360,8 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                             {
                                 allValid = Condition::RUNKNOWN;
                                 context.setMarking(mark.marking());
-                                Configuration* c = createConfiguration(createMarking(mark), v->getOwner(), (*cond)[0]);
-                                e->addTarget(c);
+                                Configuration* c = createConfiguration(createMarking(w, mark), v->getOwner(), (*cond)[0]);
+                                e->addTarget(c, w.arena);
                             }
                             return true;
                         },
@@ -338,25 +390,25 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             if (v->query->getPath() == U){
                 auto cond = static_cast<EUCondition*>(v->query);
                 Edge *right = nullptr;
-                auto r1 = fastEval((*cond)[1], &query_marking);
+                auto r1 = fastEval(w, (*cond)[1], &query_marking);
                 if (r1 == Condition::RUNKNOWN) {
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[1]);
-                    right = newEdge(*v, /*(*cond)[1]->distance(context)*/0);
-                    right->addTarget(c);
+                    right = newEdge(w, *v, /*(*cond)[1]->distance(context)*/0);
+                    right->addTarget(c, w.arena);
                 } else {
                     bool valid = r1 == Condition::RTRUE;
                     if (valid) {
-                        succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        succs.push_back(newEdge(w, *v, 0));
+                        return;
                     }   // else: right condition is not satisfied, no need to add an edge
                 }
 
 
                 Configuration *left = nullptr;
                 bool valid = false;
-                nextStates(query_marking, cond,
+                nextStates(w, cond,
                     [&](){
-                        auto r0 = fastEval((*cond)[0], &query_marking);
+                        auto r0 = fastEval(w, (*cond)[0], &query_marking);
                         if (r0 == Condition::RUNKNOWN) {
                             left = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
                         } else {
@@ -365,38 +417,38 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                     },
                     [&](Marking& marking){
                         if(left == nullptr && !valid) return false;
-                        auto res = fastEval(cond, &marking);
+                        auto res = fastEval(w, cond, &marking);
                         if(res == Condition::RFALSE) return true;
                         if(res == Condition::RTRUE)
                         {
-                            for(auto s : succs){ --s->refcnt; release(s);}
+                            for(auto s : succs){ --s->refcnt; release(w, s);}
                             succs.clear();
-                            succs.push_back(newEdge(*v, 0));
+                            succs.push_back(newEdge(w, *v, 0));
                             if(right && (left == nullptr && valid))
                             {
                                 // we don't need to validate right IF left
                                 // is trivially satisfied and we have a satisfied
                                 // successor.
                                 --right->refcnt;
-                                release(right);
+                                release(w, right);
                                 right = nullptr;
                             }
 
                             if(left)
-                                succs.back()->addTarget(left);
+                                succs.back()->addTarget(left, w.arena);
 
                             return false;
                         }
                         context.setMarking(marking.marking());
-                        Edge* e = newEdge(*v, /*cond->distance(context)*/0);
-                        Configuration* c1 = createConfiguration(createMarking(marking), owner(marking, cond), cond);
-                        e->addTarget(c1);
+                        Edge* e = newEdge(w, *v, /*cond->distance(context)*/0);
+                        Configuration* c1 = createConfiguration(createMarking(w, marking), owner(marking, cond), cond);
+                        e->addTarget(c1, w.arena);
                         if (left != nullptr) {
-                            e->addTarget(left);
+                            e->addTarget(left, w.arena);
                         }
                         if (e->handled) {
                             --e->refcnt;
-                            release(e);
+                            release(w, e);
                             // we _don't_ abort suc generation, since EU will have many out-edges
                         }
                         else
@@ -407,7 +459,7 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
                 if (right != nullptr) {
                     if (right->handled) {
                         --right->refcnt;
-                        release(right);
+                        release(w, right);
                     }
                     else
                         succs.push_back(right);
@@ -416,46 +468,46 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             else if(v->query->getPath() == F){
                 auto cond = static_cast<EFCondition*>(v->query);
                 Edge *subquery = nullptr;
-                auto r = fastEval((*cond)[0], &query_marking);
+                auto r = fastEval(w, (*cond)[0], &query_marking);
                 if (r != Condition::RUNKNOWN) {
                     bool valid = r == Condition::RTRUE;
                     if (valid) {
-                        succs.push_back(newEdge(*v, 0));
-                        return succs;
+                        succs.push_back(newEdge(w, *v, 0));
+                        return;
                     }
                 } else {
                     Configuration* c = createConfiguration(v->marking, v->getOwner(), (*cond)[0]);
-                    subquery = newEdge(*v, /*cond->distance(context)*/0);
-                    subquery->addTarget(c);
+                    subquery = newEdge(w, *v, /*cond->distance(context)*/0);
+                    subquery->addTarget(c, w.arena);
                 }
 
-                nextStates(query_marking, cond,
+                nextStates(w, cond,
                             [](){},
                             [&](Marking& mark){
-                                auto res = fastEval(cond, &mark);
+                                auto res = fastEval(w, cond, &mark);
                                 if(res == Condition::RFALSE) return true;
                                 if(res == Condition::RTRUE)
                                 {
-                                    for(auto s : succs){ --s->refcnt; release(s);}
+                                    for(auto s : succs){ --s->refcnt; release(w, s);}
                                     succs.clear();
-                                    succs.push_back(newEdge(*v, 0));
+                                    succs.push_back(newEdge(w, *v, 0));
                                     if(subquery)
                                     {
                                         --subquery->refcnt;
-                                        release(subquery);
+                                        release(w, subquery);
                                     }
                                     subquery = nullptr;
                                     return false;
                                 }
                                 context.setMarking(mark.marking());
-                                Edge* e = newEdge(*v, /*cond->distance(context)*/0);
-                                Configuration* c = createConfiguration(createMarking(mark), owner(mark, cond), cond);
-                                e->addTarget(c);
+                                Edge* e = newEdge(w, *v, /*cond->distance(context)*/0);
+                                Configuration* c = createConfiguration(createMarking(w, mark), owner(mark, cond), cond);
+                                e->addTarget(c, w.arena);
                                 if (!e->handled)
                                     succs.push_back(e);
                                 else {
                                     --e->refcnt;
-                                    release(e);
+                                    release(w, e);
                                 }
                                 return true;
                             },
@@ -469,23 +521,23 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
             else if(v->query->getPath() == X){
                 auto cond = static_cast<EXCondition*>(v->query);
                 auto query = (*cond)[0];
-                nextStates(query_marking, cond,
+                nextStates(w, cond,
                         [](){},
                         [&](Marking& marking) {
-                            auto res = fastEval(query, &marking);
+                            auto res = fastEval(w, query, &marking);
                             if(res == Condition::RTRUE)
                             {
-                                for(auto s : succs){ --s->refcnt; release(s);}
+                                for(auto s : succs){ --s->refcnt; release(w, s);}
                                 succs.clear();
-                                succs.push_back(newEdge(*v, 0));
+                                succs.push_back(newEdge(w, *v, 0));
                                 return false;
                             }   //else: It can't hold there, no need to create an edge
                             else if(res == Condition::RUNKNOWN)
                             {
                                 context.setMarking(marking.marking());
-                                Edge* e = newEdge(*v, /*(*cond)[0]->distance(context)*/0);
-                                Configuration* c = createConfiguration(createMarking(marking), v->getOwner(), query);
-                                e->addTarget(c);
+                                Edge* e = newEdge(w, *v, /*(*cond)[0]->distance(context)*/0);
+                                Configuration* c = createConfiguration(createMarking(w, marking), v->getOwner(), query);
+                                e->addTarget(c, w.arena);
                                 succs.push_back(e);
                             }
                             return true;
@@ -510,50 +562,38 @@ std::vector<DependencyGraph::Edge*> OnTheFlyDG::successors(Configuration *c)
     {
         ((PetriConfig*)succs[0]->targets[0])->setOwner(v->getOwner());
     }*/
-    return succs;
 }
 
 Configuration* OnTheFlyDG::initialConfiguration()
 {
-    if(working_marking.marking() == nullptr)
+    auto& w = *_workers[0];
+    if(w.working_marking.marking() == nullptr)
     {
-        working_marking.setMarking  (net->makeInitialMarking());
-        query_marking.setMarking    (net->makeInitialMarking());
-        auto o = owner(working_marking, this->query);
-        initial_config = createConfiguration(createMarking(working_marking), o, this->query);
+        w.working_marking.setMarking  (net->makeInitialMarking());
+        w.query_marking.setMarking    (net->makeInitialMarking());
+        auto o = owner(w.working_marking, this->query);
+        initial_config = createConfiguration(createMarking(w, w.working_marking), o, this->query);
     }
     return initial_config;
 }
 
 
-void OnTheFlyDG::nextStates(Marking& t_marking, Condition* ptr,
-    std::function<void ()> pre,
-    std::function<bool (Marking&)> foreach,
-    std::function<void ()> post)
+bool OnTheFlyDG::prepareNextStates(worker_t& worker, Condition* ptr)
 {
-    bool first = true;
-    memcpy(working_marking.marking(), query_marking.marking(), n_places*sizeof(PetriEngine::MarkVal));
+    memcpy(worker.working_marking.marking(), worker.query_marking.marking(), n_places*sizeof(PetriEngine::MarkVal));
     auto qf = static_cast<QuantifierCondition*>(ptr);
-    if(!_partial_order || ptr->getQuantifier() != E || ptr->getPath() != F || PetriEngine::PQL::isTemporal((*qf)[0]))
-    {
-        PetriEngine::SuccessorGenerator PNGen(*net);
-        dowork<PetriEngine::SuccessorGenerator>(PNGen, first, pre, foreach);
-    }
-    else
-    {
-        _redgen.setQuery(ptr);
-        dowork<PetriEngine::ReducingSuccessorGenerator>(_redgen, first, pre, foreach);
-    }
-
-    if(!first) post();
+    return _partial_order && ptr->getQuantifier() == E && ptr->getPath() == F && !PetriEngine::PQL::isTemporal((*qf)[0]);
 }
 
 void OnTheFlyDG::cleanUp()
 {
-    while(!recycle.empty())
+    for(auto& w : _workers)
     {
-        assert(recycle.top()->refcnt == -1);
-        recycle.pop();
+        while(!w->recycle.empty())
+        {
+            assert(w->recycle.top()->refcnt == -1);
+            w->recycle.pop();
+        }
     }
     // TODO, implement proper cleanup
 }
@@ -562,10 +602,17 @@ void OnTheFlyDG::cleanUp()
 void OnTheFlyDG::setQuery(Condition* query)
 {
     this->query = query;
-    delete[] working_marking.marking();
-    delete[] query_marking.marking();
-    working_marking.setMarking(nullptr);
-    query_marking.setMarking(nullptr);
+    _program = std::make_shared<const PetriEngine::PQL::QueryProgram>(query);
+    for(auto& w : _workers)
+    {
+        w->stubborn->setProgram(_program);
+        w->scratch = _program->make_scratch();
+    }
+    auto& w = *_workers[0];
+    delete[] w.working_marking.marking();
+    delete[] w.query_marking.marking();
+    w.working_marking.setMarking(nullptr);
+    w.query_marking.setMarking(nullptr);
     initialConfiguration();
     assert(this->query);
 }
@@ -586,6 +633,7 @@ size_t OnTheFlyDG::maxTokens() const {
 
 PetriConfig *OnTheFlyDG::createConfiguration(size_t marking, size_t own, Condition* t_query)
 {
+    auto guard = lockShared();
     auto& configs = trie.get_data(marking);
     for(PetriConfig* c : configs){
         if(c->query == t_query)
@@ -605,16 +653,17 @@ PetriConfig *OnTheFlyDG::createConfiguration(size_t marking, size_t own, Conditi
 
 
 
-size_t OnTheFlyDG::createMarking(Marking& t_marking){
+size_t OnTheFlyDG::createMarking(worker_t& worker, Marking& t_marking){
     size_t sum = 0;
     bool allsame = true;
     uint32_t val = 0;
     uint32_t active = 0;
     uint32_t last = 0;
     markingStats(t_marking.marking(), sum, allsame, val, active, last);
-    unsigned char type = encoder.getType(sum, active, allsame, val);
-    size_t length = encoder.encode(t_marking.marking(), type);
-    binarywrapper_t w = binarywrapper_t(encoder.scratchpad().raw(), length*8);
+    unsigned char type = worker.encoder.getType(sum, active, allsame, val);
+    size_t length = worker.encoder.encode(t_marking.marking(), type);
+    binarywrapper_t w = binarywrapper_t(worker.encoder.scratchpad().raw(), length*8);
+    auto guard = lockShared();
     auto tit = trie.insert(w.raw(), w.size());
     if(tit.first){
         _markingCount++;
@@ -625,6 +674,11 @@ size_t OnTheFlyDG::createMarking(Marking& t_marking){
 }
 
 void OnTheFlyDG::release(Edge* e)
+{
+    release(*_workers[0], e);
+}
+
+void OnTheFlyDG::release(worker_t& worker, Edge* e)
 {
     assert(e->refcnt == 0);
     e->is_negated = false;
@@ -633,7 +687,7 @@ void OnTheFlyDG::release(Edge* e)
     e->targets.clear();
     e->refcnt = -1;
     e->handled = false;
-    recycle.push(e);
+    worker.recycle.push(e);
 }
 
 size_t OnTheFlyDG::owner(Marking& marking, Condition* cond) {
@@ -642,19 +696,19 @@ size_t OnTheFlyDG::owner(Marking& marking, Condition* cond) {
 }
 
 
-Edge* OnTheFlyDG::newEdge(Configuration &t_source, uint32_t weight)
+Edge* OnTheFlyDG::newEdge(worker_t& worker, Configuration &t_source, uint32_t weight)
 {
     Edge* e = nullptr;
-    if(recycle.empty())
+    if(worker.recycle.empty())
     {
-        size_t n = edge_alloc->next(0);
+        size_t n = edge_alloc->next(worker.id);
         e = &(*edge_alloc)[n];
     }
     else
     {
-        e = recycle.top();
+        e = worker.recycle.top();
         e->refcnt = 0;
-        recycle.pop();
+        worker.recycle.pop();
     }
     assert(e->targets.empty());
     /*e->assignment = UNKNOWN;
@@ -669,21 +723,9 @@ Edge* OnTheFlyDG::newEdge(Configuration &t_source, uint32_t weight)
 void OnTheFlyDG::markingStats(const uint32_t* marking, size_t& sum,
         bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last)
 {
-    uint32_t cnt = 0;
-
-    for (uint32_t i = 0; i < n_places; i++)
-    {
-        uint32_t old = val;
-        if(marking[i] != 0)
-        {
-            ++cnt;
-            last = std::max(last, i);
-            val = std::max(marking[i], val);
-            if(old != 0 && marking[i] != old) allsame = false;
-            ++active;
-            sum += marking[i];
-        }
-    }
+    uint64_t total;
+    AlignedEncoder::markingStats(marking, n_places, total, allsame, val, active, last);
+    sum += total;
 }
 
 
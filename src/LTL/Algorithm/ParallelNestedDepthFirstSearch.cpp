@@ -0,0 +1,253 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LTL/Algorithm/ParallelNestedDepthFirstSearch.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace LTL {
+
+    ParallelNestedDepthFirstSearch::ParallelNestedDepthFirstSearch(const PetriEngine::PetriNet& net,
+                                                                   const PetriEngine::PQL::Condition_ptr &query,
+                                                                   const Structures::BuchiAutomaton &buchi,
+                                                                   uint32_t kbound, uint32_t hyper_traces,
+                                                                   uint32_t threads)
+    : ModelChecker(net, query, buchi), _kbound(kbound), _hyper_traces(hyper_traces == 0 ? 1 : hyper_traces),
+      _threads(std::max<uint32_t>(threads, 1)), _automaton(buchi)
+    {
+    }
+
+    bool ParallelNestedDepthFirstSearch::check()
+    {
+        if (_hyper_traces > 1)
+            throw base_error("Hyper-LTL is not supported by the parallel NDFS algorithm");
+        if (_build_trace)
+            throw base_error("Traces are not supported by the parallel NDFS algorithm");
+
+        state_set_t states(_net, _kbound, _threads);
+        std::vector<std::unique_ptr<worker_t>> workers;
+        for (size_t w = 0; w < _threads; ++w)
+            workers.emplace_back(std::make_unique<worker_t>(_net, _automaton, _factory.new_state(), _factory.new_state(), w));
+
+        std::vector<Structures::stateid_t> initial;
+        auto& first = *workers[0];
+        std::copy(_net.initial(), _net.initial() + _net.numberOfPlaces(), first._working.marking());
+        add_successors(first, states, _automaton.initial_state(), initial);
+
+        _found = false;
+        _stop = false;
+        _error = nullptr;
+        std::vector<std::thread> threads;
+        for (size_t w = 1; w < _threads; ++w)
+            threads.emplace_back([&, w] { run(*workers[w], states, initial); });
+        run(first, states, initial);
+        for (auto& t : threads)
+            t.join();
+        if (_error)
+            std::rethrow_exception(_error);
+
+        states.sync_statistics();
+        _discovered = states.discovered();
+        _max_tokens = states.max_tokens();
+        _markings = states.markings();
+        _configurations = states.configurations();
+        for (auto& w : workers)
+            _expanded += w->_expanded;
+        _violation = _found;
+        return !_violation;
+    }
+
+    void ParallelNestedDepthFirstSearch::run(worker_t& worker, state_set_t& states,
+                                             std::vector<Structures::stateid_t> initial)
+    {
+        try {
+            if (worker._id > 0)
+                std::shuffle(initial.begin(), initial.end(), worker._rng);
+            for (auto init : initial) {
+                if (_stop)
+                    return;
+                if (worker._colors.count(init) == 0 && !states.is_red(init))
+                    blue_dfs(worker, states, init);
+            }
+            // a single completed blue search proves the absence of accepting cycles
+            _stop = true;
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard(_errorLock);
+            if (!_error)
+                _error = std::current_exception();
+            _stop = true;
+        }
+    }
+
+    void ParallelNestedDepthFirstSearch::blue_dfs(worker_t& worker, state_set_t& states, Structures::stateid_t init)
+    {
+        auto& stack = worker._blue_stack;
+        size_t depth = 0;
+        Structures::stateid_t next = init;
+        bool descend = true;
+        while (true) {
+            if (descend) {
+                descend = false;
+                worker._colors[next] = CYAN;
+                auto& frame = push(worker, states, stack, depth, next);
+                const auto buchi = state_set_t::get_buchi_state(next);
+                // an accepting state with a true self-loop lies on an accepting cycle as soon as it has a successor
+                if (_shortcircuitweak && !frame._successors.empty() &&
+                    _automaton.is_accepting(buchi) && _automaton.has_invariant_self_loop(buchi)) {
+                    report_violation();
+                    return;
+                }
+            }
+            if (depth == 0 || _stop)
+                return;
+            auto& top = stack[depth - 1];
+            if (top._next < top._successors.size()) {
+                auto t = top._successors[top._next++];
+                if (worker._colors.count(t) == 0 && !states.is_red(t)) {
+                    next = t;
+                    descend = true;
+                }
+            } else {
+                auto s = top._id;
+                if (_automaton.is_accepting(state_set_t::get_buchi_state(s)) && !states.is_red(s)) {
+                    red_dfs(worker, states, s);
+                    if (_stop)
+                        return;
+                }
+                worker._colors[s] = BLUE;
+                --depth;
+            }
+        }
+    }
+
+    void ParallelNestedDepthFirstSearch::red_dfs(worker_t& worker, state_set_t& states, Structures::stateid_t seed)
+    {
+        auto& stack = worker._red_stack;
+        size_t depth = 0;
+        worker._pink.clear();
+        worker._pink.insert(seed);
+        push(worker, states, stack, depth, seed);
+        while (depth > 0) {
+            if (_stop)
+                return;
+            auto& top = stack[depth - 1];
+            if (top._next < top._successors.size()) {
+                auto t = top._successors[top._next++];
+                auto it = worker._colors.find(t);
+                if (it != worker._colors.end() && it->second == CYAN) {
+                    report_violation();
+                    return;
+                }
+                if (worker._pink.count(t) == 0 && !states.is_red(t)) {
+                    worker._pink.insert(t);
+                    push(worker, states, stack, depth, t);
+                }
+            } else {
+                --depth;
+            }
+        }
+
+        // other accepting states reached may still have a red search of another worker pending
+        for (auto p : worker._pink) {
+            if (p == seed || !_automaton.is_accepting(state_set_t::get_buchi_state(p)))
+                continue;
+            while (!states.is_red(p)) {
+                if (_stop)
+                    return;
+                std::this_thread::yield();
+            }
+        }
+        for (auto p : worker._pink)
+            states.set_red(p);
+    }
+
+    ParallelNestedDepthFirstSearch::frame_t&
+    ParallelNestedDepthFirstSearch::push(worker_t& worker, state_set_t& states, std::vector<frame_t>& stack,
+                                         size_t& depth, Structures::stateid_t id)
+    {
+        if (depth == stack.size())
+            stack.emplace_back();
+        auto& frame = stack[depth++];
+        frame._id = id;
+        frame._next = 0;
+        expand(worker, states, id, frame._successors);
+        return frame;
+    }
+
+    void ParallelNestedDepthFirstSearch::expand(worker_t& worker, state_set_t& states, Structures::stateid_t id,
+                                                std::vector<Structures::stateid_t>& successors)
+    {
+        successors.clear();
+        ++worker._expanded;
+        states.decode(worker._parent, id, worker._id);
+        const auto buchi = state_set_t::get_buchi_state(id);
+        worker._generator.prepare(&worker._parent);
+        bool deadlock = true;
+        while (worker._generator.next(worker._working)) {
+            deadlock = false;
+            add_successors(worker, states, buchi, successors);
+        }
+        if (deadlock) {
+            // deadlocked markings loop, as in ProductSuccessorGenerator
+            std::copy(worker._parent.marking(), worker._parent.marking() + _net.numberOfPlaces(),
+                      worker._working.marking());
+            add_successors(worker, states, buchi, successors);
+        }
+        if (worker._id > 0)
+            std::shuffle(successors.begin(), successors.end(), worker._rng);
+    }
+
+    void ParallelNestedDepthFirstSearch::add_successors(worker_t& worker, state_set_t& states, uint32_t buchi_state,
+                                                        std::vector<Structures::stateid_t>& successors)
+    {
+        worker._valuation.reset(worker._working.marking());
+        for (auto e = _automaton.begin(buchi_state); e != _automaton.end(buchi_state); ++e) {
+            if (!_automaton.guard_valid(worker._valuation, e->_guard))
+                continue;
+            worker._working.set_buchi_state(e->_dst);
+            auto res = states.add(worker._working, worker._id);
+            if (res.second != std::numeric_limits<size_t>::max())
+                successors.push_back(res.second);
+        }
+    }
+
+    void ParallelNestedDepthFirstSearch::report_violation()
+    {
+        _found = true;
+        _stop = true;
+    }
+
+    size_t ParallelNestedDepthFirstSearch::max_tokens() const {
+        return _max_tokens;
+    }
+
+    size_t ParallelNestedDepthFirstSearch::get_markings() const {
+        return _markings;
+    }
+
+    size_t ParallelNestedDepthFirstSearch::get_configurations() const {
+        return _configurations;
+    }
+
+    size_t ParallelNestedDepthFirstSearch::get_discovered() const {
+        return _discovered;
+    }
+
+    void ParallelNestedDepthFirstSearch::print_stats(std::ostream &os) const
+    {
+        ModelChecker::print_stats(os, _discovered, _max_tokens);
+    }
+}
@@ -95,23 +95,29 @@ namespace LTL {
     template<typename SuccGen>
     bool TarjanModelChecker::select_trace_compute(SuccGen& successorGenerator)
     {
+        if (_storage != StateStorage::Exact) {
+            if (_build_trace)
+                throw base_error("Traces are not supported with approximate state storage");
+            return compute<false, true, SuccGen>(successorGenerator);
+        }
         return _build_trace ?
-            compute<true, SuccGen>(successorGenerator) :
-            compute<false, SuccGen>(successorGenerator);
+            compute<true, false, SuccGen>(successorGenerator) :
+            compute<false, false, SuccGen>(successorGenerator);
     }
 
 
-    template<bool SaveTrace, typename SuccGen>
+    template<bool SaveTrace, bool Approximate, typename SuccGen>
     bool TarjanModelChecker::compute(SuccGen& successorGenerator)
     {
 
-        using StateSet = std::conditional_t<SaveTrace, LTL::Structures::TraceableBitProductStateSet<>,
-                LTL::Structures::BitProductStateSet<>>;
+        using StateSet = std::conditional_t<Approximate, LTL::Structures::ApproximateProductStateSet<>,
+                std::conditional_t<SaveTrace, LTL::Structures::TraceableBitProductStateSet<>,
+                LTL::Structures::BitProductStateSet<>>>;
         using centry_t = std::conditional_t<SaveTrace,
                 tracable_centry_t,
                 plain_centry_t>;
 
-        StateSet seen(_net, _k_bound);
+        StateSet seen = make_state_set<StateSet>();
         // master list of state information.
         light_deque<centry_t> cstack;
         // depth-first search stack, contains current search path.
@@ -159,7 +165,7 @@ namespace LTL {
 
                 // lookup successor in 'hash' table
                 auto marking = StateSet::get_marking_id(stateid);
-                auto suc_pos = _chash[hash(marking, StateSet::get_buchi_state(stateid))];
+                auto suc_pos = _chash[hash(stateid)];
                 while (suc_pos != std::numeric_limits<idx_t>::max() && cstack[suc_pos]._stateid != stateid) {
                     if constexpr (std::is_same<SuccGen, SpoolingSuccessorGenerator>::value) {
                         if (cstack[suc_pos]._dstack && StateSet::get_marking_id(cstack[suc_pos]._stateid) == marking) {
@@ -179,7 +185,13 @@ namespace LTL {
                     update(cstack, dstack, successorGenerator, suc_pos);
                     continue;
                 }
-                if (!_store.exists(stateid).first) {
+                if constexpr (Approximate) {
+                    // completed states are not in _store, but they are never new
+                    if (isnew) {
+                        push(seen, cstack, dstack, successorGenerator, working, stateid);
+                    }
+                }
+                else if (!_store.exists(stateid).first) {
                     push(seen, cstack, dstack, successorGenerator, working, stateid);
                 }
             }
@@ -199,6 +211,9 @@ namespace LTL {
         _max_tokens = seen.max_tokens();
         _markings = seen.markings();
         _configurations = seen.configurations();
+        if constexpr (Approximate) {
+            _omission_probability = seen.table().omissionProbability();
+        }
         return !_violation;
     }
 
@@ -209,7 +224,9 @@ namespace LTL {
     template<typename StateSet, typename T, typename D, typename S>
     void TarjanModelChecker::push(StateSet& s, light_deque<T>& cstack, light_deque<D>& dstack, S& successor_generator, State &state, size_t stateid) {
         const auto ctop = static_cast<idx_t>(cstack.size());
-        const auto h = hash(StateSet::get_marking_id(stateid), StateSet::get_buchi_state(stateid));
+        if (ctop >= _chash.size())
+            grow_chash(cstack);
+        const auto h = hash(stateid);
         cstack.push_back(T{ctop, stateid, _chash[h]});
         _chash[h] = ctop;
         dstack.push_back(D{ctop, successor_generator.initial_suc_info()});
@@ -250,13 +267,30 @@ namespace LTL {
     template<typename StateSet, typename T>
     void TarjanModelChecker::popCStack(StateSet& s, light_deque<T>& cstack)
     {
-        auto h = hash(StateSet::get_marking_id(cstack.back()._stateid), StateSet::get_buchi_state(cstack.back()._stateid));
-        _store.insert(cstack.back()._stateid);
+        auto h = hash(cstack.back()._stateid);
+        if constexpr (std::is_same_v<StateSet, LTL::Structures::ApproximateProductStateSet<>>) {
+            s.release(cstack.back()._stateid);
+        } else {
+            _store.insert(cstack.back()._stateid);
+        }
         _chash[h] = cstack.back()._next;
         cstack.pop_back();
     }
 
 
+    template<typename T>
+    void TarjanModelChecker::grow_chash(light_deque<T>& cstack)
+    {
+        ++_hash_bits;
+        _chash.assign(size_t{1} << _hash_bits, std::numeric_limits<idx_t>::max());
+        // relink bottom-up so each chain still starts at its topmost cstack entry
+        for (idx_t i = 0; i < cstack.size(); ++i) {
+            const auto h = hash(cstack[i]._stateid);
+            cstack[i]._next = _chash[h];
+            _chash[h] = i;
+        }
+    }
+
     template<typename T, typename D, typename SuccGen>
     void TarjanModelChecker::update(light_deque<T>& cstack, light_deque<D>& dstack, SuccGen& successorGenerator, idx_t to)
     {
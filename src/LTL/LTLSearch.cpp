@@ -23,6 +23,7 @@
 #include "LTL/SuccessorGeneration/SpoolingSuccessorGenerator.h"
 #include "LTL/Algorithm/NestedDepthFirstSearch.h"
 #include "LTL/Algorithm/TarjanModelChecker.h"
+#include "LTL/Algorithm/ParallelNestedDepthFirstSearch.h"
 
 #include "PetriEngine/PQL/PredicateCheckers.h"
 #include "PetriEngine/PQL/PQL.h"
@@ -226,19 +227,37 @@ namespace LTL {
                             const Strategy search_strategy,
                             const LTLHeuristic heuristics_flag,
                             const bool utilize_weak,
-                            const uint64_t seed) {
+                            const uint64_t seed,
+                            const StateStorage storage,
+                            const size_t memory_budget,
+                            const uint32_t threads) {
 
-        _heuristic = make_heuristic(_net, _negated_formula, _buchi, search_strategy, heuristics_flag, seed);
+        // the parallel search explores in a random order per worker, so it has no use for a heuristic
+        if (algorithm != Algorithm::ParallelNDFS)
+            _heuristic = make_heuristic(_net, _negated_formula, _buchi, search_strategy, heuristics_flag, seed);
 
         switch (algorithm) {
             case Algorithm::NDFS:
             {
+                if (storage != StateStorage::Exact)
+                    throw base_error("Approximate state storage is only supported by the Tarjan algorithm");
                 _checker = std::make_unique<NestedDepthFirstSearch>(_net, _negated_formula, _buchi, k_bound, _traces.size());
                 break;
             }
             case Algorithm::Tarjan:
-                _checker = std::make_unique<TarjanModelChecker>(_net, _negated_formula, _buchi, k_bound, _traces.size());
+            {
+                auto tarjan = std::make_unique<TarjanModelChecker>(_net, _negated_formula, _buchi, k_bound, _traces.size());
+                tarjan->set_state_storage(storage, memory_budget);
+                _checker = std::move(tarjan);
                 break;
+            }
+            case Algorithm::ParallelNDFS:
+            {
+                if (storage != StateStorage::Exact)
+                    throw base_error("Approximate state storage is only supported by the Tarjan algorithm");
+                _checker = std::make_unique<ParallelNestedDepthFirstSearch>(_net, _negated_formula, _buchi, k_bound, _traces.size(), threads);
+                break;
+            }
             case Algorithm::None:
             default:
                 assert(false);
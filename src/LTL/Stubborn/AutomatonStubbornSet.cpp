@@ -158,12 +158,13 @@ namespace LTL {
         }
 
 
-        guard_info_t buchi_state = _state_guards[state->get_buchi_state()];
+        const guard_info_t& buchi_state = _state_guards[state->get_buchi_state()];
 
         PQL::EvaluationContext evaluationContext{_parent->marking(), &_net};
+        _valuation.reset(_parent->marking());
 
         // Check if retarding is satisfied for condition 3.
-        _retarding_satisfied = _aut.guard_valid(evaluationContext, buchi_state._retarding._bdd);
+        _retarding_satisfied = _flat.guard_valid(_valuation, buchi_state._retarding._guard);
         /*
         if (!_aut.guard_valid(evaluationContext, buchi_state.retarding.decision_diagram)) {
             set_all_stubborn();
@@ -181,7 +182,7 @@ namespace LTL {
 
         // If a progressing formula satisfies the guard St=T is the only way to ensure NLG.
         for (auto &q : buchi_state._progressing) {
-            if (_aut.guard_valid(evaluationContext, q._bdd)) {
+            if (_flat.guard_valid(_valuation, q._guard)) {
                 set_all_stubborn();
                 __print_debug();
                 return true;
@@ -309,7 +310,6 @@ namespace LTL {
 
     bool AutomatonStubbornSet::_cond3_valid(uint32_t t)
     {
-        EvaluationContext ctx{_markbuf.marking(), &_net};
         if (_retarding_satisfied || !_enabled[t]) return true;
         else {
             assert(_gen.checkPreset(t));
@@ -317,8 +317,9 @@ namespace LTL {
             memcpy(_markbuf.marking(), (*_parent).marking(), _net.numberOfPlaces() * sizeof(MarkVal));
             _gen.consumePreset(_markbuf, t);
             _gen.producePostset(_markbuf, t);
-            return _aut.guard_valid(ctx,
-                                    _state_guards[static_cast<const LTL::Structures::ProductState *>(_parent)->get_buchi_state()]._retarding._bdd);
+            _valuation.reset(_markbuf.marking());
+            return _flat.guard_valid(_valuation,
+                                     _state_guards[static_cast<const LTL::Structures::ProductState *>(_parent)->get_buchi_state()]._retarding._guard);
         }
     }
 
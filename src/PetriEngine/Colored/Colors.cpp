@@ -23,6 +23,7 @@
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 #include <cassert>
 
 //@{
@@ -157,10 +158,8 @@ namespace PetriEngine {
 
         const ColorType* ColorType::dotInstance() {
             static ColorType instance("dot");
-            if(instance.size() == 0)
-            {
-                instance.addColor("dot");
-            }
+            static std::once_flag initialized;
+            std::call_once(initialized, [] { instance.addColor("dot"); });
             return &instance;
         }
 
@@ -173,29 +172,93 @@ namespace PetriEngine {
         }
 
         const Color* ColorType::operator[] (const char* index) const {
+            // the colors of a plain color type are never tuples, so their names are their strings
             for (size_t i = 0; i < _colors.size(); i++) {
-                if (strcmp(operator[](i).toString().c_str(), index) == 0)
-                    return &operator[](i);
+                if (strcmp(_colors[i].getColorName().c_str(), index) == 0)
+                    return &_colors[i];
             }
             return nullptr;
         }
 
-        const Color& ProductType::operator[](size_t index) const {
-            if (_cache.count(index) < 1) {
-                size_t mod = 1;
-                size_t div = 1;
-
-                std::vector<const Color*> colors;
-                for (auto & constituent : _constituents) {
-                    mod = constituent->size();
-                    colors.push_back(&(*constituent)[(index / div) % mod]);
-                    div *= mod;
+        // the n null pointers behind entry, allocated by whichever thread gets there first
+        template<typename T>
+        static std::atomic<T*>* loadOrCreate(std::atomic<std::atomic<T*>*>& entry, size_t n) {
+            std::atomic<T*>* array = entry.load(std::memory_order_acquire);
+            if (array != nullptr)
+                return array;
+            auto* fresh = new std::atomic<T*>[n];
+            for (size_t i = 0; i < n; ++i)
+                fresh[i] = nullptr;
+            if (entry.compare_exchange_strong(array, fresh, std::memory_order_acq_rel))
+                return fresh;
+            delete[] fresh;
+            return array;
+        }
+
+        ProductType::~ProductType() {
+            for (size_t d = 0; d < _ndirectories; ++d) {
+                page_t* directory = _directories[d].load();
+                if (directory == nullptr) continue;
+                for (size_t p = 0; p < DIRECTORY_SIZE; ++p) {
+                    slot_t* page = directory[p].load();
+                    if (page == nullptr) continue;
+                    for (size_t i = 0; i < PAGE_SIZE; ++i)
+                        delete page[i].load();
+                    delete[] page;
                 }
+                delete[] directory;
+            }
+        }
+
+        const Color& ProductType::operator[](size_t index) const {
+            std::call_once(_directoriesAllocated, [this] {
+                const size_t directories = (size() + (PAGE_SIZE << DIRECTORY_BITS) - 1) >> (PAGE_BITS + DIRECTORY_BITS);
+                if (directories > MAX_DIRECTORIES)
+                    return;
+                _ndirectories = directories;
+                _directories = std::make_unique<std::atomic<page_t*>[]>(_ndirectories);
+                for (size_t d = 0; d < _ndirectories; ++d)
+                    _directories[d] = nullptr;
+            });
+
+            slot_t* slot = nullptr;
+            if (_directories) {
+                assert((index >> (PAGE_BITS + DIRECTORY_BITS)) < _ndirectories);
+                page_t* directory = loadOrCreate(_directories[index >> (PAGE_BITS + DIRECTORY_BITS)], DIRECTORY_SIZE);
+                slot_t* page = loadOrCreate(directory[(index >> PAGE_BITS) & (DIRECTORY_SIZE - 1)], PAGE_SIZE);
+                slot = &page[index & (PAGE_SIZE - 1)];
+                const Color* color = slot->load(std::memory_order_acquire);
+                if (color != nullptr)
+                    return *color;
+            } else {
+                std::shared_lock<std::shared_mutex> lock(_cacheLock);
+                auto it = _cache.find(index);
+                if (it != _cache.end())
+                    return it->second;
+            }
+
+            size_t mod = 1;
+            size_t div = 1;
+
+            std::vector<const Color*> colors;
+            for (auto & constituent : _constituents) {
+                mod = constituent->size();
+                colors.push_back(&(*constituent)[(index / div) % mod]);
+                div *= mod;
+            }
 
-                _cache.emplace(index, Color(this, index, colors));
+            if (slot == nullptr) {
+                std::unique_lock<std::shared_mutex> lock(_cacheLock);
+                return _cache.emplace(index, Color(this, index, colors)).first->second;
             }
 
-            return _cache.at(index);
+            const Color* color = nullptr;
+            auto* fresh = new Color(this, index, colors);
+            if (slot->compare_exchange_strong(color, fresh, std::memory_order_acq_rel))
+                return *fresh;
+            // another thread created the color first
+            delete fresh;
+            return *color;
         }
 
         const Color* ProductType::getColor(const std::vector<const Color*>& colors) const {
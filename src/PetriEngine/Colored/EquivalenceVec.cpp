@@ -51,13 +51,24 @@ namespace PetriEngine {
             }
         }
 
-        void EquivalenceVec::addColorToEqClassMap(const Color *color){
-            for(auto& eqClass : _equivalenceClasses){
-                std::vector<uint32_t> colorIds;
-                color->getTupleId(colorIds);
-                if(eqClass.containsColor(colorIds, _diagonalTuplePositions)){
-                    _colorEQClassMap[color] = &eqClass;
-                    break;
+        void EquivalenceVec::assignColors(const ColorType *colorType){
+            // the tuple ids are the digits of the color id, so the colors need not be created
+            std::vector<const ColorType *> types;
+            colorType->getColortypes(types);
+            std::vector<uint32_t> colorIds(types.size(), 0);
+            _colorEqClass.assign(colorType->size(), NO_CLASS);
+            for(size_t id = 0; id < _colorEqClass.size(); id++){
+                for(uint32_t c = 0; c < _equivalenceClasses.size(); c++){
+                    if(_equivalenceClasses[c].containsColor(colorIds, _diagonalTuplePositions)){
+                        _colorEqClass[id] = c;
+                        break;
+                    }
+                }
+                for(size_t i = 0; i < types.size(); i++){
+                    if(++colorIds[i] < types[i]->size()){
+                        break;
+                    }
+                    colorIds[i] = 0;
                 }
             }
         }
@@ -87,7 +98,7 @@ namespace PetriEngine {
         //Add color ids of diagonal positions as we represent partitions with diagonal postitions
         //as a single equivalence class to save space, but they should not be partition together
         const uint32_t EquivalenceVec::getUniqueIdForColor(const Colored::Color *color) const {
-            PetriEngine::Colored::EquivalenceClass *eqClass = _colorEQClassMap.find(color)->second;
+            const EquivalenceClass *eqClass = getEquivalenceClass(color->getId());
 
             std::vector<uint32_t> colorTupleIds;
             std::vector<uint32_t> newColorTupleIds;
@@ -8,7 +8,12 @@
 #include "PetriEngine/Colored/RestrictVisitor.h"
 #include "PetriEngine/Colored/OutputIntervalVisitor.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace PetriEngine {
     namespace Colored {
@@ -131,7 +136,7 @@ namespace PetriEngine {
             }
         }
 
-        void ForwardFixedPoint::compute(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout) {
+        void ForwardFixedPoint::compute(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout, uint32_t threads) {
             if (_builder.isColored()) {
                 init();
                 auto& places = _builder.places();
@@ -143,10 +148,8 @@ namespace PetriEngine {
                 _considered.resize(transitions.size());
                 std::fill(_considered.begin(), _considered.end(), false);
 
-                //Start timers for timing color fixpoint creation and max interval reduction steps
+                //Start timer for timing color fixpoint creation
                 auto start = std::chrono::high_resolution_clock::now();
-                auto end = std::chrono::high_resolution_clock::now();
-                auto reduceTimer = std::chrono::high_resolution_clock::now();
 
                 // First, we compute color propagation for all transitions with an empty preset
                 for (uint32_t transitionId = 0; transitionId < transitions.size(); ++transitionId) {
@@ -168,48 +171,142 @@ namespace PetriEngine {
                     processOutputArcs(transitions[transitionId], transitionId);
                 }
 
-                while (!_placeFixpointQueue.empty()) {
-                    //Reduce max interval once timeout passes
-                    if (maxIntervals > maxIntervalsReduced && timeout > 0 && std::chrono::duration_cast<std::chrono::seconds>(end - reduceTimer).count() >= timeout) {
-                        maxIntervals = maxIntervalsReduced;
-                    }
+                if (threads > 1)
+                    propagateParallel(maxIntervals, maxIntervalsReduced, timeout, threads);
+                else
+                    propagate(maxIntervals, maxIntervalsReduced, timeout);
+
+                auto end = std::chrono::high_resolution_clock::now();
+                _fixpointDone = true;
+                _fixPointCreationTime = (std::chrono::duration_cast<std::chrono::microseconds>(end - start).count())*0.000001;
+            }
+        }
 
-                    uint32_t currentPlaceId = _placeFixpointQueue.back();
-                    _placeFixpointQueue.pop_back();
-                    _placeColorFixpoints[currentPlaceId].inQueue = false;
-
-                    for (auto transitionId : places[currentPlaceId]._post) {
-                        const Colored::Transition& transition = _builder.transitions()[transitionId];
-                        // Skip transitions that cannot add anything new,
-                        // such as transitions with only constants on their arcs that have been processed once
-                        assert(transitionId < _builder.transitions().size());
-                        assert(transitionId < _considered.size());
-                        if (_considered[transitionId]) continue;
-                        bool transitionActivated = true;
+        void ForwardFixedPoint::propagate(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout) {
+            auto& places = _builder.places();
+            auto reduceTimer = std::chrono::high_resolution_clock::now();
+            auto end = reduceTimer;
+            while (!_placeFixpointQueue.empty()) {
+                //Reduce max interval once timeout passes
+                if (maxIntervals > maxIntervalsReduced && timeout > 0 && std::chrono::duration_cast<std::chrono::seconds>(end - reduceTimer).count() >= timeout) {
+                    maxIntervals = maxIntervalsReduced;
+                }
+
+                uint32_t currentPlaceId = _placeFixpointQueue.back();
+                _placeFixpointQueue.pop_back();
+                _placeColorFixpoints[currentPlaceId].inQueue = false;
+
+                for (auto transitionId : places[currentPlaceId]._post) {
+                    const Colored::Transition& transition = _builder.transitions()[transitionId];
+                    // Skip transitions that cannot add anything new,
+                    // such as transitions with only constants on their arcs that have been processed once
+                    assert(transitionId < _builder.transitions().size());
+                    assert(transitionId < _considered.size());
+                    if (_considered[transitionId]) continue;
+                    bool transitionActivated = true;
+                    _transition_variable_maps[transitionId].clear();
+
+                    restrictInputPlaces(transition, maxIntervals);
+                    processInputArcs(transition, transitionId, transitionActivated);
+
+                    //If there were colors which activated the transitions, compute the intervals produced
+                    if (transitionActivated)
+                    {
+                        processOutputArcs(transition, transitionId);
+                    }
+                    else
                         _transition_variable_maps[transitionId].clear();
+                }
+                end = std::chrono::high_resolution_clock::now();
+            }
+        }
 
-                        processInputArcs(transition, currentPlaceId, transitionId, transitionActivated, maxIntervals);
+        // Empties the queue in rounds. All transitions in the postset of a queued place are
+        // evaluated against the same place constraints, which only change when the output of
+        // the round is merged, so the transitions can be evaluated concurrently.
+        void ForwardFixedPoint::propagateParallel(uint32_t maxIntervals, uint32_t maxIntervalsReduced, int32_t timeout, uint32_t threads) {
+            auto& places = _builder.places();
+            auto& transitions = _builder.transitions();
+            auto reduceTimer = std::chrono::high_resolution_clock::now();
+            auto end = reduceTimer;
+            std::vector<uint32_t> round;
+            std::vector<bool> inRound(transitions.size(), false);
+            std::vector<OutputIntervals> outputs;
+            std::vector<uint8_t> hasVarOutArcs;
+            while (!_placeFixpointQueue.empty()) {
+                //Reduce max interval once timeout passes
+                if (maxIntervals > maxIntervalsReduced && timeout > 0 && std::chrono::duration_cast<std::chrono::seconds>(end - reduceTimer).count() >= timeout) {
+                    maxIntervals = maxIntervalsReduced;
+                }
 
-                        //If there were colors which activated the transitions, compute the intervals produced
-                        if (transitionActivated)
-                        {
-                            processOutputArcs(transition, transitionId);
-                        }
-                        else
-                            _transition_variable_maps[transitionId].clear();
+                round.clear();
+                for (auto placeId : _placeFixpointQueue) {
+                    _placeColorFixpoints[placeId].inQueue = false;
+                    for (auto transitionId : places[placeId]._post) {
+                        if (_considered[transitionId] || inRound[transitionId]) continue;
+                        inRound[transitionId] = true;
+                        round.push_back(transitionId);
                     }
-                    end = std::chrono::high_resolution_clock::now();
+                }
+                _placeFixpointQueue.clear();
+                std::sort(round.begin(), round.end());
+                for (auto transitionId : round) {
+                    inRound[transitionId] = false;
+                    restrictInputPlaces(transitions[transitionId], maxIntervals);
                 }
 
-                _fixpointDone = true;
-                _fixPointCreationTime = (std::chrono::duration_cast<std::chrono::microseconds>(end - start).count())*0.000001;
+                outputs.resize(round.size());
+                hasVarOutArcs.assign(round.size(), false);
+                std::atomic<size_t> next{0};
+                std::atomic<bool> stop{false};
+                std::mutex errorLock;
+                std::exception_ptr error;
+                auto evaluate = [&] {
+                    try {
+                        for (size_t i = next++; i < round.size() && !stop; i = next++) {
+                            auto transitionId = round[i];
+                            auto& transition = transitions[transitionId];
+                            bool transitionActivated = true;
+                            outputs[i].clear();
+                            _transition_variable_maps[transitionId].clear();
+                            processInputArcs(transition, transitionId, transitionActivated);
+                            if (transitionActivated)
+                                hasVarOutArcs[i] = computeOutputIntervals(transition, transitionId, outputs[i]);
+                            else {
+                                _transition_variable_maps[transitionId].clear();
+                                // not activated, so it must be considered again
+                                hasVarOutArcs[i] = true;
+                            }
+                        }
+                    } catch (...) {
+                        std::lock_guard<std::mutex> guard(errorLock);
+                        if (!error)
+                            error = std::current_exception();
+                        stop = true;
+                    }
+                };
+                std::vector<std::thread> workers;
+                for (size_t w = 1; w < std::min<size_t>(threads, round.size()); ++w)
+                    workers.emplace_back(evaluate);
+                evaluate();
+                for (auto& worker : workers)
+                    worker.join();
+                if (error)
+                    std::rethrow_exception(error);
+
+                for (size_t i = 0; i < round.size(); ++i) {
+                    addOutputIntervals(outputs[i]);
+                    if (!hasVarOutArcs[i])
+                        _considered[round[i]] = true;
+                }
+                end = std::chrono::high_resolution_clock::now();
             }
         }
 
         //Retreive interval colors from the input arcs restricted by the transition guard
 
-        void ForwardFixedPoint::processInputArcs(const Colored::Transition& transition, uint32_t currentPlaceId, uint32_t transitionId, bool &transitionActivated, uint32_t max_intervals) {
-            getArcIntervals(transition, transitionActivated, max_intervals, transitionId);
+        void ForwardFixedPoint::processInputArcs(const Colored::Transition& transition, uint32_t transitionId, bool &transitionActivated) {
+            getArcIntervals(transition, transitionActivated, transitionId);
 
             if (!transitionActivated) {
                 return;
@@ -232,11 +329,17 @@ namespace PetriEngine {
             }
         }
 
-        void ForwardFixedPoint::getArcIntervals(const Colored::Transition& transition, bool &transitionActivated, uint32_t max_intervals, uint32_t transitionId) {
+        void ForwardFixedPoint::restrictInputPlaces(const Colored::Transition& transition, uint32_t max_intervals) {
             for (auto& arc : transition.input_arcs) {
                 PetriEngine::Colored::ColorFixpoint& curCFP = _placeColorFixpoints[arc.place];
                 curCFP.constraints.restrict(max_intervals);
                 _max_intervals = std::max(_max_intervals, curCFP.constraints.size());
+            }
+        }
+
+        void ForwardFixedPoint::getArcIntervals(const Colored::Transition& transition, bool &transitionActivated, uint32_t transitionId) {
+            for (auto& arc : transition.input_arcs) {
+                const PetriEngine::Colored::ColorFixpoint& curCFP = _placeColorFixpoints[arc.place];
                 assert(_arcIntervals.size() >= transitionId);
                 Colored::ArcIntervals& arcInterval = _arcIntervals[transitionId][arc.place];
                 arcInterval._intervalTupleVec.clear();
@@ -287,14 +390,19 @@ namespace PetriEngine {
         }
 
         void ForwardFixedPoint::processOutputArcs(const Colored::Transition& transition, size_t transition_id) {
+            OutputIntervals output;
+            bool transitionHasVarOutArcs = computeOutputIntervals(transition, transition_id, output);
+            addOutputIntervals(output);
+            //If there are no variables among the out arcs of a transition
+            // and it has been activated, there is no reason to cosider it again
+            if (!transitionHasVarOutArcs) {
+                _considered[transition_id] = true;
+            }
+        }
+
+        bool ForwardFixedPoint::computeOutputIntervals(const Colored::Transition& transition, size_t transition_id, OutputIntervals& output) {
             bool transitionHasVarOutArcs = false;
             for (const auto& arc : transition.output_arcs) {
-                Colored::ColorFixpoint& placeFixpoint = _placeColorFixpoints[arc.place];
-                //used to check if colors are added to the place. The total distance between upper and
-                //lower bounds should grow when more colors are added and as we cannot remove colors this
-                //can be checked by summing the differences
-                uint32_t colorsBefore = placeFixpoint.constraints.getContainedColors();
-
                 std::set<const Colored::Variable *> variables;
                 Colored::VariableVisitor::get_variables(*arc.expr, variables);
 
@@ -345,10 +453,23 @@ namespace PetriEngine {
                 }
 
                 auto intervals = Colored::OutputIntervalVisitor::intervals(*arc.expr, _transition_variable_maps[transition_id]);
+                for (auto& intervalTuple : intervals) {
+                    intervalTuple.simplify();
+                }
+                output.emplace_back(arc.place, std::move(intervals));
+            }
+            return transitionHasVarOutArcs;
+        }
 
+        void ForwardFixedPoint::addOutputIntervals(OutputIntervals& output) {
+            for (auto& [placeId, intervals] : output) {
+                Colored::ColorFixpoint& placeFixpoint = _placeColorFixpoints[placeId];
+                //used to check if colors are added to the place. The total distance between upper and
+                //lower bounds should grow when more colors are added and as we cannot remove colors this
+                //can be checked by summing the differences
+                uint32_t colorsBefore = placeFixpoint.constraints.getContainedColors();
 
                 for (auto& intervalTuple : intervals) {
-                    intervalTuple.simplify();
                     for (auto& interval : intervalTuple) {
                         placeFixpoint.constraints.addInterval(std::move(interval));
                     }
@@ -359,16 +480,11 @@ namespace PetriEngine {
                 if (!placeFixpoint.inQueue) {
                     uint32_t colorsAfter = placeFixpoint.constraints.getContainedColors();
                     if (colorsAfter > colorsBefore) {
-                        _placeFixpointQueue.push_back(arc.place);
+                        _placeFixpointQueue.push_back(placeId);
                         placeFixpoint.inQueue = true;
                     }
                 }
             }
-            //If there are no variables among the out arcs of a transition
-            // and it has been activated, there is no reason to cosider it again
-            if (!transitionHasVarOutArcs) {
-                _considered[transition_id] = true;
-            }
         }
     }
-}
\ No newline at end of file
+}
@@ -61,11 +61,11 @@ namespace PetriEngine {
             if (other._type != nullptr && _type != other._type) {
                 throw base_error("You cannot add Multisets over different sets");
             }
+            if (_type == nullptr && !other._set.empty()) {
+                _type = ColorType::dotInstance();
+            }
             for (auto c : other._set) {
-                const Color* color = &(*ColorType::dotInstance()->begin());
-                if (_type != nullptr)
-                    color = &((*_type)[c.first]);
-                (*this)[color] += c.second;
+                count(c.first) += c.second;
             }
         }
 
@@ -76,11 +76,12 @@ namespace PetriEngine {
             if (other._type != nullptr && _type != other._type) {
                 throw base_error("You cannot add Multisets over different sets");
             }
-            for (auto c : _set) {
-                const Color* color = &(*ColorType::dotInstance()->begin());
-                if (_type != nullptr)
-                    color = &((*_type)[c.first]);
-                (*this)[color] =  c.second < other[color] ? 0 : c.second - other[color];
+            if (_type == nullptr && !_set.empty()) {
+                _type = ColorType::dotInstance();
+            }
+            for (auto& c : _set) {
+                const uint32_t o = other.count(c.first);
+                c.second = c.second < o ? 0 : c.second - o;
             }
         }
 
@@ -106,6 +107,23 @@ namespace PetriEngine {
             return 0;
         }
 
+        uint32_t Multiset::count(uint32_t id) const {
+            for (auto c : _set) {
+                if (c.first == id)
+                    return c.second;
+            }
+            return 0;
+        }
+
+        uint32_t& Multiset::count(uint32_t id) {
+            for (auto & i : _set) {
+                if (i.first == id)
+                    return i.second;
+            }
+            _set.emplace_back(id, 0);
+            return _set.back().second;
+        }
+
         uint32_t& Multiset::operator [](const Color* color) {
             if (_type == nullptr) {
                 _type = color->getColorType();
@@ -108,11 +108,7 @@ namespace PetriEngine {
                     continue;
                 }
 
-                const ColorType *colorType = _places[pi].type;
-                for(uint32_t i = 0; i < colorType->size(); i++){
-                    const Color *color = &(*colorType)[i];
-                    eqVec.addColorToEqClassMap(color);
-                }
+                eqVec.assignColors(_places[pi].type);
             }
         }
 
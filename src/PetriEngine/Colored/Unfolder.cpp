@@ -6,6 +6,12 @@
 
 #include "PetriEngine/Colored/BindingGenerator.h"
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
 namespace PetriEngine {
     namespace Colored {
 
@@ -56,23 +62,34 @@ namespace PetriEngine {
 
         PetriNetBuilder Unfolder::unfold() {
             PetriNetBuilder ptBuilder(_builder.string_set());
+            unfoldNet(ptBuilder);
+            return ptBuilder;
+        }
+
+        void Unfolder::unfold(StreamingPnmlBuilder& ptBuilder) {
+            unfoldNet(ptBuilder);
+        }
+
+        template<typename Builder>
+        void Unfolder::unfoldNet(Builder& ptBuilder) {
             if (_builder.isColored()) {
                 auto start = std::chrono::high_resolution_clock::now();
+                _unfoldedTokens.assign(_builder.places().size(), 0);
 
-                for (uint32_t transitionId = 0; transitionId < _builder.transitions().size(); transitionId++) {
-                    unfoldTransition(ptBuilder, transitionId);
-                }
+                if (_threads > 1 && _builder.transitions().size() > 1)
+                    unfoldTransitionsParallel(ptBuilder);
+                else
+                    unfoldTransitions(ptBuilder);
 
-                const auto& unfoldedPlaceMap = ptBuilder.getPlaceNames();
-                for (auto& place : _builder.places()) {
+                for (uint32_t placeId = 0; placeId < _builder.places().size(); ++placeId) {
+                    const auto& place = _builder.places()[placeId];
                     if (place.skipped) continue;
-                    handleOrphanPlace(ptBuilder, place, unfoldedPlaceMap);
+                    handleOrphanPlace(ptBuilder, place, placeId);
                 }
 
                 auto end = std::chrono::high_resolution_clock::now();
                 _time = (std::chrono::duration_cast<std::chrono::microseconds>(end - start).count())*0.000001;
             }
-            return ptBuilder;
         }
 
         //Due to the way we unfold places, we only unfold places connected to an arc (which makes sense)
@@ -80,20 +97,15 @@ namespace PetriEngine {
         //so we make a placeholder place which just has tokens equal to the number of colored tokens
         //Ideally, orphan places should just be translated to a constant in the query
 
-        void Unfolder::handleOrphanPlace(PetriNetBuilder& ptBuilder, const Colored::Place& place,
-            const shared_name_index_map& unfoldedPlaceMap) {
+        template<typename Builder>
+        void Unfolder::handleOrphanPlace(Builder& ptBuilder, const Colored::Place& place, uint32_t placeId) {
             if (_ptplacenames.count(place.name) <= 0 && place.marking.size() > 0) {
                 auto name = std::make_shared<const_string>(*place.name + "_orphan");
                 ptBuilder.addPlace(name, place.marking.size(), place._x, place._y);
                 _ptplacenames[place.name][0] = std::move(name);
             } else {
-                uint32_t usedTokens = 0;
-                bool any = false;
-                for (const auto &unfoldedPlace : _ptplacenames[place.name]) {
-                    any = true;
-                    auto unfoldedMarking = ptBuilder.initMarking();
-                    usedTokens += unfoldedMarking[unfoldedPlaceMap.find(unfoldedPlace.second)->second];
-                }
+                const uint32_t usedTokens = _unfoldedTokens[placeId];
+                const bool any = !_ptplacenames[place.name].empty();
 
                 if (place.marking.size() > usedTokens || !any) {
                     auto name = std::make_shared<const_string>(*place.name + "_orphan");
@@ -103,19 +115,23 @@ namespace PetriEngine {
             }
         }
 
-        void Unfolder::unfoldPlace(PetriNetBuilder& ptBuilder, const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t placeId, uint32_t id) {
+        template<typename Builder>
+        void Unfolder::unfoldPlace(Builder& ptBuilder, const Colored::Place* place, const PetriEngine::Colored::Color *color, uint32_t placeId, uint32_t id) {
             size_t tokenSize = 0;
             if (!_partition.computed() || _partition.partition()[placeId].isDiagonal()) {
                 tokenSize = place->marking[color];
             } else {
+                const auto &eqVec = _partition.partition()[placeId];
                 const std::vector<const Colored::Color*>& tupleColors = color->getTupleColors();
-                const size_t &tupleSize = _partition.partition()[placeId].getDiagonalTuplePositions().size();
-                const uint32_t &classId = _partition.partition()[placeId].getColorEqClassMap().find(color)->second->id();
-                const auto &diagonalTuplePos = _partition.partition()[placeId].getDiagonalTuplePositions();
-
-                for (const auto &colorEqClassPair : _partition.partition()[placeId].getColorEqClassMap()) {
-                    if (colorEqClassPair.second->id() == classId) {
-                        const std::vector<const Colored::Color*>& testColors = colorEqClassPair.first->getTupleColors();
+                const size_t &tupleSize = eqVec.getDiagonalTuplePositions().size();
+                const uint32_t classId = eqVec.getEquivalenceClass(color->getId())->id();
+                const auto &diagonalTuplePos = eqVec.getDiagonalTuplePositions();
+
+                // only marked colors contribute, so there is no need to visit the whole color type
+                for (const auto &[marked, count] : place->marking) {
+                    const auto *eqClass = eqVec.getEquivalenceClass(marked->getId());
+                    if (eqClass != nullptr && eqClass->id() == classId) {
+                        const std::vector<const Colored::Color*>& testColors = marked->getTupleColors();
                         bool match = true;
                         for (uint32_t i = 0; i < tupleSize; i++) {
                             if (diagonalTuplePos[i] && tupleColors[i]->getId() != testColors[i]->getId()) {
@@ -124,7 +140,7 @@ namespace PetriEngine {
                             }
                         }
                         if (match) {
-                            tokenSize += place->marking[colorEqClassPair.first];
+                            tokenSize += count;
                         }
                     }
                 }
@@ -132,65 +148,152 @@ namespace PetriEngine {
             auto name = std::make_shared<const_string>(*place->name + "_" + std::to_string(color->getId()));
 
             ptBuilder.addPlace(name, tokenSize, place->_x, place->_y + (15 * color->getId()));
+            _unfoldedTokens[placeId] += tokenSize;
             _ptplacenames[place->name][id] = std::move(name);
         }
 
-        void Unfolder::unfoldTransition(PetriNetBuilder& ptBuilder, uint32_t transitionId) {
-            double offset = 0;
+        template<typename Builder>
+        void Unfolder::unfoldTransitions(Builder& ptBuilder) {
+            fragment_t fragment;
+            for (uint32_t transitionId = 0; transitionId < _builder.transitions().size(); transitionId++) {
+                fragment._bindings.clear();
+                fragment._arcs.clear();
+                unfoldTransition(fragment, transitionId);
+                addTransition(ptBuilder, transitionId, fragment);
+            }
+        }
+
+        template<typename Builder>
+        void Unfolder::unfoldTransitionsParallel(Builder& ptBuilder) {
+            const uint32_t ntransitions = _builder.transitions().size();
+            std::vector<fragment_t> fragments(ntransitions);
+            auto ready = std::make_unique<std::atomic<bool>[]>(ntransitions);
+            for (uint32_t i = 0; i < ntransitions; ++i)
+                ready[i] = false;
+            std::atomic<uint32_t> next{0};
+            std::atomic<uint32_t> added{0};
+            std::atomic<bool> stop{false};
+            std::mutex errorLock;
+            std::exception_ptr error;
+            // finished fragments wait for the ones before them, so only compute a bounded number ahead
+            const uint32_t window = 16 * _threads;
+
+            auto fail = [&] {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+            };
+
+            // computes an unclaimed transition within the window, returns false if there is none
+            auto help = [&] {
+                uint32_t t = next.load();
+                if (t >= ntransitions || t >= added.load() + window || !next.compare_exchange_weak(t, t + 1))
+                    return false;
+                try {
+                    unfoldTransition(fragments[t], t);
+                }
+                catch (...) {
+                    fail();
+                }
+                ready[t].store(true, std::memory_order_release);
+                return true;
+            };
+
+            std::vector<std::thread> workers;
+            const uint32_t nworkers = std::min(_threads, ntransitions) - 1;
+            for (uint32_t w = 0; w < nworkers; ++w) {
+                workers.emplace_back([&] {
+                    while (!stop && next.load() < ntransitions) {
+                        if (!help())
+                            std::this_thread::yield();
+                    }
+                });
+            }
+
+            // fragments are added in transition order, so the unfolded net is the same as the sequential one
+            try {
+                for (uint32_t transitionId = 0; transitionId < ntransitions && !stop; ++transitionId) {
+                    while (!stop && !ready[transitionId].load(std::memory_order_acquire)) {
+                        if (!help())
+                            std::this_thread::yield();
+                    }
+                    if (stop)
+                        break;
+                    addTransition(ptBuilder, transitionId, fragments[transitionId]);
+                    fragments[transitionId] = fragment_t();
+                    added.store(transitionId + 1);
+                }
+            }
+            catch (...) {
+                fail();
+            }
+            stop = true;
+            for (auto& w : workers)
+                w.join();
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        void Unfolder::unfoldTransition(fragment_t& fragment, uint32_t transitionId) const {
             const Colored::Transition &transition = _builder.transitions()[transitionId];
             if (transition.skipped) return;
+            auto unfoldBinding = [&](const Colored::BindingMap& b) {
+                auto name = std::make_shared<const_string>(*transition.name + "_" + std::to_string(fragment._bindings.size()));
+                for (const auto& arc : transition.input_arcs) {
+                    unfoldArc(fragment, arc, b);
+                }
+                for (const auto& arc : transition.output_arcs) {
+                    unfoldArc(fragment, arc, b);
+                }
+                fragment._bindings.push_back(unfolded_binding_t{std::move(name),
+                    _print_bindings ? b : Colored::BindingMap(), fragment._arcs.size()});
+            };
             if (_fixed_point.computed() || _partition.computed()) {
                 assert(_fixed_point.variable_map().size() > transitionId);
                 assert(_symmetry.symmetries().size() > transitionId);
                 FixpointBindingGenerator gen(transition, _builder.colors(), _symmetry.symmetries()[transitionId],
                     _fixed_point.variable_map()[transitionId]);
-                size_t i = 0;
-                bool hasBindings = false;
                 for (const auto &b : gen) {
-                    auto name = std::make_shared<const_string>(*transition.name + "_" + std::to_string(i++));
-
-                    storeBinding(name, b);
-                   
-                    hasBindings = true;
-                    ptBuilder.addTransition(name, transition._player, transition._x, transition._y + offset);
-                    offset += 15;
-
-                    for (auto& arc : transition.input_arcs) {
-                        unfoldArc(ptBuilder, arc, b, name);
-                    }
-                    for (auto& arc : transition.output_arcs) {
-                        unfoldArc(ptBuilder, arc, b, name);
-                    }
-
-                    _pttransitionnames[transition.name].push_back(name);
-                    unfoldInhibitorArc(ptBuilder, transition.name, name);
-                }
-                if (!hasBindings) {
-                    _pttransitionnames[transition.name] = std::vector<shared_const_string>();
+                    unfoldBinding(b);
                 }
             } else {
                 NaiveBindingGenerator gen(transition, _builder.colors());
-                size_t i = 0;
                 for (const auto &b : gen) {
-                    auto name = std::make_shared<const_string>(*transition.name + "_" + std::to_string(i++));
-                    ptBuilder.addTransition(name, transition._player, transition._x, transition._y + offset);
-                    offset += 15;
+                    unfoldBinding(b);
+                }
+            }
+        }
+
+        template<typename Builder>
+        void Unfolder::addTransition(Builder& ptBuilder, uint32_t transitionId, const fragment_t& fragment) {
+            const Colored::Transition &transition = _builder.transitions()[transitionId];
+            if (transition.skipped) return;
+            double offset = 0;
+            size_t arc = 0;
+            for (const auto& binding : fragment._bindings) {
+                ptBuilder.addTransition(binding._name, transition._player, transition._x, transition._y + offset);
+                offset += 15;
 
-                    storeBinding(name, b);
+                storeBinding(binding._name, binding._binding);
 
-                    for (const auto& arc : transition.input_arcs) {
-                        unfoldArc(ptBuilder, arc, b, name);
-                    }
-                    for (const auto& arc : transition.output_arcs) {
-                        unfoldArc(ptBuilder, arc, b, name);
-                    }
-                    _pttransitionnames[transition.name].push_back(name);
-                    unfoldInhibitorArc(ptBuilder, transition.name, name);
+                for (; arc < binding._arcs_end; ++arc) {
+                    addArc(ptBuilder, fragment._arcs[arc], binding._name);
+                }
+                if constexpr (std::is_same_v<Builder, PetriNetBuilder>) {
+                    _pttransitionnames[transition.name].push_back(binding._name);
+                }
+                unfoldInhibitorArc(ptBuilder, transition.name, binding._name);
+            }
+            if constexpr (std::is_same_v<Builder, PetriNetBuilder>) {
+                if (fragment._bindings.empty() && (_fixed_point.computed() || _partition.computed())) {
+                    _pttransitionnames[transition.name] = std::vector<shared_const_string>();
                 }
             }
         }
 
-        void Unfolder::unfoldInhibitorArc(PetriNetBuilder& ptBuilder, const shared_const_string &oldname, const shared_const_string &newname) {
+        template<typename Builder>
+        void Unfolder::unfoldInhibitorArc(Builder& ptBuilder, const shared_const_string &oldname, const shared_const_string &newname) {
             for (uint32_t i = 0; i < _builder.inhibitors().size(); ++i) {
                 if (*_builder.transitions()[_builder.inhibitors()[i].transition].name == *oldname) {
                     const Colored::Arc &inhibArc = _builder.inhibitors()[i];
@@ -203,6 +306,7 @@ namespace PetriEngine {
                         ptBuilder.addPlace(sumPlaceName, place.marking.size(), place._x + 30, place._y - 30);
                         if (_ptplacenames.count(place.name) <= 0) {
                             _ptplacenames[place.name][place.type->size()] = sumPlaceName;
+                            _unfoldedTokens[inhibArc.place] += place.marking.size();
                         }
                         placeName = _sumPlacesNames[inhibArc.place] = std::move(sumPlaceName);
                     }
@@ -211,7 +315,7 @@ namespace PetriEngine {
             }
         }
 
-        void Unfolder::unfoldArc(PetriNetBuilder& ptBuilder, const Colored::Arc& arc, const Colored::BindingMap& binding, const shared_const_string& tName) {
+        void Unfolder::unfoldArc(fragment_t& fragment, const Colored::Arc& arc, const Colored::BindingMap& binding) const {
             const PetriEngine::Colored::Place& place = _builder.places()[arc.place];
             //If the place is stable, the arc does not need to be unfolded.
             //This exploits the fact that since the transition is being unfolded with this binding
@@ -221,8 +325,8 @@ namespace PetriEngine {
             assert(_partition.partition().size() > arc.place);
             const Colored::ExpressionContext context{binding, _builder.colors(), _partition.partition()[arc.place]};
             const auto ms = Colored::EvaluationVisitor::evaluate(*arc.expr, context);
-            int shadowWeight = 0;
-            
+            uint32_t shadowWeight = 0;
+
             const Colored::Color *newColor;
             std::vector<uint32_t> tupleIds;
             for (const auto& color : ms) {
@@ -247,43 +351,53 @@ namespace PetriEngine {
                 } else {
                     id = _partition.partition()[arc.place].getUniqueIdForColor(newColor);
                 }
-                auto pName = _ptplacenames[place.name][id];
+                fragment._arcs.push_back(unfolded_arc_t{newColor, arc.place, id, color.second, arc.input});
+            }
+
+            // the sum place is created even if no tokens are moved
+            if (place.inhibitor) {
+                fragment._arcs.push_back(unfolded_arc_t{nullptr, arc.place, 0, shadowWeight, arc.input});
+            }
+        }
+
+        template<typename Builder>
+        void Unfolder::addArc(Builder& ptBuilder, const unfolded_arc_t& arc, const shared_const_string& tName) {
+            const PetriEngine::Colored::Place& place = _builder.places()[arc._place];
+            if (arc._color != nullptr) {
+                auto pName = _ptplacenames[place.name][arc._id];
 
                 if (pName == nullptr || pName->empty()) {
-                    unfoldPlace(ptBuilder, &place, newColor, arc.place, id);
-                    pName = _ptplacenames[place.name][id];
+                    unfoldPlace(ptBuilder, &place, arc._color, arc._place, arc._id);
+                    pName = _ptplacenames[place.name][arc._id];
                 }
 
-                if (arc.input) {
-                    ptBuilder.addInputArc(pName, tName, false, color.second);
+                if (arc._input) {
+                    ptBuilder.addInputArc(pName, tName, false, arc._weight);
                 } else {
-                    ptBuilder.addOutputArc(tName, pName, color.second);
+                    ptBuilder.addOutputArc(tName, pName, arc._weight);
                 }
                 ++_nptarcs;
+                return;
             }
 
-            if (place.inhibitor) {
-                if (_sumPlacesNames.size() <= arc.place) _sumPlacesNames.resize(arc.place + 1);
-                auto& sumPlaceName = _sumPlacesNames[arc.place];
-                if (sumPlaceName == nullptr || sumPlaceName->empty()) {
-                    auto newSumPlaceName = std::make_shared<const_string>(*place.name + "Sum");
-                    ptBuilder.addPlace(newSumPlaceName, place.marking.size(), place._x + 30, place._y - 30);
-                    sumPlaceName = _sumPlacesNames[arc.place] = std::move(newSumPlaceName);
-                }
-
+            if (_sumPlacesNames.size() <= arc._place) _sumPlacesNames.resize(arc._place + 1);
+            auto& sumPlaceName = _sumPlacesNames[arc._place];
+            if (sumPlaceName == nullptr || sumPlaceName->empty()) {
+                auto newSumPlaceName = std::make_shared<const_string>(*place.name + "Sum");
+                ptBuilder.addPlace(newSumPlaceName, place.marking.size(), place._x + 30, place._y - 30);
+                sumPlaceName = _sumPlacesNames[arc._place] = std::move(newSumPlaceName);
+            }
 
-                if (shadowWeight > 0) {
-                    if (!arc.input) {
-                        ptBuilder.addOutputArc(tName, sumPlaceName, shadowWeight);
-                    } else {
-                        ptBuilder.addInputArc(sumPlaceName, tName, false, shadowWeight);
-                    }
-                    ++_nptarcs;
+            if (arc._weight > 0) {
+                if (!arc._input) {
+                    ptBuilder.addOutputArc(tName, sumPlaceName, arc._weight);
+                } else {
+                    ptBuilder.addInputArc(sumPlaceName, tName, false, arc._weight);
                 }
+                ++_nptarcs;
             }
         }
 
-    
         void Unfolder::storeBinding(const shared_const_string& name, const Colored::BindingMap& binding) {
             if (_print_bindings) { 
                 Colored::BindingMap b;
@@ -10,6 +10,14 @@
 #include "PetriEngine/ExplicitColored/Algorithms/ColoredSearchTypes.h"
 #include "PetriEngine/ExplicitColored/FireabilityChecker.h"
 #include "PetriEngine/ExplicitColored/ExplicitErrors.h"
+#include "PetriEngine/ExplicitColored/Algorithms/ConcurrentPassedSet.h"
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 namespace PetriEngine::ExplicitColored {
     ExplicitWorklist::ExplicitWorklist(
@@ -18,11 +26,15 @@ namespace PetriEngine::ExplicitColored {
         const std::unordered_map<std::string, uint32_t>& placeNameIndices,
         const std::unordered_map<std::string, Transition_t>& transitionNameIndices,
         const size_t seed,
-        bool createTrace
+        bool createTrace,
+        const uint32_t threads,
+        const bool compactWaiting
     ) : _net(std::move(net)),
         _successorGenerator(ColoredSuccessorGenerator{_net}),
         _seed(seed),
-        _createTrace(createTrace)
+        _createTrace(createTrace),
+        _threads(std::max<uint32_t>(threads, 1)),
+        _compactWaiting(compactWaiting)
     {
         const ExplicitQueryPropositionCompiler queryCompiler(placeNameIndices, transitionNameIndices, _successorGenerator);
         if (const auto efGammaQuery = dynamic_cast<PQL::EFCondition*>(query.get())) {
@@ -77,21 +89,35 @@ namespace PetriEngine::ExplicitColored {
 
     template <template <typename> typename WaitingList, typename T>
     bool ExplicitWorklist::_genericSearch(WaitingList<T> waiting) {
-        ptrie::set<uint8_t> passed;
+        // the compact waiting list decodes markings from the passed list, which must then be stable
+        constexpr bool compact = IsCompactStructure<WaitingList<T>>::value;
+        std::conditional_t<compact, ptrie::set_stable<uint8_t>, ptrie::set<uint8_t>> passed;
         ColoredEncoder encoder = ColoredEncoder{_net.getPlaces()};
         const auto& initialState = _net.initial();
         const auto earlyTerminationCondition = _quantifier == Quantifier::EF;
+        const auto addWaiting = [&](T state, const size_t encodingId, const size_t encodingSize) {
+            if constexpr (compact) {
+                // a truncated encoding cannot be decoded, so such a state keeps its marking
+                waiting.add(std::move(state), ColoredEncoder::isComplete(encodingSize)
+                    ? std::optional<size_t>(encodingId) : std::nullopt);
+            } else {
+                waiting.add(std::move(state));
+            }
+        };
+        if constexpr (compact) {
+            waiting.attach(passed, encoder);
+        }
 
         auto size = encoder.encode(initialState);
-        passed.insert(encoder.data(), size);
+        const auto initialEncoding = passed.insert(encoder.data(), size).second;
         if constexpr (std::is_same_v<T, ColoredPetriNetStateEven>) {
             auto initial = ColoredPetriNetStateEven{initialState, _net.getTransitionCount()};
             initial.id = 0;
-            waiting.add(std::move(initial));
+            addWaiting(std::move(initial), initialEncoding, size);
         } else {
             auto initial = ColoredPetriNetStateFixed{initialState};
             initial.id = 0;
-            waiting.add(std::move(initial));
+            addWaiting(std::move(initial), initialEncoding, size);
         }
 
         _searchStatistics.exploredStates = 1;
@@ -109,8 +135,9 @@ namespace PetriEngine::ExplicitColored {
             auto& next = waiting.next();
             auto [successor, traceStep] = _successorGenerator.next(next);
             if (next.done()) {
+                const auto doneId = next.id;
                 waiting.remove();
-                _successorGenerator.shrinkState(next.id);
+                _successorGenerator.shrinkState(doneId);
                 continue;
             }
 
@@ -137,8 +164,8 @@ namespace PetriEngine::ExplicitColored {
                     _counterExampleId = successor.id;
                     return _getResult(true, encoder.isFullStatespace());
                 }
-                waiting.add(std::move(successor));
-                passed.insert(encoder.data(), size);
+                const auto encodingId = passed.insert(encoder.data(), size).second;
+                addWaiting(std::move(successor), encodingId, size);
                 _searchStatistics.peakWaitingStates = std::max(waiting.size(), _searchStatistics.peakWaitingStates);
             }
         }
@@ -148,6 +175,191 @@ namespace PetriEngine::ExplicitColored {
         return _getResult(false, encoder.isFullStatespace());
     }
 
+    // Each worker owns a successor generator (and with it the constraint cache), an encoder and a
+    // waiting list. States are checked and expanded completely by the worker that takes them, so the
+    // constraint data cached for a state is released by the same generator; idle workers steal from
+    // the waiting lists of the others.
+    template <template <typename> typename WaitingList, typename T, typename F>
+    bool ExplicitWorklist::_parallelSearch(F makeWaiting) {
+        struct Worker {
+            std::mutex lock;
+            WaitingList<T> waiting;
+            // partly expanded states put aside for a shuffle; only this worker's generator has their
+            // binding data, so they are never stolen
+            std::deque<T> partial;
+            ColoredSuccessorGenerator successorGenerator;
+            ColoredEncoder encoder;
+            SearchStatistics searchStatistics;
+
+            Worker(WaitingList<T> waiting, const ColoredPetriNet& net, std::atomic<size_t>& ids)
+                : waiting(std::move(waiting)), successorGenerator(net, ids), encoder(net.getPlaces()) {}
+        };
+
+        std::atomic<size_t> ids {1};
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (uint32_t w = 0; w < _threads; ++w) {
+            workers.emplace_back(std::make_unique<Worker>(makeWaiting(w), _net, ids));
+        }
+        ConcurrentPassedSet passed(_threads);
+        const auto& initialState = _net.initial();
+        const auto earlyTerminationCondition = _quantifier == Quantifier::EF;
+
+        auto fullStatespace = [&] {
+            bool full = true;
+            for (const auto& worker : workers) {
+                full &= worker->encoder.isFullStatespace();
+                _searchStatistics.biggestEncoding = std::max(_searchStatistics.biggestEncoding, worker->encoder.getBiggestEncoding());
+            }
+            return full;
+        };
+
+        auto size = workers[0]->encoder.encode(initialState);
+        passed.insert(workers[0]->encoder.data(), size);
+        _searchStatistics.exploredStates = 1;
+        _searchStatistics.discoveredStates = 1;
+
+        if (_check(initialState, 0) == earlyTerminationCondition) {
+            _counterExampleId = 0;
+            return _getResult(true, fullStatespace());
+        }
+        if (_net.getTransitionCount() == 0) {
+            return _getResult(false, fullStatespace());
+        }
+
+        if constexpr (std::is_same_v<T, ColoredPetriNetStateEven>) {
+            auto initial = ColoredPetriNetStateEven{initialState, _net.getTransitionCount()};
+            initial.id = 0;
+            workers[0]->waiting.add(std::move(initial));
+        } else {
+            auto initial = ColoredPetriNetStateFixed{initialState};
+            initial.id = 0;
+            workers[0]->waiting.add(std::move(initial));
+        }
+
+        std::atomic<bool> stop {false};
+        // states in some waiting list or being expanded; the search is over when it reaches zero
+        std::atomic<size_t> pending {1};
+        std::mutex resultLock;
+        std::mutex traceLock;
+        std::exception_ptr error;
+
+        // resumed is set for a state taken back from the partial states, which has been checked already
+        auto take = [&](const size_t w, bool& resumed) -> std::optional<T> {
+            for (size_t n = 0; n < workers.size(); ++n) {
+                auto& worker = *workers[(w + n) % workers.size()];
+                std::unique_lock guard(worker.lock, std::defer_lock);
+                if (n == 0) {
+                    guard.lock();
+                } else if (!guard.try_lock()) {
+                    continue;
+                }
+                if (!worker.waiting.empty()) {
+                    std::optional<T> state {std::move(worker.waiting.next())};
+                    worker.waiting.remove();
+                    resumed = false;
+                    return state;
+                }
+                if (n == 0 && !worker.partial.empty()) {
+                    std::optional<T> state {std::move(worker.partial.front())};
+                    worker.partial.pop_front();
+                    resumed = true;
+                    return state;
+                }
+            }
+            return std::nullopt;
+        };
+
+        auto work = [&](const size_t w) {
+            try {
+                auto& self = *workers[w];
+                while (!stop) {
+                    bool resumed = false;
+                    auto next = take(w, resumed);
+                    if (!next.has_value()) {
+                        if (pending.load() == 0) {
+                            break;
+                        }
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (!resumed && next->id != 0
+                        && _gammaQuery->eval(self.successorGenerator, next->marking, next->id) == earlyTerminationCondition) {
+                        std::lock_guard guard(resultLock);
+                        if (!_counterExampleId.has_value()) {
+                            _counterExampleId = next->id;
+                        }
+                        stop = true;
+                        break;
+                    }
+                    bool requeued = false;
+                    while (!stop) {
+                        auto [successor, traceStep] = self.successorGenerator.next(*next);
+                        if (next->done()) {
+                            break;
+                        }
+
+                        if constexpr (std::is_same_v<T, ColoredPetriNetStateEven>) {
+                            if (next->shuffle) {
+                                // give the other states a turn, as the sequential search does
+                                next->shuffle = false;
+                                self.partial.push_back(std::move(*next));
+                                requeued = true;
+                                break;
+                            }
+                        }
+
+                        successor.shrink();
+                        const auto& marking = successor.marking;
+                        const auto encodingSize = self.encoder.encode(marking);
+                        self.searchStatistics.discoveredStates++;
+                        if (!passed.insert(self.encoder.data(), encodingSize)) {
+                            continue;
+                        }
+                        if (_createTrace) {
+                            std::lock_guard guard(traceLock);
+                            _stateMap.transitions.emplace(successor.id, traceStep);
+                        }
+                        self.searchStatistics.exploredStates += 1;
+                        ++pending;
+                        std::lock_guard guard(self.lock);
+                        self.waiting.add(std::move(successor));
+                        self.searchStatistics.peakWaitingStates = std::max(self.waiting.size(), self.searchStatistics.peakWaitingStates);
+                    }
+                    if (!requeued) {
+                        self.successorGenerator.shrinkState(next->id);
+                        --pending;
+                    }
+                }
+            } catch (...) {
+                std::lock_guard guard(resultLock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                stop = true;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t w = 1; w < _threads; ++w) {
+            threads.emplace_back(work, w);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        for (const auto& worker : workers) {
+            _searchStatistics.exploredStates += worker->searchStatistics.exploredStates;
+            _searchStatistics.discoveredStates += worker->searchStatistics.discoveredStates;
+            _searchStatistics.peakWaitingStates = std::max(_searchStatistics.peakWaitingStates, worker->searchStatistics.peakWaitingStates);
+            _searchStatistics.endWaitingStates += worker->waiting.size() + worker->partial.size();
+        }
+        return _getResult(_counterExampleId.has_value(), fullStatespace());
+    }
+
     template<typename SuccessorGeneratorState>
     bool ExplicitWorklist::_search(const Strategy searchStrategy) {
         switch (searchStrategy) {
@@ -167,21 +379,48 @@ namespace PetriEngine::ExplicitColored {
 
     template <typename T>
     bool ExplicitWorklist::_dfs() {
+        if (_threads > 1) {
+            return _parallelSearch<DFSStructure, T>([](size_t) { return DFSStructure<T> {}; });
+        }
+        if (_compactWaiting) {
+            return _genericSearch<Compact<DFSStructure>::Structure>(Compact<DFSStructure>::Structure<T> {});
+        }
         return _genericSearch<DFSStructure>(DFSStructure<T> {});
     }
 
     template <typename T>
     bool ExplicitWorklist::_bfs() {
+        if (_threads > 1) {
+            return _parallelSearch<BFSStructure, T>([](size_t) { return BFSStructure<T> {}; });
+        }
+        if (_compactWaiting) {
+            return _genericSearch<Compact<BFSStructure>::Structure>(Compact<BFSStructure>::Structure<T> {});
+        }
         return _genericSearch<BFSStructure>(BFSStructure<T> {});
     }
 
     template <typename T>
     bool ExplicitWorklist::_rdfs() {
+        if (_threads > 1) {
+            return _parallelSearch<RDFSStructure, T>([this](const size_t w) { return RDFSStructure<T>(_seed + w); });
+        }
+        if (_compactWaiting) {
+            return _genericSearch<Compact<RDFSStructure>::Structure>(Compact<RDFSStructure>::Structure<T>(_seed));
+        }
         return _genericSearch<RDFSStructure>(RDFSStructure<T>(_seed));
     }
 
     template <typename T>
     bool ExplicitWorklist::_bestfs() {
+        if (_threads > 1) {
+            return _parallelSearch<BestFSStructure, T>([this](const size_t w) {
+                return BestFSStructure<T>(_seed + w, _gammaQuery, _quantifier == Quantifier::AG);
+            });
+        }
+        if (_compactWaiting) {
+            return _genericSearch<Compact<BestFSStructure>::Structure>(
+                Compact<BestFSStructure>::Structure<T>(_seed, _gammaQuery, _quantifier == Quantifier::AG));
+        }
         return _genericSearch<BestFSStructure>(
             BestFSStructure<T>(
                 _seed,
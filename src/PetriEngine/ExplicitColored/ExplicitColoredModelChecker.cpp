@@ -261,7 +261,12 @@ namespace PetriEngine::ExplicitColored {
 
         auto net = cpnBuilder.takeNet();
 
-        ExplicitWorklist worklist(net, query, cpnBuilder.getPlaceIndices(), cpnBuilder.getTransitionIndices(), options.seed(), options.trace != TraceLevel::None);
+#ifdef VERIFYPN_MultiCore
+        const uint32_t threads = options.cores;
+#else
+        const uint32_t threads = 1;
+#endif
+        ExplicitWorklist worklist(net, query, cpnBuilder.getPlaceIndices(), cpnBuilder.getTransitionIndices(), options.seed(), options.trace != TraceLevel::None, threads, options.colored_compact_waiting);
         bool result = worklist.check(options.strategy, options.colored_sucessor_generator);
 
         if (searchStatistics) {
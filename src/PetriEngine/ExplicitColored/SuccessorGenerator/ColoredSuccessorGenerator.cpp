@@ -8,6 +8,9 @@ namespace PetriEngine::ExplicitColored{
     ColoredSuccessorGenerator::ColoredSuccessorGenerator(const ColoredPetriNet& net)
     : _net(net) {}
 
+    ColoredSuccessorGenerator::ColoredSuccessorGenerator(const ColoredPetriNet& net, std::atomic<size_t>& sharedIds)
+    : _sharedIds(&sharedIds), _net(net) {}
+
     void updateVariableMap(std::map<Variable_t, std::vector<uint32_t>>& map, const std::map<Variable_t, std::vector<uint32_t>>& newMap){
         for (auto&& pair : newMap){
             if (map.find(pair.first) != map.end()){
@@ -0,0 +1,133 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/IncrementalSuccessorGenerator.h"
+
+#include <algorithm>
+
+namespace PetriEngine {
+
+    IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const PetriNet& net)
+    : SuccessorGenerator(net)
+    {
+        const auto nplaces = _net.numberOfPlaces();
+        const auto ntrans = _net.numberOfTransitions();
+        _consumerPtrs.resize(nplaces + 1, 0);
+        for (uint32_t t = 0; t < ntrans; ++t) {
+            const TransPtr& ptr = _net._transitions[t];
+            for (uint32_t i = ptr.inputs; i < ptr.outputs; ++i)
+                ++_consumerPtrs[_net._invariants[i].place + 1];
+        }
+        for (uint32_t p = 0; p < nplaces; ++p)
+            _consumerPtrs[p + 1] += _consumerPtrs[p];
+        _consumers.resize(_consumerPtrs[nplaces]);
+        std::vector<uint32_t> next(_consumerPtrs.begin(), _consumerPtrs.end() - 1);
+        for (uint32_t t = 0; t < ntrans; ++t) {
+            const TransPtr& ptr = _net._transitions[t];
+            for (uint32_t i = ptr.inputs; i < ptr.outputs; ++i)
+                _consumers[next[_net._invariants[i].place]++] = t;
+        }
+        _enabled.resize((ntrans + 63) / 64, 0);
+        _marking.resize(nplaces, 0);
+    }
+
+    IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const PetriNet& net, const std::shared_ptr<StubbornSet>&)
+    : IncrementalSuccessorGenerator(net) {}
+
+    IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const PetriNet& net, std::vector<std::shared_ptr<PQL::Condition> >&)
+    : IncrementalSuccessorGenerator(net) {}
+
+    IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(const PetriNet& net, const std::shared_ptr<PQL::Condition>&)
+    : IncrementalSuccessorGenerator(net) {}
+
+    bool IncrementalSuccessorGenerator::prepare(const Structures::State* state)
+    {
+        SuccessorGenerator::prepare(state, 0);
+        _cursor = 0;
+        if (!_valid || !update(state->marking()))
+            rebuild();
+        return true;
+    }
+
+    void IncrementalSuccessorGenerator::rebuild()
+    {
+        const MarkVal* marking = _parent->marking();
+        std::fill(_enabled.begin(), _enabled.end(), 0);
+        std::copy(marking, marking + _net._nplaces, _marking.begin());
+        // same traversal as SuccessorGenerator::_next, orphans are under place 0
+        for (uint32_t p = 0; p < _net._nplaces; ++p) {
+            if (p != 0 && marking[p] == 0)
+                continue;
+            for (uint32_t t = _net._placeToPtrs[p]; t != _net._placeToPtrs[p + 1]; ++t) {
+                if (checkPreset(t))
+                    set(t, true);
+            }
+        }
+        _valid = true;
+        ++_rebuilds;
+    }
+
+    bool IncrementalSuccessorGenerator::update(const MarkVal* marking)
+    {
+        // compare in blocks so the common case of equal places vectorizes
+        constexpr uint32_t BLOCK = 16;
+        const uint32_t nplaces = _net._nplaces;
+        size_t work = 0;
+        _changed.clear();
+        for (uint32_t b = 0; b < nplaces; b += BLOCK) {
+            const uint32_t e = std::min(nplaces, b + BLOCK);
+            MarkVal diff = 0;
+            for (uint32_t p = b; p < e; ++p)
+                diff |= marking[p] ^ _marking[p];
+            if (diff == 0)
+                continue;
+            for (uint32_t p = b; p < e; ++p) {
+                if (marking[p] == _marking[p])
+                    continue;
+                _changed.push_back(p);
+                work += _consumerPtrs[p + 1] - _consumerPtrs[p];
+                // rechecking more than a rebuild would is not worth it
+                if (work > _net._ntransitions)
+                    return false;
+            }
+        }
+
+        for (auto p : _changed) {
+            _marking[p] = marking[p];
+            for (uint32_t i = _consumerPtrs[p]; i < _consumerPtrs[p + 1]; ++i)
+                set(_consumers[i], checkPreset(_consumers[i]));
+        }
+        ++_updates;
+        return true;
+    }
+
+    bool IncrementalSuccessorGenerator::next(Structures::State& write)
+    {
+        while (_cursor < _net._ntransitions) {
+            const uint32_t w = _cursor / 64;
+            const uint64_t word = _enabled[w] & (~uint64_t{0} << (_cursor % 64));
+            if (word == 0) {
+                _cursor = (w + 1) * 64;
+                continue;
+            }
+            const uint32_t t = w * 64 + __builtin_ctzll(word);
+            _cursor = t + 1;
+            _fire(write, t);
+            return true;
+        }
+        return false;
+    }
+}
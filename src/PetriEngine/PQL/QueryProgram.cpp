@@ -0,0 +1,989 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/PQL/QueryProgram.h"
+#include "PetriEngine/PQL/Expressions.h"
+#include "PetriEngine/PQL/Evaluation.h"
+#include "PetriEngine/PQL/Visitor.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QUERYPROGRAM_AVX2
+#define QUERYPROGRAM_INLINE inline __attribute__((always_inline))
+#else
+#define QUERYPROGRAM_INLINE inline
+#endif
+
+namespace PetriEngine { namespace PQL {
+
+    /**
+     * Emits the code of a condition in postfix order. The value of every node
+     * is left in a slot of its own, except for nodes that only forward the
+     * value of a child (shallow conditions, path selections, identifiers),
+     * which share the slot of the child.
+     */
+    class QueryCompiler : public Visitor {
+    public:
+        explicit QueryCompiler(QueryProgram& program) : _program(program) {}
+
+        QueryProgram::range_t condition(const Condition* element)
+        {
+            auto begin = static_cast<uint32_t>(_program._code.size());
+            Visitor::visit(this, element);
+            QueryProgram::range_t range{begin, static_cast<uint32_t>(_program._code.size()), _slot};
+            _program._conditions.emplace(element, range);
+            return range;
+        }
+
+    protected:
+        using op_t = QueryProgram::op_t;
+
+        uint32_t expression(const Expr* element)
+        {
+            Visitor::visit(this, element);
+            _program._expressions.emplace(element, _slot);
+            return _slot;
+        }
+
+        uint32_t slot(int64_t initial)
+        {
+            _program._initial.push_back(initial);
+            return _program._initial.size() - 1;
+        }
+
+        size_t emit(op_t op, uint32_t dst, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, int64_t value = 0)
+        {
+            _program._code.push_back(QueryProgram::instruction_t{op, dst, a, b, c, value});
+            _slot = dst;
+            return _program._code.size() - 1;
+        }
+
+        void set_target(size_t instruction)
+        {
+            _program._code[instruction]._b = _program._code.size();
+        }
+
+        void constant(Condition::Result value)
+        {
+            emit(op_t::SET, slot(Condition::RUNKNOWN), 0, 0, 0, value);
+        }
+
+        void fallback(const Condition* element)
+        {
+            _program._fallbacks.push_back(const_cast<Condition*>(element));
+            emit(op_t::FALLBACK, slot(Condition::RUNKNOWN), _program._fallbacks.size() - 1);
+        }
+
+        template<typename T>
+        void unary(op_t op, const T* element)
+        {
+            auto child = condition((*element)[0].get())._slot;
+            emit(op, slot(Condition::RUNKNOWN), child);
+        }
+
+        template<typename T>
+        void logical(op_t op, const T* element)
+        {
+            auto dst = slot(Condition::RUNKNOWN);
+            emit(op_t::SET, dst, 0, 0, 0, op == op_t::AND ? Condition::RTRUE : Condition::RFALSE);
+            std::vector<size_t> jumps;
+            for (auto& c : *element)
+                jumps.push_back(emit(op, dst, condition(c.get())._slot));
+            for (auto j : jumps)
+                set_target(j);
+            _slot = dst;
+        }
+
+        void compare(op_t op, const CompareCondition* element)
+        {
+            auto a = expression(element->getExpr1().get());
+            auto b = expression(element->getExpr2().get());
+            emit(op, slot(Condition::RUNKNOWN), a, b);
+        }
+
+        template<typename T>
+        void commutative(op_t op, const T* element)
+        {
+            // the operands of the children go first, the operands of an instruction must be consecutive
+            std::vector<uint32_t> children;
+            for (auto& e : element->expressions())
+                children.push_back(expression(e.get()));
+            auto first = static_cast<uint32_t>(_program._operands.size());
+            for (auto& p : element->places())
+                _program._operands.push_back(p.first);
+            _program._operands.insert(_program._operands.end(), children.begin(), children.end());
+            emit(op, slot(0), first, element->places().size(), children.size(), element->constant());
+        }
+
+        void _accept(const NotCondition* element) override { unary(op_t::NOT, element); }
+
+        void _accept(const AndCondition* element) override { logical(op_t::AND, element); }
+
+        void _accept(const OrCondition* element) override { logical(op_t::OR, element); }
+
+        void _accept(const LessThanCondition* element) override { compare(op_t::LESS, element); }
+
+        void _accept(const LessThanOrEqualCondition* element) override { compare(op_t::LESS_EQUAL, element); }
+
+        void _accept(const EqualCondition* element) override { compare(op_t::EQUAL, element); }
+
+        void _accept(const NotEqualCondition* element) override { compare(op_t::NOT_EQUAL, element); }
+
+        void _accept(const DeadlockCondition* element) override
+        {
+            emit(op_t::DEADLOCK, slot(Condition::RUNKNOWN));
+        }
+
+        void _accept(const CompareConjunction* element) override
+        {
+            auto first = static_cast<uint32_t>(_program._constraints.size());
+            for (auto& c : element->constraints())
+                _program._constraints.push_back(QueryProgram::constraint_t{c._place, c._lower, c._upper});
+            emit(op_t::CONJUNCTION, slot(Condition::RUNKNOWN), first, element->constraints().size(),
+                 element->isNegated() ? 1 : 0);
+        }
+
+        void _accept(const UnfoldedUpperBoundsCondition* element) override { fallback(element); }
+
+        void _accept(const UpperBoundsCondition* element) override
+        {
+            if (element->getCompiled())
+                condition(element->getCompiled().get());
+            else
+                constant(Condition::RUNKNOWN);
+        }
+
+        void _accept(const ShallowCondition* element) override
+        {
+            if (element->getCompiled())
+                condition(element->getCompiled().get());
+            else
+                fallback(element);
+        }
+
+        void _accept(const BooleanCondition* element) override
+        {
+            constant(element->value ? Condition::RTRUE : Condition::RFALSE);
+        }
+
+        void _accept(const ControlCondition* element) override { constant(Condition::RUNKNOWN); }
+
+        // the children of next-state operators are never evaluated with their
+        // parent, but are compiled so they can be evaluated on their own
+        void _accept(const SimpleQuantifierCondition* element) override
+        {
+            auto jump = emit(op_t::JUMP, 0);
+            condition((*element)[0].get());
+            set_target(jump);
+            constant(Condition::RUNKNOWN);
+        }
+
+        void _accept(const EFCondition* element) override { unary(op_t::EVENTUALLY, element); }
+
+        void _accept(const AFCondition* element) override { unary(op_t::EVENTUALLY, element); }
+
+        void _accept(const ECondition* element) override { unary(op_t::EVENTUALLY, element); }
+
+        void _accept(const FCondition* element) override { unary(op_t::EVENTUALLY, element); }
+
+        void _accept(const EGCondition* element) override { unary(op_t::ALWAYS, element); }
+
+        void _accept(const AGCondition* element) override { unary(op_t::ALWAYS, element); }
+
+        void _accept(const ACondition* element) override { unary(op_t::ALWAYS, element); }
+
+        void _accept(const GCondition* element) override { unary(op_t::ALWAYS, element); }
+
+        void _accept(const ExistPath* element) override
+        {
+            auto child = condition(element->child().get())._slot;
+            emit(op_t::EVENTUALLY, slot(Condition::RUNKNOWN), child);
+        }
+
+        void _accept(const AllPaths* element) override
+        {
+            auto child = condition(element->child().get())._slot;
+            emit(op_t::ALWAYS, slot(Condition::RUNKNOWN), child);
+        }
+
+        void _accept(const PathQuant* element) override { condition(element->child().get()); }
+
+        void _accept(const PathSelectCondition* element) override { condition(element->child().get()); }
+
+        void _accept(const UntilCondition* element) override
+        {
+            auto dst = slot(Condition::RUNKNOWN);
+            auto holds = condition((*element)[1].get())._slot;
+            auto until = emit(op_t::UNTIL, dst, holds);
+            emit(op_t::UNTIL_ELSE, dst, condition((*element)[0].get())._slot, 0, holds);
+            set_target(until);
+        }
+
+        void _accept(const LiteralExpr* element) override
+        {
+            emit(op_t::LITERAL, slot(0), 0, 0, 0, element->value());
+        }
+
+        void _accept(const UnfoldedIdentifierExpr* element) override
+        {
+            assert(element->offset() != -1);
+            emit(op_t::PLACE, slot(0), element->offset(), _path);
+        }
+
+        void _accept(const IdentifierExpr* element) override
+        {
+            if (!element->compiled())
+                throw base_error("Cannot compile the uncompiled identifier ", *element->name());
+            expression(element->compiled().get());
+        }
+
+        void _accept(const PathSelectExpr* element) override
+        {
+            auto old = _path;
+            _path = element->offset();
+            expression(element->child().get());
+            _path = old;
+        }
+
+        void _accept(const PlusExpr* element) override { commutative(op_t::SUM, element); }
+
+        void _accept(const MultiplyExpr* element) override { commutative(op_t::PRODUCT, element); }
+
+        void _accept(const SubtractExpr* element) override
+        {
+            std::vector<uint32_t> children;
+            for (auto& e : element->expressions())
+                children.push_back(expression(e.get()));
+            auto first = static_cast<uint32_t>(_program._operands.size());
+            _program._operands.insert(_program._operands.end(), children.begin(), children.end());
+            emit(op_t::SUBTRACT, slot(0), first, children.size());
+        }
+
+        void _accept(const MinusExpr* element) override
+        {
+            auto child = expression((*element)[0].get());
+            emit(op_t::NEGATE, slot(0), child);
+        }
+
+        QueryProgram& _program;
+        uint32_t _slot = 0;
+        uint32_t _path = 0;
+    };
+
+    /**
+     * Emits the code of Condition::distance for a query. The negation is
+     * known for every node, so it is folded into the instructions.
+     */
+    class DistanceCompiler : public QueryCompiler {
+    public:
+        using QueryCompiler::QueryCompiler;
+
+        QueryProgram::range_t distance(const Condition* query)
+        {
+            auto begin = static_cast<uint32_t>(_program._code.size());
+            Visitor::visit(this, query);
+            return QueryProgram::range_t{begin, static_cast<uint32_t>(_program._code.size()), _slot};
+        }
+
+    private:
+        void sub(const Condition* element, bool negate)
+        {
+            _negated = _negated != negate;
+            Visitor::visit(this, element);
+            _negated = _negated != negate;
+        }
+
+        void constant(uint32_t value, uint32_t dst)
+        {
+            emit(op_t::SET, dst, 0, 0, 0, value);
+        }
+
+        void constant(uint32_t value)
+        {
+            constant(value, slot(0));
+        }
+
+        void fallback(const Condition* element)
+        {
+            _program._distance_fallbacks.push_back(element);
+            emit(op_t::DISTANCE_FALLBACK, slot(0), _program._distance_fallbacks.size() - 1, 0, _negated ? 1 : 0);
+        }
+
+        void combine(const LogicalCondition* element, bool conjunction)
+        {
+            auto dst = slot(0);
+            constant(conjunction ? 0 : std::numeric_limits<uint32_t>::max(), dst);
+            for (auto& c : *element) {
+                Visitor::visit(this, c.get());
+                emit(conjunction ? op_t::DISTANCE_SUM : op_t::DISTANCE_MIN, dst, _slot);
+            }
+            _slot = dst;
+        }
+
+        void delta(op_t op, const CompareCondition* element, bool negated)
+        {
+            auto a = expression(element->getExpr1().get());
+            auto b = expression(element->getExpr2().get());
+            emit(op, slot(0), a, b, negated ? 1 : 0);
+        }
+
+        void _accept(const NotCondition* element) override { sub((*element)[0].get(), true); }
+
+        void _accept(const AndCondition* element) override { combine(element, !_negated); }
+
+        void _accept(const OrCondition* element) override { combine(element, _negated); }
+
+        void _accept(const LessThanCondition* element) override { delta(op_t::DELTA_LESS, element, _negated); }
+
+        void _accept(const LessThanOrEqualCondition* element) override { delta(op_t::DELTA_LESS_EQUAL, element, _negated); }
+
+        void _accept(const EqualCondition* element) override { delta(op_t::DELTA_EQUAL, element, _negated); }
+
+        void _accept(const NotEqualCondition* element) override { delta(op_t::DELTA_EQUAL, element, !_negated); }
+
+        void _accept(const DeadlockCondition* element) override { constant(0); }
+
+        void _accept(const CompareConjunction* element) override
+        {
+            auto first = static_cast<uint32_t>(_program._constraints.size());
+            for (auto& c : element->constraints())
+                _program._constraints.push_back(QueryProgram::constraint_t{c._place, c._lower, c._upper});
+            emit(op_t::DISTANCE_CONJUNCTION, slot(0), first, element->constraints().size(),
+                 _negated != element->isNegated() ? 1 : 0);
+        }
+
+        void _accept(const UnfoldedUpperBoundsCondition* element) override { fallback(element); }
+
+        void _accept(const UpperBoundsCondition* element) override
+        {
+            if (element->getCompiled())
+                Visitor::visit(this, element->getCompiled().get());
+            else
+                fallback(element);
+        }
+
+        void _accept(const ShallowCondition* element) override
+        {
+            if (element->getCompiled())
+                Visitor::visit(this, element->getCompiled().get());
+            else
+                fallback(element);
+        }
+
+        void _accept(const BooleanCondition* element) override
+        {
+            constant(_negated != element->value ? 0 : std::numeric_limits<uint32_t>::max());
+        }
+
+        // throws on the tree
+        void _accept(const ControlCondition* element) override { fallback(element); }
+
+        void _accept(const ECondition* element) override { fallback(element); }
+
+        void _accept(const SimpleQuantifierCondition* element) override { sub((*element)[0].get(), false); }
+
+        void _accept(const EFCondition* element) override { sub((*element)[0].get(), false); }
+
+        void _accept(const EGCondition* element) override { sub((*element)[0].get(), false); }
+
+        void _accept(const ACondition* element) override { sub((*element)[0].get(), false); }
+
+        void _accept(const FCondition* element) override { sub((*element)[0].get(), false); }
+
+        void _accept(const AFCondition* element) override { sub((*element)[0].get(), true); }
+
+        void _accept(const AGCondition* element) override { sub((*element)[0].get(), true); }
+
+        void _accept(const GCondition* element) override { sub((*element)[0].get(), true); }
+
+        void _accept(const AXCondition* element) override { sub((*element)[0].get(), true); }
+
+        void _accept(const UntilCondition* element) override { sub((*element)[1].get(), false); }
+
+        void _accept(const AUCondition* element) override
+        {
+            auto dst = slot(0);
+            constant(0, dst);
+            for (auto* c : {(*element)[0].get(), (*element)[1].get()}) {
+                sub(c, true);
+                emit(op_t::DISTANCE_SUM, dst, _slot);
+            }
+            _slot = dst;
+        }
+
+        void _accept(const PathQuant* element) override
+        {
+            if (element->child())
+                sub(element->child().get(), false);
+            else
+                constant(0);
+        }
+
+        void _accept(const ExistPath* element) override { _accept(static_cast<const PathQuant*>(element)); }
+
+        void _accept(const AllPaths* element) override { _accept(static_cast<const PathQuant*>(element)); }
+
+        void _accept(const PathSelectCondition* element) override { fallback(element); }
+
+        bool _negated = false;
+    };
+
+    QueryProgram::QueryProgram(const Condition* query)
+    {
+        QueryCompiler compiler(*this);
+        _roots.push_back(compiler.condition(query));
+        _distances.emplace(query, DistanceCompiler(*this).distance(query));
+    }
+
+    QueryProgram::QueryProgram(const std::vector<Condition_ptr>& queries)
+    {
+        QueryCompiler compiler(*this);
+        for (auto& q : queries)
+            _roots.push_back(compiler.condition(q.get()));
+        DistanceCompiler distances(*this);
+        for (auto& q : queries)
+            _distances.emplace(q.get(), distances.distance(q.get()));
+    }
+
+    namespace {
+        bool& useAVX2()
+        {
+#ifdef QUERYPROGRAM_AVX2
+            static bool enabled = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+            }();
+#else
+            static bool enabled = false;
+#endif
+            return enabled;
+        }
+
+        // the deltas of Expressions.cpp, on the values truncated to int and without overflow
+        QUERYPROGRAM_INLINE uint32_t delta_equal(int v1, int v2, bool negated)
+        {
+            if (negated)
+                return v1 == v2 ? 1 : 0;
+            return v1 > v2 ? uint32_t(v1) - uint32_t(v2) : uint32_t(v2) - uint32_t(v1);
+        }
+
+        QUERYPROGRAM_INLINE uint32_t delta_less(int v1, int v2, bool negated)
+        {
+            if (negated)
+                return v1 >= v2 ? 0 : uint32_t(v2) - uint32_t(v1);
+            return v1 < v2 ? 0 : uint32_t(v1) - uint32_t(v2) + 1;
+        }
+
+        QUERYPROGRAM_INLINE uint32_t delta_less_equal(int v1, int v2, bool negated)
+        {
+            if (negated)
+                return v1 > v2 ? 0 : uint32_t(v2) - uint32_t(v1) + 1;
+            return v1 <= v2 ? 0 : uint32_t(v1) - uint32_t(v2);
+        }
+
+        /**
+         * CompareConjunction::distance for n markings, column(place) gives the
+         * tokens of the place in each of them. Whether a constraint takes part
+         * only depends on its bounds, so the constraints are the outer loop.
+         */
+        template<typename T, typename C>
+        QUERYPROGRAM_INLINE void conjunction_distance(const T* begin, const T* end, bool negated, C&& column,
+                                                      int64_t* d, uint32_t n)
+        {
+            constexpr auto inf = std::numeric_limits<uint32_t>::max();
+            for (uint32_t l = 0; l < n; ++l)
+                d[l] = 0;
+            bool first = true;
+            for (auto* c = begin; c != end; ++c) {
+                const MarkVal* tokens = column(c->_place);
+                if (!negated) {
+                    for (uint32_t l = 0; l < n; ++l) {
+                        const int pv = tokens[l];
+                        uint32_t r = c->_upper == inf ? 0 : delta_less_equal(pv, c->_upper, false);
+                        r += c->_lower == 0 ? 0 : delta_less_equal(c->_lower, pv, false);
+                        d[l] = uint32_t(d[l] + r);
+                    }
+                    continue;
+                }
+                if (c->_upper != inf) {
+                    for (uint32_t l = 0; l < n; ++l) {
+                        const int64_t r = delta_less_equal(tokens[l], c->_upper, true);
+                        d[l] = first ? r : std::min(d[l], r);
+                    }
+                    first = false;
+                }
+                // the lower bound is compared to the upper bound, as in CompareConjunction::distance
+                if (c->_lower != 0) {
+                    for (uint32_t l = 0; l < n; ++l) {
+                        const int64_t r = delta_less_equal(c->_upper, tokens[l], true);
+                        d[l] = first ? r : std::min(d[l], r);
+                    }
+                    first = false;
+                }
+            }
+        }
+    }
+
+    /**
+     * Runs code on every marking of a batch, one instruction at a time. The
+     * values of a slot for the markings are consecutive, so each instruction
+     * is a branch-free loop over the batch which the compiler vectorizes;
+     * run is compiled once for the baseline target and once for AVX2.
+     * Jumps of conjunctions and disjunctions are not taken, as they depend on
+     * the marking, which only makes the values of skipped subformulas fresh.
+     */
+    struct QueryProgram::lanes_t {
+        static QUERYPROGRAM_INLINE void run(const QueryProgram& program, const range_t& range,
+                                            const Structures::MarkingBatch& batch, const PetriNet* net,
+                                            int64_t* v)
+        {
+            const uint32_t n = batch.size();
+            auto slot = [v, n](uint32_t s) { return v + size_t(s) * n; };
+            auto column = [&batch](uint32_t place) { return batch.column(place); };
+            for (uint32_t pc = range._begin; pc < range._end; ++pc) {
+                const auto& i = program._code[pc];
+                int64_t* d = slot(i._dst);
+                const int64_t* a = slot(i._a);
+                const int64_t* b = slot(i._b);
+                switch (i._op) {
+                    case op_t::LITERAL:
+                    case op_t::SET:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = i._value;
+                        break;
+                    case op_t::PLACE: {
+                        assert(i._a + (i._b == 0 ? 0 : i._b * net->numberOfPlaces()) < batch.places());
+                        const MarkVal* tokens = column(i._a + (i._b == 0 ? 0 : i._b * net->numberOfPlaces()));
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = tokens[l];
+                        break;
+                    }
+                    case op_t::SUM:
+                    case op_t::PRODUCT: {
+                        const bool sum = i._op == op_t::SUM;
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = i._value;
+                        for (uint32_t k = i._a; k < i._a + i._b; ++k) {
+                            const MarkVal* tokens = column(program._operands[k]);
+                            if (sum)
+                                for (uint32_t l = 0; l < n; ++l)
+                                    d[l] += tokens[l];
+                            else
+                                for (uint32_t l = 0; l < n; ++l)
+                                    d[l] *= tokens[l];
+                        }
+                        for (uint32_t k = i._a + i._b; k < i._a + i._b + i._c; ++k) {
+                            const int64_t* s = slot(program._operands[k]);
+                            if (sum)
+                                for (uint32_t l = 0; l < n; ++l)
+                                    d[l] += s[l];
+                            else
+                                for (uint32_t l = 0; l < n; ++l)
+                                    d[l] *= s[l];
+                        }
+                        break;
+                    }
+                    case op_t::SUBTRACT: {
+                        const int64_t* s = slot(program._operands[i._a]);
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = s[l];
+                        for (uint32_t k = i._a + 1; k < i._a + i._b; ++k) {
+                            s = slot(program._operands[k]);
+                            for (uint32_t l = 0; l < n; ++l)
+                                d[l] -= s[l];
+                        }
+                        break;
+                    }
+                    case op_t::NEGATE:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = -a[l];
+                        break;
+                    case op_t::EQUAL:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] == b[l] ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::NOT_EQUAL:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] != b[l] ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::LESS:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] < b[l] ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::LESS_EQUAL:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] <= b[l] ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::CONJUNCTION: {
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = 1;
+                        for (uint32_t k = i._a; k < i._a + i._b; ++k) {
+                            const auto& c = program._constraints[k];
+                            const MarkVal* tokens = column(c._place);
+                            for (uint32_t l = 0; l < n; ++l)
+                                d[l] &= tokens[l] <= c._upper && tokens[l] >= c._lower;
+                        }
+                        const int64_t negated = i._c != 0;
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = negated != d[l] ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    }
+                    case op_t::DEADLOCK:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = net && net->deadlocked(batch.marking(l)) ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::NOT:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] == Condition::RUNKNOWN ? Condition::RUNKNOWN :
+                                   a[l] == Condition::RFALSE ? Condition::RTRUE : Condition::RFALSE;
+                        break;
+                    case op_t::AND:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = d[l] == Condition::RFALSE || a[l] == Condition::RFALSE ? Condition::RFALSE :
+                                   a[l] == Condition::RUNKNOWN ? Condition::RUNKNOWN : d[l];
+                        break;
+                    case op_t::OR:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = d[l] == Condition::RTRUE || a[l] == Condition::RTRUE ? Condition::RTRUE :
+                                   a[l] == Condition::RUNKNOWN ? Condition::RUNKNOWN : d[l];
+                        break;
+                    case op_t::EVENTUALLY:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] == Condition::RTRUE ? Condition::RTRUE : Condition::RUNKNOWN;
+                        break;
+                    case op_t::ALWAYS:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = a[l] == Condition::RFALSE ? Condition::RFALSE : Condition::RUNKNOWN;
+                        break;
+                    case op_t::UNTIL:
+                        // resolved by UNTIL_ELSE, which sees both operands
+                        break;
+                    case op_t::UNTIL_ELSE: {
+                        const int64_t* holds = slot(i._c);
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = holds[l] != Condition::RFALSE ? holds[l] :
+                                   a[l] == Condition::RFALSE ? Condition::RFALSE : Condition::RUNKNOWN;
+                        break;
+                    }
+                    case op_t::JUMP:
+                        pc = i._b - 1;
+                        break;
+                    case op_t::FALLBACK:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = PQL::evaluate(program._fallbacks[i._a], EvaluationContext(batch.marking(l), net));
+                        break;
+                    case op_t::DELTA_EQUAL:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = delta_equal(a[l], b[l], i._c != 0);
+                        break;
+                    case op_t::DELTA_LESS:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = delta_less(a[l], b[l], i._c != 0);
+                        break;
+                    case op_t::DELTA_LESS_EQUAL:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = delta_less_equal(a[l], b[l], i._c != 0);
+                        break;
+                    case op_t::DISTANCE_CONJUNCTION:
+                        conjunction_distance(program._constraints.data() + i._a,
+                                             program._constraints.data() + i._a + i._b, i._c != 0, column, d, n);
+                        break;
+                    case op_t::DISTANCE_SUM:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = uint32_t(d[l] + a[l]);
+                        break;
+                    case op_t::DISTANCE_MIN:
+                        for (uint32_t l = 0; l < n; ++l)
+                            d[l] = std::min(d[l], a[l]);
+                        break;
+                    case op_t::DISTANCE_FALLBACK:
+                        for (uint32_t l = 0; l < n; ++l) {
+                            DistanceContext context(net, batch.marking(l));
+                            if (i._c != 0)
+                                context.negate();
+                            d[l] = program._distance_fallbacks[i._a]->distance(context);
+                        }
+                        break;
+                }
+            }
+        }
+
+        static void generic(const QueryProgram& program, const range_t& range,
+                            const Structures::MarkingBatch& batch, const PetriNet* net, int64_t* v)
+        {
+            run(program, range, batch, net, v);
+        }
+
+#ifdef QUERYPROGRAM_AVX2
+        __attribute__((target("avx2")))
+        static void avx2(const QueryProgram& program, const range_t& range,
+                         const Structures::MarkingBatch& batch, const PetriNet* net, int64_t* v)
+        {
+            run(program, range, batch, net, v);
+        }
+#endif
+    };
+
+    void QueryProgram::set_vectorized(bool enable)
+    {
+#ifdef QUERYPROGRAM_AVX2
+        useAVX2() = enable && __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool QueryProgram::vectorized()
+    {
+        return useAVX2();
+    }
+
+    QueryProgram::scratch_t QueryProgram::make_scratch() const
+    {
+        scratch_t scratch;
+        scratch._values = _initial;
+        return scratch;
+    }
+
+    Condition::Result QueryProgram::evaluate(const EvaluationContext& context, scratch_t& scratch) const
+    {
+        assert(!_roots.empty());
+        run(_roots.front(), context, scratch);
+        return static_cast<Condition::Result>(scratch._values[_roots.front()._slot]);
+    }
+
+    Condition::Result QueryProgram::evaluate(const Condition* condition, const EvaluationContext& context,
+                                             scratch_t& scratch) const
+    {
+        auto it = _conditions.find(condition);
+        if (it == _conditions.end())
+            return PQL::evaluate(const_cast<Condition*>(condition), context);
+        run(it->second, context, scratch);
+        return static_cast<Condition::Result>(scratch._values[it->second._slot]);
+    }
+
+    void QueryProgram::evaluate(const Condition* condition, const Structures::MarkingBatch& batch,
+                                const PetriNet* net, scratch_t& scratch, Condition::Result* results) const
+    {
+        auto it = _conditions.find(condition);
+        if (it == _conditions.end()) {
+            for (uint32_t l = 0; l < batch.size(); ++l)
+                results[l] = PQL::evaluate(const_cast<Condition*>(condition), EvaluationContext(batch.marking(l), net));
+            return;
+        }
+        run(it->second, batch, net, scratch);
+        const int64_t* v = scratch._lanes.data() + size_t(it->second._slot) * batch.size();
+        for (uint32_t l = 0; l < batch.size(); ++l)
+            results[l] = static_cast<Condition::Result>(v[l]);
+    }
+
+    uint32_t QueryProgram::distance(const Condition* query, const EvaluationContext& context, scratch_t& scratch) const
+    {
+        auto it = _distances.find(query);
+        if (it == _distances.end()) {
+            DistanceContext dc(context.net(), context.marking());
+            return query->distance(dc);
+        }
+        run(it->second, context, scratch);
+        return scratch._values[it->second._slot];
+    }
+
+    void QueryProgram::distance(const Condition* query, const Structures::MarkingBatch& batch,
+                                const PetriNet* net, scratch_t& scratch, uint32_t* distances) const
+    {
+        auto it = _distances.find(query);
+        if (it == _distances.end()) {
+            for (uint32_t l = 0; l < batch.size(); ++l) {
+                DistanceContext dc(net, batch.marking(l));
+                distances[l] = query->distance(dc);
+            }
+            return;
+        }
+        run(it->second, batch, net, scratch);
+        const int64_t* v = scratch._lanes.data() + size_t(it->second._slot) * batch.size();
+        for (uint32_t l = 0; l < batch.size(); ++l)
+            distances[l] = v[l];
+    }
+
+    Condition::Result QueryProgram::result(const Condition* condition, const scratch_t& scratch) const
+    {
+        auto it = _conditions.find(condition);
+        if (it == _conditions.end())
+            return condition->getSatisfied();
+        return static_cast<Condition::Result>(scratch._values[it->second._slot]);
+    }
+
+    int64_t QueryProgram::value(const Expr* expr, const scratch_t& scratch) const
+    {
+        auto it = _expressions.find(expr);
+        if (it == _expressions.end())
+            return expr->getEval();
+        return scratch._values[it->second];
+    }
+
+    void QueryProgram::run(const range_t& range, const Structures::MarkingBatch& batch, const PetriNet* net,
+                           scratch_t& scratch) const
+    {
+        scratch._lanes.resize(_initial.size() * batch.size());
+        if (batch.empty())
+            return;
+#ifdef QUERYPROGRAM_AVX2
+        if (useAVX2())
+            lanes_t::avx2(*this, range, batch, net, scratch._lanes.data());
+        else
+#endif
+            lanes_t::generic(*this, range, batch, net, scratch._lanes.data());
+    }
+
+    void QueryProgram::run(const range_t& range, const EvaluationContext& context, scratch_t& scratch) const
+    {
+        if (scratch._values.size() != _initial.size())
+            scratch._values = _initial;
+        auto* v = scratch._values.data();
+        const MarkVal* marking = context.marking();
+        for (uint32_t pc = range._begin; pc < range._end; ++pc) {
+            const auto& i = _code[pc];
+            switch (i._op) {
+                case op_t::LITERAL:
+                    v[i._dst] = i._value;
+                    break;
+                case op_t::PLACE:
+                    v[i._dst] = marking[i._a + (i._b == 0 ? 0 : i._b * context.net()->numberOfPlaces())];
+                    break;
+                case op_t::SUM: {
+                    int64_t r = i._value;
+                    for (uint32_t k = i._a; k < i._a + i._b; ++k)
+                        r += marking[_operands[k]];
+                    for (uint32_t k = i._a + i._b; k < i._a + i._b + i._c; ++k)
+                        r += v[_operands[k]];
+                    v[i._dst] = r;
+                    break;
+                }
+                case op_t::PRODUCT: {
+                    int64_t r = i._value;
+                    for (uint32_t k = i._a; k < i._a + i._b; ++k)
+                        r *= marking[_operands[k]];
+                    for (uint32_t k = i._a + i._b; k < i._a + i._b + i._c; ++k)
+                        r *= v[_operands[k]];
+                    v[i._dst] = r;
+                    break;
+                }
+                case op_t::SUBTRACT: {
+                    int64_t r = v[_operands[i._a]];
+                    for (uint32_t k = i._a + 1; k < i._a + i._b; ++k)
+                        r -= v[_operands[k]];
+                    v[i._dst] = r;
+                    break;
+                }
+                case op_t::NEGATE:
+                    v[i._dst] = -v[i._a];
+                    break;
+                case op_t::SET:
+                    v[i._dst] = i._value;
+                    break;
+                case op_t::EQUAL:
+                    v[i._dst] = v[i._a] == v[i._b] ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::NOT_EQUAL:
+                    v[i._dst] = v[i._a] != v[i._b] ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::LESS:
+                    v[i._dst] = v[i._a] < v[i._b] ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::LESS_EQUAL:
+                    v[i._dst] = v[i._a] <= v[i._b] ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::CONJUNCTION: {
+                    bool res = true;
+                    for (uint32_t k = i._a; k < i._a + i._b; ++k) {
+                        const auto& c = _constraints[k];
+                        if (marking[c._place] > c._upper || marking[c._place] < c._lower) {
+                            res = false;
+                            break;
+                        }
+                    }
+                    v[i._dst] = ((i._c != 0) != res) ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                }
+                case op_t::DEADLOCK:
+                    v[i._dst] = context.net() && context.net()->deadlocked(marking) ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::NOT:
+                    v[i._dst] = v[i._a] == Condition::RUNKNOWN ? Condition::RUNKNOWN :
+                                v[i._a] == Condition::RFALSE ? Condition::RTRUE : Condition::RFALSE;
+                    break;
+                case op_t::AND:
+                    if (v[i._a] == Condition::RFALSE) {
+                        v[i._dst] = Condition::RFALSE;
+                        pc = i._b - 1;
+                    } else if (v[i._a] == Condition::RUNKNOWN)
+                        v[i._dst] = Condition::RUNKNOWN;
+                    break;
+                case op_t::OR:
+                    if (v[i._a] == Condition::RTRUE) {
+                        v[i._dst] = Condition::RTRUE;
+                        pc = i._b - 1;
+                    } else if (v[i._a] == Condition::RUNKNOWN)
+                        v[i._dst] = Condition::RUNKNOWN;
+                    break;
+                case op_t::EVENTUALLY:
+                    v[i._dst] = v[i._a] == Condition::RTRUE ? Condition::RTRUE : Condition::RUNKNOWN;
+                    break;
+                // UNTIL_ELSE is only reached if the second operand of the until is false
+                case op_t::ALWAYS:
+                case op_t::UNTIL_ELSE:
+                    v[i._dst] = v[i._a] == Condition::RFALSE ? Condition::RFALSE : Condition::RUNKNOWN;
+                    break;
+                case op_t::UNTIL:
+                    if (v[i._a] != Condition::RFALSE) {
+                        v[i._dst] = v[i._a];
+                        pc = i._b - 1;
+                    }
+                    break;
+                case op_t::JUMP:
+                    pc = i._b - 1;
+                    break;
+                case op_t::FALLBACK:
+                    v[i._dst] = PQL::evaluate(_fallbacks[i._a], context);
+                    break;
+                case op_t::DELTA_EQUAL:
+                    v[i._dst] = delta_equal(v[i._a], v[i._b], i._c != 0);
+                    break;
+                case op_t::DELTA_LESS:
+                    v[i._dst] = delta_less(v[i._a], v[i._b], i._c != 0);
+                    break;
+                case op_t::DELTA_LESS_EQUAL:
+                    v[i._dst] = delta_less_equal(v[i._a], v[i._b], i._c != 0);
+                    break;
+                case op_t::DISTANCE_CONJUNCTION:
+                    conjunction_distance(_constraints.data() + i._a, _constraints.data() + i._a + i._b, i._c != 0,
+                                         [marking](uint32_t place) { return marking + place; }, v + i._dst, 1);
+                    break;
+                case op_t::DISTANCE_SUM:
+                    v[i._dst] = uint32_t(v[i._dst] + v[i._a]);
+                    break;
+                case op_t::DISTANCE_MIN:
+                    v[i._dst] = std::min(v[i._dst], v[i._a]);
+                    break;
+                case op_t::DISTANCE_FALLBACK: {
+                    DistanceContext dc(context.net(), marking);
+                    if (i._c != 0)
+                        dc.negate();
+                    v[i._dst] = _distance_fallbacks[i._a]->distance(dc);
+                    break;
+                }
+            }
+        }
+    }
+} }
@@ -20,6 +20,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <map>
 
 #include "PetriEngine/PetriNetBuilder.h"
 #include "PetriEngine/PetriNet.h"
@@ -42,6 +43,8 @@ namespace PetriEngine {
     : _placenames(other._placenames), _transitionnames(other._transitionnames),
        _placelocations(other._placelocations), _transitionlocations(other._transitionlocations),
        _transitions(other._transitions), _places(other._places),
+       _originalNumberOfPlaces(other._originalNumberOfPlaces),
+       _originalNumberOfTransitions(other._originalNumberOfTransitions),
        initialMarking(other.initialMarking), reducer(this), _string_set(other._string_set)
     {
 
@@ -579,6 +582,31 @@ namespace PetriEngine {
         reducer.Reduce(placecontext, reductiontype, reconstructTrace, timeout, remove_loops, all_reach, all_ltl, contains_next, reductions);
     }
 
+    std::vector<std::vector<size_t>> PetriNetBuilder::queryGroups(std::vector<std::shared_ptr<PQL::Condition> >& queries,
+                                                                  const std::vector<Reachability::ResultPrinter::Result>& results,
+                                                                  const PetriNet* net)
+    {
+        // queries using exactly the same places (and deadlock or not) share a group
+        std::map<std::pair<bool, std::vector<uint32_t>>, size_t> index;
+        std::vector<std::vector<size_t>> groups;
+        for(size_t i = 0; i < queries.size(); ++i)
+        {
+            if(results[i] != Reachability::ResultPrinter::Unknown)
+                continue;
+            QueryPlaceAnalysisContext placecontext(getPlaceNames(), getTransitionNames(), net);
+            PetriEngine::PQL::analyze(queries[i], placecontext);
+            std::vector<uint32_t> support;
+            for(uint32_t p = 0; p < numberOfPlaces(); ++p)
+                if(placecontext.getQueryPlaceCount()[p] > 0)
+                    support.push_back(p);
+            auto res = index.emplace(std::make_pair(placecontext.hasDeadlock(), std::move(support)), groups.size());
+            if(res.second)
+                groups.emplace_back();
+            groups[res.first->second].push_back(i);
+        }
+        return groups;
+    }
+
     void PetriNetBuilder::saveInitialNet()
     {
         reducer.saveInitialNet();
@@ -0,0 +1,162 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PetriEngine/Reachability/ParallelReachabilitySearch.h"
+#include "PetriEngine/PQL/PQL.h"
+#include "PetriEngine/PQL/Contexts.h"
+#include "PetriEngine/PQL/QueryProgram.h"
+
+using namespace PetriEngine::PQL;
+using namespace PetriEngine::Structures;
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        bool ParallelReachabilitySearch::supports(Strategy strategy)
+        {
+            switch(strategy)
+            {
+                case Strategy::DFS:
+                case Strategy::BFS:
+                case Strategy::HEUR:
+                case Strategy::RDFS:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        ReachabilitySearch::searchstate_t ParallelReachabilitySearch::collectStats(bool withTransitions) const
+        {
+            searchstate_t ss;
+            ss.usequeries = true;
+            ss.heurquery = _heurquery;
+            ss.exploredStates = 1;
+            if(withTransitions)
+                ss.enabledTransitionsCount.resize(_net.numberOfTransitions(), 0);
+            for(auto& s : _stats)
+            {
+                ss.expandedStates += s._expanded.load(std::memory_order_relaxed);
+                ss.exploredStates += s._explored.load(std::memory_order_relaxed);
+                // the per-transition counters are owned by the workers and only read after they are joined
+                if(withTransitions)
+                    for(size_t t = 0; t < _net.numberOfTransitions(); ++t)
+                        ss.enabledTransitionsCount[t] += s._enabledTransitionsCount[t];
+            }
+            return ss;
+        }
+
+        bool ParallelReachabilitySearch::checkQueries(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                              std::vector<ResultPrinter::Result>& results,
+                                              State& state, size_t id,
+                                              ConcurrentStateSet& states,
+                                              PQL::QueryProgram::scratch_t& scratch)
+        {
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(_solved[i].load(std::memory_order_acquire))
+                    continue;
+                EvaluationContext ec(state.marking(), &_net);
+                Condition::Result res;
+                if(!_program.is_thread_safe())
+                {
+                    // upper-bound queries record the bound in the query itself
+                    std::lock_guard<std::mutex> guard(_queryLock);
+                    res = _program.evaluate(queries[i].get(), ec, scratch);
+                }
+                else
+                    res = _program.evaluate(queries[i].get(), ec, scratch);
+                if(res != Condition::RTRUE)
+                    continue;
+
+                std::lock_guard<std::mutex> guard(_resultLock);
+                if(_done || results[i] != ResultPrinter::Unknown)
+                    continue;
+                _satisfyingMarking = id;
+                states.syncStatistics();
+                auto ss = collectStats(false);
+                auto r = doCallback(queries[i], i, ResultPrinter::Satisfied, ss, &states);
+                results[i] = r.first;
+                _solved[i].store(true, std::memory_order_release);
+                if(i == _heurquery && queries.size() >= 2)
+                {
+                    for(size_t n = 1; n < queries.size(); ++n)
+                    {
+                        auto next = (i + n) % queries.size();
+                        if(results[next] == ResultPrinter::Unknown)
+                        {
+                            _heurquery = next;
+                            break;
+                        }
+                    }
+                }
+                bool alldone = r.second;
+                if(!alldone)
+                {
+                    alldone = true;
+                    for(auto res : results)
+                        alldone &= res != ResultPrinter::Unknown;
+                }
+                if(alldone)
+                {
+                    _done = true;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+#define TRYREACHPARALLEL(X) if(usestubborn) return tryReachParallel<X, ReducingSuccessorGenerator>(queries, results, usequeries, keep_trace, printstats, seed); \
+                            else return tryReachParallel<X, SuccessorGenerator>(queries, results, usequeries, keep_trace, printstats, seed);
+
+        bool ParallelReachabilitySearch::reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    Strategy strategy,
+                    bool usestubborn,
+                    bool statespacesearch,
+                    StatisticsLevel printstats,
+                    bool keep_trace,
+                    size_t seed)
+        {
+            bool usequeries = !statespacesearch;
+
+            // if we are searching for bounds
+            if(!usequeries) strategy = Strategy::BFS;
+
+            if(_threads == 1 || !supports(strategy))
+                return ReachabilitySearch::reachable(queries, results, strategy, usestubborn,
+                                                     statespacesearch, printstats, keep_trace, seed);
+
+            switch(strategy)
+            {
+                case Strategy::DFS:
+                    TRYREACHPARALLEL(DFSQueue)
+                    break;
+                case Strategy::BFS:
+                    TRYREACHPARALLEL(BFSQueue)
+                    break;
+                case Strategy::HEUR:
+                    TRYREACHPARALLEL(HeuristicQueue)
+                    break;
+                case Strategy::RDFS:
+                    TRYREACHPARALLEL(RDFSQueue)
+                    break;
+                default:
+                    throw base_error("Unsupported search strategy");
+            }
+        }
+    }
+}
@@ -0,0 +1,231 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "PetriEngine/Reachability/PortfolioReachabilitySearch.h"
+#include "PetriEngine/TAR/TARReachability.h"
+#include "PetriEngine/PQL/PredicateCheckers.h"
+#include "utils/errors.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace PetriEngine::PQL;
+using namespace PetriEngine::Structures;
+
+namespace PetriEngine {
+    namespace Reachability {
+
+        // routes the answers of one engine through the portfolio
+        class PortfolioReachabilitySearch::handler_t : public AbstractHandler {
+        public:
+            handler_t(PortfolioReachabilitySearch& portfolio, size_t engine)
+            : _portfolio(portfolio), _engine(engine) {}
+
+            std::pair<Result, bool> handle(
+                size_t index,
+                PQL::Condition* query,
+                Result result,
+                const std::vector<uint32_t>* maxPlaceBound = nullptr,
+                size_t expandedStates = 0,
+                size_t exploredStates = 0,
+                size_t discoveredStates = 0,
+                int maxTokens = 0,
+                Structures::StateSetInterface* stateset = nullptr, size_t lastmarking = 0,
+                const MarkVal* initialMarking = nullptr, bool trace = true) override
+            {
+                return _portfolio.answer(_engine, index, query, result, maxPlaceBound, expandedStates,
+                                         exploredStates, discoveredStates, maxTokens, stateset, lastmarking,
+                                         initialMarking, trace);
+            }
+
+        private:
+            PortfolioReachabilitySearch& _portfolio;
+            size_t _engine;
+        };
+
+        // a sequential search that adopts the answers of the other engines
+        class PortfolioReachabilitySearch::engine_t : public ReachabilitySearch {
+        public:
+            engine_t(PortfolioReachabilitySearch& portfolio, AbstractHandler& handler)
+            : ReachabilitySearch(portfolio._net, handler, portfolio._kbound), _portfolio(portfolio) {}
+
+        protected:
+            bool checkQueries(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                              std::vector<ResultPrinter::Result>& results,
+                              State& state, searchstate_t& ss,
+                              StateSetInterface* states) override
+            {
+                if(_portfolio._stop.load(std::memory_order_acquire))
+                    return true;
+                for(size_t i = 0; i < queries.size(); ++i)
+                {
+                    if(results[i] == ResultPrinter::Unknown && _portfolio._solved[i].load(std::memory_order_acquire))
+                        results[i] = _portfolio._answers[i];
+                }
+                if(_portfolio._upperBounds)
+                {
+                    // upper-bound queries record the bound in the query itself
+                    std::lock_guard<std::mutex> guard(_portfolio._queryLock);
+                    return ReachabilitySearch::checkQueries(queries, results, state, ss, states);
+                }
+                return ReachabilitySearch::checkQueries(queries, results, state, ss, states);
+            }
+
+        private:
+            PortfolioReachabilitySearch& _portfolio;
+        };
+
+        bool PortfolioReachabilitySearch::supports(const std::string& engine)
+        {
+            return engine == "BestFS" || engine == "BFS" || engine == "DFS" || engine == "RDFS" ||
+                   engine == "RPFS" || engine == "RandomWalk" || engine == "TAR";
+        }
+
+        std::pair<AbstractHandler::Result, bool> PortfolioReachabilitySearch::answer(
+                size_t engine, size_t index, PQL::Condition* query,
+                AbstractHandler::Result result, const std::vector<uint32_t>* maxPlaceBound,
+                size_t expandedStates, size_t exploredStates, size_t discoveredStates, int maxTokens,
+                Structures::StateSetInterface* stateset, size_t lastmarking, const MarkVal* initialMarking,
+                bool trace)
+        {
+            std::lock_guard<std::mutex> guard(_resultLock);
+            // the answer of another engine was already passed on
+            if(_solved[index].load(std::memory_order_relaxed))
+                return std::make_pair(ResultPrinter::Ignore, _stop.load(std::memory_order_relaxed));
+            if(_stop.load(std::memory_order_relaxed))
+                return std::make_pair(_answers[index], true);
+
+            auto r = _callback.handle(index, query, result, maxPlaceBound, expandedStates, exploredStates,
+                                      discoveredStates, maxTokens, stateset, lastmarking, initialMarking, trace);
+            if(r.first != ResultPrinter::Unknown)
+            {
+                _answers[index] = r.first;
+                _winners[index] = _labels[engine];
+                _solved[index].store(true, std::memory_order_release);
+                --_unanswered;
+            }
+            if(r.second || _unanswered == 0)
+                _stop = true;
+            return std::make_pair(r.first, _stop.load(std::memory_order_relaxed));
+        }
+
+        void PortfolioReachabilitySearch::run(size_t engine,
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    const std::vector<ResultPrinter::Result>& results,
+                    bool usestubborn, size_t seed,
+                    int64_t depthRandomWalk, int64_t incRandomWalk)
+        {
+            handler_t handler(*this, engine);
+            std::vector<ResultPrinter::Result> local(results);
+            auto& name = _engines[engine];
+            try
+            {
+                if(name == "TAR")
+                {
+                    TarResultPrinter tar_handler(handler);
+                    TARReachabilitySearch search(tar_handler, _net, _reducer, _kbound);
+                    search.setQueryLock(&_queryLock);
+                    search.setCancellation([this](size_t i) {
+                        return _stop.load(std::memory_order_acquire) || _solved[i].load(std::memory_order_acquire);
+                    });
+                    search.reachable(queries, local, StatisticsLevel::None, false);
+                    return;
+                }
+
+                Strategy strategy = Strategy::HEUR;
+                if(name == "BFS") strategy = Strategy::BFS;
+                else if(name == "DFS") strategy = Strategy::DFS;
+                else if(name == "RDFS") strategy = Strategy::RDFS;
+                else if(name == "RPFS") strategy = Strategy::RPFS;
+                else if(name == "RandomWalk") strategy = Strategy::RandomWalk;
+
+                engine_t search(*this, handler);
+                search.setQueryLock(&_queryLock);
+                search.setCancellation([this] { return _stop.load(std::memory_order_acquire); });
+                search.reachable(queries, local, strategy, usestubborn, false, StatisticsLevel::None,
+                                 false, seed, depthRandomWalk, incRandomWalk);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> guard(_resultLock);
+                if(!_error)
+                    _error = std::current_exception();
+                _stop = true;
+            }
+        }
+
+        bool PortfolioReachabilitySearch::reachable(
+                    std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                    std::vector<ResultPrinter::Result>& results,
+                    const std::vector<std::string>& engines,
+                    bool usestubborn,
+                    StatisticsLevel printstats,
+                    size_t seed,
+                    int64_t depthRandomWalk,
+                    const int64_t incRandomWalk)
+        {
+            _printstats = printstats;
+            _engines.clear();
+            _labels.clear();
+            for(auto& name : engines)
+            {
+                if(!supports(name))
+                    throw base_error("Unsupported portfolio engine ", name);
+                // TAR does not support inhibitor arcs or nets without places
+                if(name == "TAR" && (_net.has_inhibitor() || _net.numberOfPlaces() == 0))
+                {
+                    if(printstats != StatisticsLevel::None)
+                        std::cout << "The TAR engine was left out of the portfolio as it does not support the net." << std::endl;
+                    continue;
+                }
+                auto n = std::count(_engines.begin(), _engines.end(), name);
+                _engines.push_back(name);
+                _labels.push_back(n == 0 ? name : name + "#" + std::to_string(n + 1));
+            }
+            if(_engines.empty())
+                throw base_error("No engines in the reachability portfolio");
+
+            _answers = results;
+            _winners = std::vector<std::string>(queries.size());
+            _solved = std::make_unique<std::atomic<bool>[]>(queries.size());
+            _unanswered = 0;
+            _upperBounds = false;
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                _solved[i] = results[i] != ResultPrinter::Unknown;
+                _unanswered += results[i] == ResultPrinter::Unknown;
+                _upperBounds |= containsUpperBounds(queries[i]);
+            }
+            _stop = _unanswered == 0;
+            _error = nullptr;
+
+            std::vector<std::thread> threads;
+            for(size_t e = 0; e < _engines.size(); ++e)
+                threads.emplace_back([&, e] {
+                    run(e, queries, results, usestubborn, seed + e, depthRandomWalk, incRandomWalk);
+                });
+            for(auto& t : threads)
+                t.join();
+            if(_error)
+                std::rethrow_exception(_error);
+
+            for(size_t i = 0; i < queries.size(); ++i)
+                if(results[i] == ResultPrinter::Unknown)
+                    results[i] = _answers[i];
+            return _unanswered == 0;
+        }
+    }
+}
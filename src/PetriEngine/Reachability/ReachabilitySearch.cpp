@@ -39,13 +39,31 @@ namespace PetriEngine {
         {
             if(!ss.usequeries) return false;
 
-            bool alldone = true;
+            _satisfied.resize(queries.size());
             for(size_t i = 0; i < queries.size(); ++i)
             {
                 if(results[i] == ResultPrinter::Unknown)
                 {
                     EvaluationContext ec(state.marking(), &_net);
-                    if(PetriEngine::PQL::evaluate(queries[i].get(), ec) == Condition::RTRUE)
+                    _satisfied[i] = _program.evaluate(queries[i].get(), ec, _scratch);
+                }
+            }
+            return checkResults(queries, results, _satisfied.data(), ss, states);
+        }
+
+        bool ReachabilitySearch::checkResults(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                              std::vector<ResultPrinter::Result>& results,
+                                              const Condition::Result* satisfied, searchstate_t& ss,
+                                              Structures::StateSetInterface* states)
+        {
+            if(!ss.usequeries) return false;
+
+            bool alldone = true;
+            for(size_t i = 0; i < queries.size(); ++i)
+            {
+                if(results[i] == ResultPrinter::Unknown)
+                {
+                    if(satisfied[i] == Condition::RTRUE)
                     {
                         auto r = doCallback(queries[i], i, ResultPrinter::Satisfied, ss, states);
                         results[i] = r.first;
@@ -74,6 +92,25 @@ namespace PetriEngine {
             return alldone;
         }
 
+        bool ReachabilitySearch::evaluateBatch(std::vector<std::shared_ptr<PQL::Condition > >& queries,
+                                               const std::vector<ResultPrinter::Result>& results,
+                                               const Structures::MarkingBatch& batch,
+                                               std::vector<Condition::Result>& satisfied)
+        {
+            const size_t nqueries = queries.size();
+            satisfied.resize(batch.size() * nqueries);
+            _satisfied.resize(batch.size());
+            for(size_t i = 0; i < nqueries; ++i)
+            {
+                if(results[i] != ResultPrinter::Unknown)
+                    continue;
+                _program.evaluate(queries[i].get(), batch, &_net, _scratch, _satisfied.data());
+                for(uint32_t lane = 0; lane < batch.size(); ++lane)
+                    satisfied[lane * nqueries + i] = _satisfied[lane];
+            }
+            return true;
+        }
+
         std::pair<ResultPrinter::Result,bool> ReachabilitySearch::doCallback(
             std::shared_ptr<PQL::Condition>& query, size_t i,
             ResultPrinter::Result r, searchstate_t& ss,
@@ -127,16 +164,37 @@ namespace PetriEngine {
             std::cout << std::endl << std::endl;
         }
 
+        void ReachabilitySearch::printApproximation(const Structures::ApproximateStateSet& states) const
+        {
+            auto& table = states.table();
+            std::cout << "Visited markings were stored using "
+                      << (table.storage() == StateStorage::Bitstate ? "bitstate hashing" : "hash compaction")
+                      << ", results needing the full state space are unknown.\n"
+                      << "\tstored markings:                " << table.size() << "\n"
+                      << "\ttable size (bytes):             " << table.bytes() << "\n";
+            if(table.dropped() > 0)
+                std::cout << "\tmarkings dropped (table full):  " << table.dropped() << "\n";
+            std::cout << "\testimated omission probability: " << table.omissionProbability() << std::endl;
+        }
+
 #define TRYREACHPAR    (queries, results, usequeries, printstats, seed, initPotencies)
 #define TEMPPAR(X, Y)  if(keep_trace) return tryReach<X, Structures::TracableStateSet, Y> TRYREACHPAR ; \
+                       else if(_storage != StateStorage::Exact) return tryReach<X, Structures::ApproximateStateSet, Y> TRYREACHPAR ; \
                        else return tryReach<X, Structures::StateSet, Y> TRYREACHPAR ;
 #define TRYREACH(X)    if(stubbornreduction) TEMPPAR(X, ReducingSuccessorGenerator) \
-                       else TEMPPAR(X, SuccessorGenerator)
+                       else if(packed && _net.has_inhibitor()) TEMPPAR(X, PackedSuccessorGenerator<true>) \
+                       else if(packed) TEMPPAR(X, PackedSuccessorGenerator<false>) \
+                       else TEMPPAR(X, IncrementalSuccessorGenerator)
 #define TRYREACHPAR_RW  (queries, results, usequeries, printstats, seed, depthRandomWalk, incRandomWalk, initPotencies)
 #define TEMPPAR_RW(Y)  if(keep_trace) return tryReachRandomWalk<Structures::TracableRandomWalkStateSet, Y> TRYREACHPAR_RW ; \
                        else return tryReachRandomWalk<Structures::RandomWalkStateSet, Y> TRYREACHPAR_RW ;
 #define TRYREACH_RW    if(stubbornreduction) TEMPPAR_RW(ReducingSuccessorGenerator) \
-                       else TEMPPAR_RW(SuccessorGenerator)
+                       else if(packed && _net.has_inhibitor()) TEMPPAR_RW(PackedSuccessorGenerator<true>) \
+                       else if(packed) TEMPPAR_RW(PackedSuccessorGenerator<false>) \
+                       else TEMPPAR_RW(IncrementalSuccessorGenerator)
+#define TRYREACHPAR_EXT (queries, results, usequeries, printstats)
+#define TRYREACH_EXT   if(stubbornreduction) return tryReachExternal<ReducingSuccessorGenerator> TRYREACHPAR_EXT ; \
+                       else return tryReachExternal<IncrementalSuccessorGenerator> TRYREACHPAR_EXT ;
 
 
         size_t ReachabilitySearch::maxTokens() const {
@@ -157,9 +215,17 @@ namespace PetriEngine {
                     const std::vector<MarkVal>& initPotencies)
         {
             bool usequeries = !statespacesearch;
+            _program = PQL::QueryProgram(queries);
+            _scratch = _program.make_scratch();
+
+            if(keep_trace && _storage != StateStorage::Exact)
+                throw base_error("Traces are not supported with approximate state storage");
 
             // if we are searching for bounds
-            if(!usequeries) strategy = Strategy::BFS;
+            if(!usequeries && strategy != Strategy::ExternalBFS) strategy = Strategy::BFS;
+
+            // ordinary nets can use the bitset based firing kernels
+            const bool packed = !stubbornreduction && PackedSuccessorGenerator<true>::applicable(_net);
 
             switch(strategy)
             {
@@ -181,6 +247,11 @@ namespace PetriEngine {
                 case Strategy::RandomWalk:
                     TRYREACH_RW
                     break;
+                case Strategy::ExternalBFS:
+                    if(keep_trace)
+                        throw base_error("Traces are not supported by the ExternalBFS search strategy");
+                    TRYREACH_EXT
+                    break;
                 default:
                     throw base_error("Unsupported search strategy");
             }
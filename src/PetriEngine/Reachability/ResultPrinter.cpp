@@ -3,6 +3,7 @@
 #include "PetriEngine/PetriNetBuilder.h"
 #include "PetriEngine/options.h"
 #include "PetriEngine/PQL/Expressions.h"
+#include "PetriEngine/Structures/ApproximateStateSet.h"
 
 namespace PetriEngine {
     namespace Reachability {
@@ -19,6 +20,14 @@ namespace PetriEngine {
             return res;
         }
 
+        std::pair<AbstractHandler::Result, bool> QueryGroupResultPrinter::handle(
+            size_t index, PQL::Condition* query, Result result, const std::vector<uint32_t>* maxPlaceBound,
+            size_t expandedStates, size_t exploredStates, size_t discoveredStates,
+            int maxTokens, Structures::StateSetInterface* stateset, size_t lastmarking, const MarkVal* initialMarking, bool trace)
+        {
+            return _printer.handle(_indices[index], query, result, maxPlaceBound, expandedStates, exploredStates, discoveredStates, maxTokens, stateset, lastmarking, initialMarking, trace);
+        }
+
         std::pair<AbstractHandler::Result, bool> ResultPrinter::handle(
                 size_t index,
                 PQL::Condition* query,
@@ -32,6 +41,14 @@ namespace PetriEngine {
         {
             if(result == Unknown) return std::make_pair(Unknown,false);
 
+            // an exhausted search over approximately stored markings may have omitted some of them
+            if(result == NotSatisfied && dynamic_cast<Structures::ApproximateStateSet*>(stateset) != nullptr)
+            {
+                std::cout << "\nUnable to decide if " << querynames[index] << " is satisfied.\n\n";
+                std::cout << "Query is MAYBE satisfied.\n" << std::endl;
+                return std::make_pair(Unknown,false);
+            }
+
             Result retval = result;
 
             if(options->cpnOverApprox)
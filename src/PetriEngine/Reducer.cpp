@@ -163,6 +163,81 @@ namespace PetriEngine {
         set.erase(lb);
     }
 
+    void Reducer::touchPlace(uint32_t place)
+    {
+        // rules A, G and L examine the consumers of a place, rule C its
+        // producers and rules B, D, F and J the place itself
+        ++_changes;
+        Place& pl = parent->_places[place];
+        for(auto t : pl.consumers)
+        {
+            _candidatesA.touch(t);
+            _candidatesG.touch(t);
+            _candidatesL.touch(t);
+        }
+        for(auto t : pl.producers)
+            _candidatesC.touch(t);
+        _candidatesB.touch(place);
+        _candidatesD.touch(place);
+        _candidatesF.touch(place);
+        _candidatesJ.touch(place);
+    }
+
+    void Reducer::touchTransition(uint32_t t)
+    {
+        // rule D examines a transition from each of its pre places and rule L
+        // compares it to every other consumer of them
+        ++_changes;
+        Transition& trans = getTransition(t);
+        _candidatesA.touch(t);
+        _candidatesC.touch(t);
+        _candidatesDEmpty.touch(t);
+        _candidatesG.touch(t);
+        _candidatesL.touch(t);
+        for(auto& a : trans.pre)
+        {
+            _candidatesB.touch(a.place);
+            _candidatesD.touch(a.place);
+            for(auto c : parent->_places[a.place].consumers)
+                _candidatesL.touch(c);
+        }
+        for(auto& a : trans.post)
+            _candidatesB.touch(a.place);
+    }
+
+    void Reducer::touchPlaceAndArcs(uint32_t place)
+    {
+        touchPlace(place);
+        for(auto t : parent->_places[place].consumers)
+            touchTransition(t);
+        for(auto t : parent->_places[place].producers)
+            touchTransition(t);
+    }
+
+    void Reducer::touchTransitionAndArcs(uint32_t t)
+    {
+        touchTransition(t);
+        for(auto& a : getTransition(t).pre)
+            touchPlace(a.place);
+        for(auto& a : getTransition(t).post)
+            touchPlace(a.place);
+    }
+
+    void Reducer::touchAll()
+    {
+        ++_changes;
+        for(auto* candidates : {&_candidatesA, &_candidatesB, &_candidatesC, &_candidatesD, &_candidatesDEmpty,
+                                &_candidatesF, &_candidatesG, &_candidatesJ, &_candidatesL})
+            candidates->touchAll();
+    }
+
+    void Reducer::beginPass(ReductionCandidates& candidates, uint32_t size)
+    {
+        if(!_incrementalScans)
+            candidates.touchAll();
+        candidates.begin(size);
+    }
+
     void Reducer::skipTransition(uint32_t t)
     {
         Transition& trans = getTransition(t);
@@ -170,10 +245,12 @@ namespace PetriEngine {
         for(auto p : trans.post)
         {
             eraseTransition(parent->_places[p.place].producers, t);
+            touchPlace(p.place);
         }
         for(auto p : trans.pre)
         {
             eraseTransition(parent->_places[p.place].consumers, t);
+            touchPlace(p.place);
         }
         trans.post.clear();
         trans.pre.clear();
@@ -203,6 +280,7 @@ namespace PetriEngine {
             if(ait != trans.post.end() && ait->place == place)
                 trans.post.erase(ait);
         }
+        touchPlaceAndArcs(place);
         pl.consumers.clear();
         pl.producers.clear();
         assert(consistent());
@@ -220,6 +298,8 @@ namespace PetriEngine {
         auto ait = std::lower_bound(trans.pre.begin(), trans.pre.end(), a);
         assert(ait != trans.pre.end());
         trans.pre.erase(ait);
+        touchPlace(p);
+        touchTransition(t);
         assert(consistent());
     }
 
@@ -235,6 +315,8 @@ namespace PetriEngine {
         auto ait = std::lower_bound(trans.post.begin(), trans.post.end(), a);
         assert(ait != trans.post.end());
         trans.post.erase(ait);
+        touchPlace(p);
+        touchTransition(t);
         assert(consistent());
     }
 
@@ -303,8 +385,8 @@ namespace PetriEngine {
     bool Reducer::ReducebyRuleA(uint32_t* placeInQuery) {
         // Rule A  - find transition t that has exactly one place in pre and post and remove one of the places (and t)
         bool continueReductions = false;
-        const size_t numberoftransitions = parent->numberOfTransitions();
-        for (uint32_t t = 0; t < numberoftransitions; t++) {
+        beginPass(_candidatesA, parent->numberOfTransitions());
+        for (uint32_t t; _candidatesA.next(t);) {
             if(hasTimedout()) return false;
             Transition& trans = getTransition(t);
 
@@ -410,7 +492,10 @@ namespace PetriEngine {
                     }
                     assert(dest->weight > 0);
                 }
+                touchTransition(_t);
             }
+            for(auto& pPost : toMove)
+                touchPlace(pPost.place);
             // UA1. remove place
             skipPlace(pPre);
         } // end of Rule A main for-loop
@@ -421,8 +506,8 @@ namespace PetriEngine {
 
         // Rule B - find place p that has exactly one transition in pre and exactly one in post and remove the place
         bool continueReductions = false;
-        const size_t numberofplaces = parent->numberOfPlaces();
-        for (uint32_t p = 0; p < numberofplaces; p++) {
+        beginPass(_candidatesB, parent->numberOfPlaces());
+        for (uint32_t p; _candidatesB.next(p);) {
             if(hasTimedout()) return false;
             Place& place = parent->_places[p];
 
@@ -612,6 +697,12 @@ namespace PetriEngine {
                         break;
                     }
                 }
+                touchTransition(tOut);
+                touchPlace(p);
+                for (auto& arc : in.post)
+                    touchPlace(arc.place);
+                for (auto& arc : in.pre)
+                    touchPlace(arc.place);
             }
             // UB1. remove transition
             if(place.producers.size() == 0)
@@ -627,19 +718,17 @@ namespace PetriEngine {
     bool Reducer::ReducebyRuleC(uint32_t* placeInQuery) {
         // Rule C - Places in parallel where one accumulates tokens while the others disable their post set
         bool continueReductions = false;
-        _pflags.resize(parent->_places.size(), 0);
-        std::fill(_pflags.begin(), _pflags.end(), 0);
-
-        for (uint32_t tid_outer = 0; tid_outer < parent->numberOfTransitions(); ++tid_outer) {
+        beginPass(_candidatesC, parent->numberOfTransitions());
+        for (uint32_t tid_outer; _candidatesC.next(tid_outer);) {
             for (size_t aid_outer = 0; aid_outer < parent->_transitions[tid_outer].post.size(); ++aid_outer) {
 
                 auto pid_outer = parent->_transitions[tid_outer].post[aid_outer].place;
-                if (_pflags[pid_outer] > 0) continue;
-                _pflags[pid_outer] = 1;
+                const Place &pout = parent->_places[pid_outer];
+                // a place is examined from its first producer only
+                if (pout.producers.front() < tid_outer) continue;
 
                 if (hasTimedout()) return false;
 
-                const Place &pout = parent->_places[pid_outer];
                 if (pout.skip) continue;
 
                 for (size_t aid_inner = aid_outer + 1; aid_inner < parent->_transitions[tid_outer].post.size(); ++aid_inner) {
@@ -762,7 +851,12 @@ namespace PetriEngine {
         _tflags.resize(parent->_transitions.size(), 0);
         std::fill(_tflags.begin(), _tflags.end(), 0);
         bool has_empty_trans = false;
-        for(size_t t = 0; t < parent->_transitions.size(); ++t)
+        // the kept transition without arcs goes if an earlier one turned up
+        if(_emptyTransition)
+            _candidatesDEmpty.touch(*_emptyTransition);
+        _emptyTransition = std::nullopt;
+        beginPass(_candidatesDEmpty, parent->numberOfTransitions());
+        for(uint32_t t; _candidatesDEmpty.next(t);)
         {
             auto& trans = parent->_transitions[t];
             if(!trans.skip && trans.pre.size() == 0 && trans.post.size() == 0)
@@ -772,17 +866,23 @@ namespace PetriEngine {
                     ++_ruleD;
                     skipTransition(t);
                 }
+                else _emptyTransition = t;
                 has_empty_trans = true;
             }
 
         }
 
-        for(auto& op : parent->_places)
-        for(size_t outer = 0; outer < op.consumers.size(); ++outer)
+        // a transition is examined from its first pre place, or from the next
+        // one after it reduced another transition (_tflags 2)
+        beginPass(_candidatesD, parent->numberOfPlaces());
+        for(uint32_t pid; _candidatesD.next(pid);)
+        for(size_t outer = 0; outer < parent->_places[pid].consumers.size(); ++outer)
         {
+            auto& op = parent->_places[pid];
             auto touter = op.consumers[outer];
             if(hasTimedout()) return false;
-            if(_tflags[touter] != 0) continue;
+            if(_tflags[touter] == 1) continue;
+            if(_tflags[touter] == 0 && getTransition(touter).pre.front().place != pid) continue;
             _tflags[touter] = 1;
             Transition& tout = getTransition(touter);
             if (tout.skip) continue;
@@ -928,7 +1028,11 @@ namespace PetriEngine {
                     continueReductions = true;
                     _ruleD++;
                     skipTransition(t2);
-                    _tflags[touter] = 0;
+                    if (t2 != touter) {
+                        _tflags[touter] = 2;
+                        for (auto& a : tout.pre)
+                            _candidatesD.touch(a.place);
+                    }
 
                     // t2 has now been removed from op.consumers, so update indexes to not miss any
                     if (t2 == touter) {
@@ -1051,7 +1155,8 @@ namespace PetriEngine {
     bool Reducer::ReducebyRuleF(uint32_t* placeInQuery) {
         bool continueReductions = false;
         const size_t numberofplaces = parent->numberOfPlaces();
-        for(uint32_t p = 0; p < numberofplaces; ++p)
+        beginPass(_candidatesF, numberofplaces);
+        for(uint32_t p; _candidatesF.next(p);)
         {
             if(hasTimedout()) return false;
             Place& place = parent->_places[p];
@@ -1092,6 +1197,7 @@ namespace PetriEngine {
                 skipPlace(p);
                 continueReductions = true;
             }
+            else _candidatesF.touch(p); // counted again on the next pass
 
         }
         assert(consistent());
@@ -1222,9 +1328,10 @@ namespace PetriEngine {
                 continueReductions = true;
                 _ruleF++;
             }
-            else if (inhibArcs == 0)
+            else if (inhibArcs == 0 && place.inhib)
             {
                 place.inhib = false;
+                touchPlaceAndArcs(p);
             }
         }
         assert(consistent());
@@ -1234,7 +1341,8 @@ namespace PetriEngine {
     bool Reducer::ReducebyRuleG(uint32_t* placeInQuery, bool remove_loops, bool remove_consumers) {
         if(!remove_loops) return false;
         bool continueReductions = false;
-        for(uint32_t t = 0; t < parent->numberOfTransitions(); ++t)
+        beginPass(_candidatesG, parent->numberOfTransitions());
+        for(uint32_t t; _candidatesG.next(t);)
         {
             if(hasTimedout()) return false;
             Transition& trans = parent->_transitions[t];
@@ -1465,6 +1573,7 @@ namespace PetriEngine {
                 }
                 parent->initialMarking[p1] += parent->initialMarking[p2];
                 skipPlace(p2);
+                touchPlace(p1);
                 assert(placeInQuery[p2] == 0);
             }
             return removed;
@@ -1551,7 +1660,8 @@ namespace PetriEngine {
         if(reconstructTrace)
             return false;
         bool any = false;
-        for(std::size_t p = 0; p < parent->numberOfPlaces(); ++p)
+        beginPass(_candidatesJ, parent->numberOfPlaces());
+        for(uint32_t p; _candidatesJ.next(p);)
         {
             if(placeInQuery[p] > 0) continue;
             auto& place = parent->_places[p];
@@ -1602,6 +1712,7 @@ namespace PetriEngine {
                 arc->weight /= mod;
             }
             parent->initialMarking[p] /= mod;
+            touchPlaceAndArcs(p);
             any = true;
         }
         return any;
@@ -1770,7 +1881,12 @@ namespace PetriEngine {
         bool continueReductions = false;
         if(parent->numberOfTransitions() == 0)
             return false;
-        for (size_t t1 = 0; t1 < parent->numberOfTransitions() - 1; ++t1) {
+        // the pass stops at the first removed transition
+        uint32_t limit = parent->numberOfTransitions() - 1;
+        for (auto t : _skippedTransitions)
+            limit = std::min(limit, t);
+        beginPass(_candidatesL, limit);
+        for (uint32_t t1; _candidatesL.next(t1);) {
             Transition &tran1 = getTransition(t1);
             if (tran1.skip) break;
             for (const auto & t1i : tran1.pre){
@@ -2037,6 +2153,9 @@ namespace PetriEngine {
         // If a place only has transitions with positive effect and no inhibitor arcs, then it is removed too (Rule F).
 
         if (hasTimedout()) return false;
+        // The fixed point depends on the whole net, so it only changes when the net did.
+        if (_incrementalScans && _changes == _changesAtEFMNOP) return false;
+        const auto changes = _changes;
         bool continue_reductions = false;
         // Use two greatest bits of pflags to keep track of places that can increase or decrease their number of tokens.
         const uint8_t CAN_INC =  0b10000000u;
@@ -2173,15 +2292,15 @@ namespace PetriEngine {
             if(place.skip) continue;
             if (_pflags[p] == 0) {
                 // Remove places that cannot increase nor decrease (Rule M)
-                ++_ruleM;
-
                 if(placeInQuery[p] == 0)
                 {
+                    ++_ruleM;
                     skipPlace(p);
                     continue_reductions = true;
                 }
-                else
+                else if(!place.consumers.empty() || !place.producers.empty())
                 {
+                    ++_ruleM;
                     for(auto t : place.consumers)
                     {
                         auto& trans = getTransition(t);
@@ -2194,7 +2313,8 @@ namespace PetriEngine {
                         auto arc = getOutArc(trans, p);
                         trans.post.erase(arc);
                     }
-                    continue_reductions |= (place.consumers.size() + place.producers.size()) > 0;
+                    continue_reductions = true;
+                    touchPlaceAndArcs(p);
                     place.producers.clear();
                     place.consumers.clear();
                 }
@@ -2223,6 +2343,8 @@ namespace PetriEngine {
                             // inhibitor is useless
                             trans.pre.erase(inArc);
                             place.consumers.erase(place.consumers.begin() + i);
+                            touchPlace(p);
+                            touchTransition(t);
                             ++_ruleP;
                             continue_reductions = true;
                         }
@@ -2255,6 +2377,8 @@ namespace PetriEngine {
                                 out->weight -= inArc->weight;
                                 trans.pre.erase(inArc);
                                 place.consumers.erase(place.consumers.begin() + i);
+                                touchPlace(p);
+                                touchTransition(t);
                                 ++_ruleN;
                                 continue_reductions = true;
                             }
@@ -2293,7 +2417,7 @@ namespace PetriEngine {
             }
         }
         assert(consistent());
-
+        _changesAtEFMNOP = changes;
         return continue_reductions;
     }
 
@@ -2362,10 +2486,12 @@ namespace PetriEngine {
             for (const Arc& prearc : tran.pre)
             {
                 parent->initialMarking[prearc.place] -= prearc.weight * k;
+                touchPlace(prearc.place);
             }
             for (const Arc& postarc : tran.post)
             {
                 parent->initialMarking[postarc.place] += postarc.weight * k;
+                touchPlace(postarc.place);
             }
             if(reconstructTrace)
             {
@@ -2526,6 +2652,7 @@ namespace PetriEngine {
                         parent->_places[arc.place].addConsumer(id);
                     for(const auto& arc : newtran.post)
                         parent->_places[arc.place].addProducer(id);
+                    touchTransitionAndArcs(id);
                 }
 
                 skipTransition(prod_id);
@@ -2760,10 +2887,14 @@ namespace PetriEngine {
 
                             for(const auto& arc : newtran.pre){
                                 parent->_places[arc.place].addConsumer(id);
-                                parent->_places[arc.place].inhib |= arc.inhib;
+                                if(arc.inhib && !parent->_places[arc.place].inhib){
+                                    parent->_places[arc.place].inhib = true;
+                                    touchPlaceAndArcs(arc.place);
+                                }
                             }
                             for(const auto& arc : newtran.post)
                                 parent->_places[arc.place].addProducer(id);
+                            touchTransitionAndArcs(id);
                         }
                     } else {
                         // Rule T updates
@@ -2806,11 +2937,15 @@ namespace PetriEngine {
 
                         for(const auto& arc : newtran.pre){
                             parent->_places[arc.place].addConsumer(id);
-                            parent->_places[arc.place].inhib |= arc.inhib;
+                            if(arc.inhib && !parent->_places[arc.place].inhib){
+                                parent->_places[arc.place].inhib = true;
+                                touchPlaceAndArcs(arc.place);
+                            }
                         }
 
                         for(const auto& arc : newtran.post)
                             parent->_places[arc.place].addProducer(id);
+                        touchTransitionAndArcs(id);
                     }
                 }
                 skipTransition(originalConsumers[n]);
@@ -2842,6 +2977,7 @@ namespace PetriEngine {
         this->_timeout = timeout;
         _timer = std::chrono::high_resolution_clock::now();
         assert(consistent());
+        touchAll();
         constexpr uint32_t explosion_limiter = 6;
 
         this->reconstructTrace = reconstructTrace;
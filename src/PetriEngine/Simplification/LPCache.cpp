@@ -7,6 +7,7 @@
 
 #include "PetriEngine/Simplification/LPCache.h"
 #include "PetriEngine/Simplification/LinearProgram.h"
+#include "PetriEngine/PQL/Contexts.h"
 
 
 namespace PetriEngine {
@@ -18,6 +19,67 @@ namespace PetriEngine {
 
 
         LPCache::~LPCache() {
+            if (_state_equation != nullptr)
+                glp_delete_prob(_state_equation);
+        }
+
+        glp_prob* LPCache::stateEquation(const PQL::SimplificationContext& context)
+        {
+            auto net = context.net();
+            auto marking = context.marking();
+            if (_state_equation != nullptr && _net == net &&
+                std::equal(_marking.begin(), _marking.end(), marking))
+                return _state_equation;
+
+            if (_state_equation != nullptr)
+                glp_delete_prob(_state_equation);
+            _state_equation = nullptr;
+            _solved.clear();
+
+            auto lp = context.makeBaseLP();
+            if (lp == nullptr)
+                return nullptr;
+
+            const uint32_t nCol = net->numberOfTransitions();
+            for (size_t i = 1; i <= nCol; i++) {
+                glp_set_obj_coef(lp, i, 1);
+                glp_set_col_kind(lp, i, GLP_IV);
+                glp_set_col_bnds(lp, i, GLP_LO, 0, std::numeric_limits<double>::infinity());
+            }
+            glp_set_obj_dir(lp, GLP_MIN);
+
+            _state_equation = lp;
+            _net = net;
+            _marking.assign(marking, marking + net->numberOfPlaces());
+            _base_rows = glp_get_num_rows(lp);
+            return _state_equation;
+        }
+
+        void LPCache::restoreBase()
+        {
+            const int rows = glp_get_num_rows(_state_equation);
+            if (rows == _base_rows)
+                return;
+            // glp_del_rows reads the row numbers from index 1
+            std::vector<int> num(rows - _base_rows + 1);
+            for (int r = _base_rows + 1; r <= rows; ++r)
+                num[r - _base_rows] = r;
+            glp_del_rows(_state_equation, rows - _base_rows, num.data());
+
+            // every removed row which was not basic leaves one basic variable too many;
+            // make structural variables non-basic until the basis has the right size again
+            int basic = 0;
+            for (int r = 1; r <= _base_rows; ++r)
+                basic += glp_get_row_stat(_state_equation, r) == GLP_BS;
+            const int cols = glp_get_num_cols(_state_equation);
+            for (int c = 1; c <= cols; ++c)
+                basic += glp_get_col_stat(_state_equation, c) == GLP_BS;
+            for (int c = 1; c <= cols && basic > _base_rows; ++c) {
+                if (glp_get_col_stat(_state_equation, c) == GLP_BS) {
+                    glp_set_col_stat(_state_equation, c, GLP_NL);
+                    --basic;
+                }
+            }
         }
      
         
@@ -47,7 +47,6 @@ namespace PetriEngine {
         constexpr auto infty = std::numeric_limits<REAL>::infinity();
 
         bool LinearProgram::isImpossible(const PQL::SimplificationContext& context, uint32_t solvetime) {
-            bool use_ilp = true;
             auto net = context.net();
 
             if (_result != result_t::UKNOWN)
@@ -64,6 +63,31 @@ namespace PetriEngine {
                 return false;
             }
 
+            std::vector<row_bounds_t> rows;
+            rows.reserve(_equations.size());
+            for (const auto& eq : _equations) {
+                assert(!(std::isinf(eq.upper) && std::isinf(eq.lower)));
+                if (eq.lower > eq.upper)
+                {
+                    _result = result_t::IMPOSSIBLE;
+                    return true;
+                }
+                rows.push_back(row_bounds_t{eq.row, eq.lower, eq.upper});
+            }
+
+            // the state equation and the programs solved on it are kept by the cache of the thread
+            LPCache local;
+            auto cache = context.cache() != nullptr ? context.cache() : &local;
+            auto lp = cache->stateEquation(context);
+            if (lp == nullptr)
+                return false;
+
+            if (auto known = cache->impossible(rows))
+            {
+                _result = *known ? result_t::IMPOSSIBLE : result_t::POSSIBLE;
+                return *known;
+            }
+
             const uint32_t nCol = net->numberOfTransitions();
             const uint32_t nRow = net->numberOfPlaces() + _equations.size();
 
@@ -72,30 +96,17 @@ namespace PetriEngine {
             for (size_t i = 0; i <= nCol; ++i)
                 indir[i] = i;
 
-            auto lp = context.makeBaseLP();
-            if (lp == nullptr)
-                return false;
-
-            int rowno = 1 + net->numberOfPlaces();
-            glp_add_rows(lp, _equations.size());
+            // new rows are basic, so the basis of the last solve stays valid
+            int rowno = glp_add_rows(lp, _equations.size());
             for (const auto& eq : _equations) {
                 auto l = eq.row->write_indir(row, indir);
-                assert(!(std::isinf(eq.upper) && std::isinf(eq.lower)));
                 glp_set_mat_row(lp, rowno, l-1, indir.data(), row.data());
                 if (!std::isinf(eq.lower) && !std::isinf(eq.upper))
                 {
                     if (eq.lower == eq.upper)
                         glp_set_row_bnds(lp, rowno, GLP_FX, eq.lower, eq.upper);
                     else
-                    {
-                        if (eq.lower > eq.upper)
-                        {
-                            _result = result_t::IMPOSSIBLE;
-                            glp_delete_prob(lp);
-                            return true;
-                        }
                         glp_set_row_bnds(lp, rowno, GLP_DB, eq.lower, eq.upper);
-                    }
                 }
                 else if (std::isinf(eq.lower))
                     glp_set_row_bnds(lp, rowno, GLP_UP, -infty, eq.upper);
@@ -106,20 +117,11 @@ namespace PetriEngine {
                 if (context.timeout())
                 {
                     // std::cerr << "glpk: construction timeout" << std::endl;
-                    glp_delete_prob(lp);
+                    cache->restoreBase();
                     return false;
                 }
             }
 
-            // Set objective, kind and bounds
-            for (size_t i = 1; i <= nCol; i++) {
-                glp_set_obj_coef(lp, i, 1);
-                glp_set_col_kind(lp, i, use_ilp ? GLP_IV : GLP_CV);
-                glp_set_col_bnds(lp, i, GLP_LO, 0, infty);
-            }
-
-            // Minimize the objective
-            glp_set_obj_dir(lp, GLP_MIN);
             auto stime = glp_time();
             glp_smcp settings;
             glp_init_smcp(&settings);
@@ -128,6 +130,12 @@ namespace PetriEngine {
             settings.presolve = GLP_OFF;
             settings.msg_lev = 0;
             auto result = glp_simplex(lp, &settings);
+            if (result == GLP_EBADB || result == GLP_ESING || result == GLP_ECOND)
+            {
+                // the basis of the last solve does not fit these rows, start over
+                glp_adv_basis(lp, 0);
+                result = glp_simplex(lp, &settings);
+            }
             if (result == GLP_ETMLIM)
             {
                 _result = result_t::UKNOWN;
@@ -174,7 +182,9 @@ namespace PetriEngine {
             {
                 _result = result_t::IMPOSSIBLE;
             }
-            glp_delete_prob(lp);
+            cache->restoreBase();
+            if (_result != result_t::UKNOWN)
+                cache->setImpossible(std::move(rows), _result == result_t::IMPOSSIBLE);
 
             return _result == result_t::IMPOSSIBLE;
         }
@@ -0,0 +1,131 @@
+/* This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/StreamingPnmlBuilder.h"
+#include "utils/errors.h"
+
+#include <algorithm>
+
+namespace PetriEngine {
+
+    StreamingPnmlBuilder::StreamingPnmlBuilder(std::ostream& out)
+    : _out(out) {
+        _out << "<?xml version=\"1.0\"?>\n"
+             << "<pnml xmlns=\"http://www.pnml.org/version-2009/grammar/pnml\">\n"
+             << "<net id=\"ClientsAndServers-PT-N0500P0\" type=\"http://www.pnml.org/version-2009/grammar/ptnet\">\n";
+        _out << "<page id=\"page0\">\n"
+             << "<name>\n"
+             << "<text>DefaultPage</text>"
+             << "</name>";
+    }
+
+    void StreamingPnmlBuilder::addPlace(const std::string& name, uint32_t tokens, double x, double y) {
+        addPlace(std::make_shared<const_string>(name), tokens, x, y);
+    }
+
+    void StreamingPnmlBuilder::addPlace(const shared_const_string& name, uint32_t tokens, double x, double y) {
+        _out << "<place id=\"" << *name << "\">\n"
+             << "<graphics><position x=\"" << x << "\" y=\"" << y << "\"/></graphics>\n"
+             << "<name><text>" << *name << "</text></name>\n";
+        if (tokens > 0) {
+            _out << "<initialMarking><text>" << tokens << "</text></initialMarking>\n";
+        }
+        _out << "</place>\n";
+        ++_nplaces;
+    }
+
+    void StreamingPnmlBuilder::addTransition(const std::string& name, int32_t player, double x, double y) {
+        addTransition(std::make_shared<const_string>(name), player, x, y);
+    }
+
+    void StreamingPnmlBuilder::addTransition(const shared_const_string& name, int32_t player, double x, double y) {
+        flushArcs();
+        _transition = name;
+        _out << "<transition id=\"" << *name << "\">\n"
+             << "<player><value>" << (player == 0 ? '0' : '1') << "</value></player>\n"
+             << "<name><text>" << *name << "</text></name>\n";
+        _out << "<graphics><position x=\"" << x << "\" y=\"" << y << "\"/></graphics>\n";
+        _out << "</transition>\n";
+        ++_ntransitions;
+    }
+
+    void StreamingPnmlBuilder::addInputArc(const std::string& place, const std::string& transition, bool inhibitor, uint32_t weight) {
+        addInputArc(std::make_shared<const_string>(place), std::make_shared<const_string>(transition), inhibitor, weight);
+    }
+
+    void StreamingPnmlBuilder::addInputArc(const shared_const_string& place, const shared_const_string& transition, bool inhibitor, uint32_t weight) {
+        checkTransition(transition);
+        for (auto& arc : _pre) {
+            if (*arc._place == *place) {
+                if (inhibitor != arc._inhibitor) {
+                    throw base_error("Adding an inhibitor and a non-inhibitor arc to the same Place/Transition pair:", place, transition);
+                }
+                arc._weight = inhibitor ? std::min(arc._weight, weight) : arc._weight + weight;
+                return;
+            }
+        }
+        _pre.push_back(arc_t{place, weight, inhibitor});
+    }
+
+    void StreamingPnmlBuilder::addOutputArc(const std::string& transition, const std::string& place, uint32_t weight) {
+        addOutputArc(std::make_shared<const_string>(transition), std::make_shared<const_string>(place), weight);
+    }
+
+    void StreamingPnmlBuilder::addOutputArc(const shared_const_string& transition, const shared_const_string& place, uint32_t weight) {
+        checkTransition(transition);
+        for (auto& arc : _post) {
+            if (*arc._place == *place) {
+                arc._weight += weight;
+                return;
+            }
+        }
+        _post.push_back(arc_t{place, weight, false});
+    }
+
+    void StreamingPnmlBuilder::finish() {
+        if (_finished) return;
+        flushArcs();
+        _out << "</page></net>\n</pnml>";
+        _out.flush();
+        _finished = true;
+    }
+
+    void StreamingPnmlBuilder::checkTransition(const shared_const_string& transition) const {
+        if (_transition == nullptr || (_transition != transition && *_transition != *transition)) {
+            throw base_error("Arcs must be added right after their transition when streaming the net: ", transition);
+        }
+    }
+
+    void StreamingPnmlBuilder::flushArcs() {
+        for (auto& arc : _pre) {
+            _out << "<arc id=\"" << (_narcs++) << "\" source=\""
+                 << *arc._place << "\" target=\"" << *_transition
+                 << "\" type=\"" << (arc._inhibitor ? "inhibitor" : "normal") << "\">\n";
+            if (arc._weight > 1) {
+                _out << "<inscription><text>" << arc._weight << "</text></inscription>\n";
+            }
+            _out << "</arc>\n";
+        }
+        for (auto& arc : _post) {
+            _out << "<arc id=\"" << (_narcs++) << "\" source=\""
+                 << *_transition << "\" target=\"" << *arc._place << "\">\n";
+            if (arc._weight > 1) {
+                _out << "<inscription><text>" << arc._weight << "</text></inscription>\n";
+            }
+            _out << "</arc>\n";
+        }
+        _pre.clear();
+        _post.clear();
+    }
+}
@@ -5,13 +5,161 @@
  * Created on 11 March 2016, 14:15
  */
 
+#include <algorithm>
 #include <limits>
 
 #include "PetriEngine/Structures/AlignedEncoder.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALIGNEDENCODER_AVX2
+#include <immintrin.h>
+#endif
+
 #define SAMEBOUND 120
 #define DBOUND (SAMEBOUND*2)
 
+namespace {
+
+    bool& useAVX2()
+    {
+#ifdef ALIGNEDENCODER_AVX2
+        static bool enabled = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+#else
+        static bool enabled = false;
+#endif
+        return enabled;
+    }
+
+    // min is the smallest non-zero count, used to decide if all marked places agree
+    void scalarStats(const uint32_t* marking, uint32_t places, uint64_t& sum,
+                     uint32_t& max, uint32_t& min, uint32_t& active, uint32_t& last)
+    {
+        for(uint32_t i = 0; i < places; ++i)
+        {
+            uint32_t m = marking[i];
+            if(m == 0) continue;
+            sum += m;
+            max = std::max(max, m);
+            min = std::min(min, m);
+            ++active;
+            last = i;
+        }
+    }
+
+#ifdef ALIGNEDENCODER_AVX2
+    __attribute__((target("avx2")))
+    void avx2Stats(const uint32_t* marking, uint32_t places, uint64_t& sum,
+                   uint32_t& max, uint32_t& min, uint32_t& active, uint32_t& last)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i vsum = zero;
+        __m256i vmax = zero;
+        __m256i vmin = _mm256_set1_epi32(-1);
+        uint32_t i = 0;
+        for(; i + 8 <= places; i += 8)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(marking + i));
+            __m256i empty = _mm256_cmpeq_epi32(x, zero);
+            uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(empty))) & 0xFF;
+            if(mask == 0) continue;
+            active += __builtin_popcount(mask);
+            last = i + 31 - __builtin_clz(mask);
+            vmax = _mm256_max_epu32(vmax, x);
+            // empty places become 2^32-1 and do not affect the minimum
+            vmin = _mm256_min_epu32(vmin, _mm256_or_si256(x, empty));
+            // widen to 64 bit so the sum cannot overflow within a lane
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(x)));
+            vsum = _mm256_add_epi64(vsum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(x, 1)));
+        }
+        alignas(32) uint32_t lmax[8], lmin[8];
+        alignas(32) uint64_t lsum[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lmax), vmax);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lmin), vmin);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lsum), vsum);
+        for(size_t j = 0; j < 8; ++j)
+        {
+            max = std::max(max, lmax[j]);
+            min = std::min(min, lmin[j]);
+        }
+        sum += lsum[0] + lsum[1] + lsum[2] + lsum[3];
+        for(; i < places; ++i)
+        {
+            uint32_t m = marking[i];
+            if(m == 0) continue;
+            sum += m;
+            max = std::max(max, m);
+            min = std::min(min, m);
+            ++active;
+            last = i;
+        }
+    }
+
+    // writes one byte per 8 places and returns the number of places handled
+    __attribute__((target("avx2")))
+    uint32_t avx2WriteBits(unsigned char* destination, const uint32_t* data, uint32_t places)
+    {
+        // binarywrapper_t stores the first bit in the most significant position
+        const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i zero = _mm256_setzero_si256();
+        uint32_t i = 0;
+        for(; i + 8 <= places; i += 8)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            __m256i empty = _mm256_cmpeq_epi32(_mm256_permutevar8x32_epi32(x, reverse), zero);
+            destination[i / 8] = ~_mm256_movemask_ps(_mm256_castsi256_ps(empty)) & 0xFF;
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    uint32_t avx2ReadBits(uint32_t* destination, const unsigned char* source, uint32_t places, uint32_t value)
+    {
+        const __m256i bits = _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+        const __m256i v = _mm256_set1_epi32(value);
+        uint32_t i = 0;
+        for(; i + 8 <= places; i += 8)
+        {
+            __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(source[i / 8]), bits), bits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_and_si256(set, v));
+        }
+        return i;
+    }
+#endif
+}
+
+void AlignedEncoder::setVectorized(bool enable)
+{
+#ifdef ALIGNEDENCODER_AVX2
+    bool& enabled = useAVX2();
+    enabled = enable && __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool AlignedEncoder::vectorized()
+{
+    return useAVX2();
+}
+
+void AlignedEncoder::markingStats(const uint32_t* marking, uint32_t places, uint64_t& sum,
+                                  bool& allsame, uint32_t& val, uint32_t& active, uint32_t& last)
+{
+    sum = 0;
+    val = 0;
+    active = 0;
+    last = 0;
+    uint32_t min = std::numeric_limits<uint32_t>::max();
+#ifdef ALIGNEDENCODER_AVX2
+    if(useAVX2())
+        avx2Stats(marking, places, sum, val, min, active, last);
+    else
+#endif
+        scalarStats(marking, places, sum, val, min, active, last);
+    allsame = active == 0 || min == val;
+}
+
 AlignedEncoder::AlignedEncoder(uint32_t places, uint32_t k)
 : _places(places)
 {
@@ -42,7 +190,12 @@ uint32_t AlignedEncoder::tokenBytes(uint32_t ntokens) const
 
 uint32_t AlignedEncoder::writeBitVector(size_t offset, const uint32_t* data)
 {
-    for(size_t i = 0; i < _places; ++i)
+    size_t i = 0;
+#ifdef ALIGNEDENCODER_AVX2
+    if(useAVX2())
+        i = avx2WriteBits(&_scratchpad.raw()[offset], data, _places);
+#endif
+    for(; i < _places; ++i)
     {
         _scratchpad.set(i+(offset*8), data[i] > 0);
     }
@@ -331,7 +484,12 @@ uint32_t AlignedEncoder::readPlaces(uint32_t* destination, const unsigned char*
 uint32_t AlignedEncoder::readBitVector(uint32_t* destination, const unsigned char* source, uint32_t offset, uint32_t value)
 {
     scratchpad_t b = scratchpad_t((unsigned char*)&source[offset], _places);
-    for(uint32_t i = 0; i < _places; ++i)
+    uint32_t i = 0;
+#ifdef ALIGNEDENCODER_AVX2
+    if(useAVX2())
+        i = avx2ReadBits(destination, &source[offset], _places, value);
+#endif
+    for(; i < _places; ++i)
     {
         if(b.at(i))
         {
@@ -0,0 +1,188 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/Structures/ApproximateStateSet.h"
+#include "utils/errors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        namespace {
+            // splitmix64 finalizer, used to derive a second hash for bitstate hashing
+            uint64_t remix(uint64_t h)
+            {
+                h ^= h >> 30;
+                h *= 0xbf58476d1ce4e5b9ULL;
+                h ^= h >> 27;
+                h *= 0x94d049bb133111ebULL;
+                h ^= h >> 31;
+                return h;
+            }
+        }
+
+        FingerprintTable::FingerprintTable(StateStorage storage, size_t bytes)
+        : _storage(storage)
+        {
+            size_t words = std::max<size_t>(bytes / sizeof(uint64_t), 64);
+            switch(storage)
+            {
+                case StateStorage::HashCompaction:
+                {
+                    // open addressing with a power-of-two number of slots
+                    size_t slots = 64;
+                    while(slots * 2 <= words) slots *= 2;
+                    _table.resize(slots, 0);
+                    _mask = slots - 1;
+                    break;
+                }
+                case StateStorage::Bitstate:
+                    _table.resize(words, 0);
+                    _bits = words * 64;
+                    break;
+                default:
+                    throw base_error("Exact state storage does not use a fingerprint table");
+            }
+        }
+
+        uint64_t FingerprintTable::hash(const unsigned char* data, size_t length)
+        {
+            return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(data), length));
+        }
+
+        size_t FingerprintTable::bit(uint64_t hash, size_t n) const
+        {
+            // double hashing, see Kirsch & Mitzenmacher, "Less hashing, same performance"
+            return (hash + n * (remix(hash) | 1)) % _bits;
+        }
+
+        bool FingerprintTable::insert(uint64_t hash)
+        {
+            if(_storage == StateStorage::HashCompaction)
+            {
+                // 0 marks an empty slot
+                uint64_t fingerprint = hash == 0 ? 1 : hash;
+                size_t i = fingerprint & _mask;
+                while(_table[i] != 0)
+                {
+                    if(_table[i] == fingerprint)
+                        return false;
+                    i = (i + 1) & _mask;
+                }
+                // keep the load below 3/4 so probe sequences stay short
+                if((_size + 1) * 4 > _table.size() * 3)
+                {
+                    ++_dropped;
+                    return false;
+                }
+                // the chance that a new marking shares its fingerprint with one of the stored ones
+                _expectedOmissions += std::ldexp(static_cast<double>(_size), -64);
+                _table[i] = fingerprint;
+                ++_size;
+                return true;
+            }
+            else
+            {
+                // the chance that a new marking finds all of its bits set already
+                double fill = static_cast<double>(_setBits) / _bits;
+                bool fresh = false;
+                for(size_t n = 0; n < BITSTATE_HASHES; ++n)
+                {
+                    size_t b = bit(hash, n);
+                    uint64_t mask = uint64_t{1} << (b % 64);
+                    if((_table[b / 64] & mask) == 0)
+                    {
+                        _table[b / 64] |= mask;
+                        ++_setBits;
+                        fresh = true;
+                    }
+                }
+                if(!fresh)
+                    return false;
+                _expectedOmissions += std::pow(fill, BITSTATE_HASHES);
+                ++_size;
+                return true;
+            }
+        }
+
+        bool FingerprintTable::exists(uint64_t hash) const
+        {
+            if(_storage == StateStorage::HashCompaction)
+            {
+                uint64_t fingerprint = hash == 0 ? 1 : hash;
+                for(size_t i = fingerprint & _mask; _table[i] != 0; i = (i + 1) & _mask)
+                {
+                    if(_table[i] == fingerprint)
+                        return true;
+                }
+                return false;
+            }
+            else
+            {
+                for(size_t n = 0; n < BITSTATE_HASHES; ++n)
+                {
+                    size_t b = bit(hash, n);
+                    if((_table[b / 64] & (uint64_t{1} << (b % 64))) == 0)
+                        return false;
+                }
+                return true;
+            }
+        }
+
+        double FingerprintTable::omissionProbability() const
+        {
+            if(_dropped > 0)
+                return 1.0;
+            // the omissions are approximately Poisson distributed
+            return -std::expm1(-_expectedOmissions);
+        }
+
+        std::pair<bool, size_t> ApproximateStateSet::store_t::insert(const unsigned char* data, size_t length)
+        {
+            if(!_table.insert(FingerprintTable::hash(data, length)))
+                return std::make_pair(false, std::numeric_limits<size_t>::max());
+            size_t id;
+            if(_free.empty())
+            {
+                id = _pending.size();
+                _pending.emplace_back();
+            }
+            else
+            {
+                id = _free.back();
+                _free.pop_back();
+            }
+            _pending[id].assign(data, data + length);
+            return std::make_pair(true, id);
+        }
+
+        std::pair<bool, size_t> ApproximateStateSet::store_t::exists(const unsigned char* data, size_t length) const
+        {
+            return std::make_pair(_table.exists(FingerprintTable::hash(data, length)), std::numeric_limits<size_t>::max());
+        }
+
+        void ApproximateStateSet::store_t::unpack(size_t id, unsigned char* destination)
+        {
+            auto& pending = _pending[id];
+            std::copy(pending.begin(), pending.end(), destination);
+            std::vector<unsigned char>().swap(pending);
+            _free.push_back(id);
+        }
+    }
+}
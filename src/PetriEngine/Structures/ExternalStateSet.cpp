@@ -0,0 +1,320 @@
+/* VerifyPN - TAPAAL Petri Net Engine
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PetriEngine/Structures/ExternalStateSet.h"
+#include "utils/errors.h"
+
+#include <algorithm>
+#include <queue>
+#include <random>
+
+namespace PetriEngine {
+    namespace Structures {
+
+        namespace {
+            // number of runs merged at once, keeps the number of open files bounded
+            constexpr size_t MERGE_FANIN = 64;
+            // rough size of a cached marking including the trie overhead
+            constexpr size_t CACHE_ENTRY_BYTES = 64;
+
+            void writeRecord(std::ostream& out, const std::string& record)
+            {
+                uint16_t length = record.size();
+                out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.write(record.data(), length);
+            }
+
+            bool readRecord(std::istream& in, std::string& record)
+            {
+                uint16_t length;
+                if(!in.read(reinterpret_cast<char*>(&length), sizeof(length)))
+                    return false;
+                record.resize(length);
+                if(!in.read(record.data(), length))
+                    throw base_error("Truncated record in external state file");
+                return true;
+            }
+
+            std::ofstream openOut(const std::filesystem::path& file)
+            {
+                std::ofstream out(file, std::ios::binary | std::ios::trunc);
+                if(!out)
+                    throw base_error("Could not create external state file ", file.string());
+                return out;
+            }
+
+            std::ifstream openIn(const std::filesystem::path& file)
+            {
+                std::ifstream in(file, std::ios::binary);
+                if(!in)
+                    throw base_error("Could not open external state file ", file.string());
+                return in;
+            }
+
+            // reads a number of sorted runs as one sorted stream
+            class RunMerger {
+            public:
+                explicit RunMerger(const std::vector<std::filesystem::path>& runs)
+                {
+                    _inputs.reserve(runs.size());
+                    for(auto& run : runs)
+                    {
+                        _inputs.emplace_back(openIn(run));
+                        read(_inputs.size() - 1);
+                    }
+                }
+
+                bool empty() const { return _heap.empty(); }
+
+                const std::string& top() const { return _heap.top().first; }
+
+                void pop()
+                {
+                    auto source = _heap.top().second;
+                    _heap.pop();
+                    read(source);
+                }
+
+            private:
+                using entry_t = std::pair<std::string, size_t>;
+
+                void read(size_t source)
+                {
+                    std::string record;
+                    if(readRecord(_inputs[source], record))
+                        _heap.emplace(std::move(record), source);
+                }
+
+                std::vector<std::ifstream> _inputs;
+                std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> _heap;
+            };
+        }
+
+        ExternalStateSet::ExternalStateSet(const PetriNet& net, uint32_t kbound, const std::string& directory, size_t memory)
+        : StateSetInterface(net, kbound), _encoder(net.numberOfPlaces(), kbound)
+        {
+            // half of the memory goes to the successor buffer, the other half to the cache
+            _bufferLimit = std::max<size_t>(memory / 2, 1);
+            _cacheLimit = std::max<size_t>(memory / 2 / CACHE_ENTRY_BYTES, 1);
+            _cache = std::make_unique<ptrie::set<ptrie::uchar>>();
+
+            std::random_device rd;
+            auto base = directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+            do {
+                _directory = base / ("verifypn-ebfs-" + std::to_string(rd()));
+            } while(std::filesystem::exists(_directory));
+            std::error_code ec;
+            if(!std::filesystem::create_directories(_directory, ec))
+                throw base_error("Could not create directory for external search ", _directory.string());
+        }
+
+        ExternalStateSet::~ExternalStateSet()
+        {
+            _layerIn.close();
+            std::error_code ec;
+            std::filesystem::remove_all(_directory, ec);
+        }
+
+        std::pair<size_t, size_t> ExternalStateSet::getHistory(size_t)
+        {
+            throw base_error("Traces are not supported by the external-memory search");
+        }
+
+        ExternalStateSet::path_t ExternalStateSet::newFile()
+        {
+            return _directory / (std::to_string(_fileCounter++) + ".bin");
+        }
+
+        bool ExternalStateSet::add(const State& state)
+        {
+            _discovered++;
+            MarkVal sum = 0;
+            bool allsame = true;
+            uint32_t val = 0;
+            uint32_t active = 0;
+            // same statistics as EncodingStateSetInterface::markingStats
+            for(uint32_t i = 0; i < _net.numberOfPlaces(); ++i)
+            {
+                uint32_t old = val;
+                auto m = state.marking()[i];
+                if(m == 0) continue;
+                val = std::max(m, val);
+                if(old != 0 && m != old) allsame = false;
+                ++active;
+                sum += m;
+                _maxPlaceBound[i] = std::max<uint32_t>(_maxPlaceBound[i], m);
+            }
+            _maxTokens = std::max(_maxTokens, sum);
+
+            //Check that we're within k-bound
+            if(_kbound != 0 && sum > _kbound)
+                return false;
+
+            unsigned char type = _encoder.getType(sum, active, allsame, val);
+            size_t length = _encoder.encode(state.marking(), type);
+            if(length*8 >= std::numeric_limits<uint16_t>::max())
+                throw base_error("Marking could not be encoded into less than 2^16 bytes, current limit of PTries");
+
+            auto data = _encoder.scratchpad().const_raw();
+            if(!_cache->insert(data, length).first)
+                return false;
+            if(_cache->size() > _cacheLimit)
+                _cache = std::make_unique<ptrie::set<ptrie::uchar>>();
+
+            _buffer.emplace_back(reinterpret_cast<const char*>(data), length);
+            _bufferBytes += length + sizeof(std::string);
+            if(_bufferBytes >= _bufferLimit)
+                flush();
+            return true;
+        }
+
+        void ExternalStateSet::flush()
+        {
+            if(_buffer.empty())
+                return;
+            std::sort(_buffer.begin(), _buffer.end());
+            auto last = std::unique(_buffer.begin(), _buffer.end());
+            auto file = newFile();
+            {
+                auto out = openOut(file);
+                for(auto it = _buffer.begin(); it != last; ++it)
+                    writeRecord(out, *it);
+                if(!out)
+                    throw base_error("Could not write external state file ", file.string());
+            }
+            _runs.push_back(file);
+            _buffer.clear();
+            _bufferBytes = 0;
+        }
+
+        ExternalStateSet::path_t ExternalStateSet::merge(std::vector<path_t> runs)
+        {
+            auto file = newFile();
+            {
+                RunMerger inputs(runs);
+                auto out = openOut(file);
+                std::string previous;
+                bool first = true;
+                for(; !inputs.empty(); inputs.pop())
+                {
+                    if(first || inputs.top() != previous)
+                    {
+                        writeRecord(out, inputs.top());
+                        previous = inputs.top();
+                        first = false;
+                    }
+                }
+                if(!out)
+                    throw base_error("Could not write external state file ", file.string());
+            }
+            for(auto& run : runs)
+                std::filesystem::remove(run);
+            return file;
+        }
+
+        ExternalStateSet::path_t ExternalStateSet::mergeAll(std::vector<path_t> runs)
+        {
+            while(runs.size() > 1)
+            {
+                std::vector<path_t> merged;
+                for(size_t i = 0; i < runs.size(); i += MERGE_FANIN)
+                {
+                    auto end = std::min(runs.size(), i + MERGE_FANIN);
+                    merged.push_back(merge(std::vector<path_t>(runs.begin() + i, runs.begin() + end)));
+                }
+                runs = std::move(merged);
+            }
+            return runs.front();
+        }
+
+        void ExternalStateSet::addVisited(path_t file, size_t records)
+        {
+            _visited.push_back({std::move(file), records});
+            // merge the last runs until each run is less than half the size of the one before it
+            while(_visited.size() >= 2 && _visited.back().records * 2 >= _visited[_visited.size() - 2].records)
+            {
+                auto last = std::move(_visited.back());
+                _visited.pop_back();
+                auto& previous = _visited.back();
+                previous.file = merge({previous.file, last.file});
+                previous.records += last.records;
+            }
+        }
+
+        bool ExternalStateSet::nextLayer()
+        {
+            flush();
+            _layerIn.close();
+            // the completed layer is kept as a run of the visited set
+            if(!_layer.empty())
+                addVisited(std::move(_layer), _layerRecords);
+            _layer.clear();
+            if(_runs.empty())
+                return false;
+
+            auto candidates = mergeAll(std::move(_runs));
+            _runs.clear();
+
+            // subtract the visited markings from the candidates, what remains is the next layer
+            auto layer = newFile();
+            size_t fresh = 0;
+            {
+                std::vector<path_t> visited;
+                for(auto& run : _visited)
+                    visited.push_back(run.file);
+                RunMerger vin(visited);
+                auto cin = openIn(candidates);
+                auto lout = openOut(layer);
+                std::string c;
+                while(readRecord(cin, c))
+                {
+                    while(!vin.empty() && vin.top() < c)
+                        vin.pop();
+                    if(!vin.empty() && vin.top() == c)
+                        continue;
+                    writeRecord(lout, c);
+                    ++fresh;
+                }
+                if(!lout)
+                    throw base_error("Could not write external state file ", layer.string());
+            }
+            std::filesystem::remove(candidates);
+            _visitedCount += fresh;
+
+            if(fresh == 0)
+            {
+                std::filesystem::remove(layer);
+                return false;
+            }
+            _layer = layer;
+            _layerRecords = fresh;
+            _layerIn = openIn(_layer);
+            ++_layers;
+            return true;
+        }
+
+        bool ExternalStateSet::next(State& state)
+        {
+            while(!_layerIn.is_open() || !readRecord(_layerIn, _record))
+            {
+                if(!nextLayer())
+                    return false;
+            }
+            _encoder.decode(state.marking(), reinterpret_cast<const unsigned char*>(_record.data()));
+            return true;
+        }
+    }
+}
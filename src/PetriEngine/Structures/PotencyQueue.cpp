@@ -32,8 +32,11 @@ namespace PetriEngine {
             if (_potencies.empty())
                 this->_initializePotencies(context->net()->numberOfTransitions(), 100);
 
-            uint32_t dist = query->distance(*context);
-            _queues[_best].emplace(dist, id);
+            push(id, query->distance(*context));
+        }
+
+        void PotencyQueue::push(size_t id, uint32_t distance) {
+            _queues[_best].emplace(distance, id);
             _size++;
         }
 
@@ -73,8 +76,10 @@ namespace PetriEngine {
 
         void
         RandomPotencyQueue::push(size_t id, PQL::DistanceContext *context, const PQL::Condition *query, uint32_t t) {
-            uint32_t dist = query->distance(*context);
+            push(id, query->distance(*context), t);
+        }
 
+        void RandomPotencyQueue::push(size_t id, uint32_t dist, uint32_t t) {
             if (dist < _currentParentDist) {
                 _potencies[t] += _currentParentDist - dist;
             } else if (dist > _currentParentDist && _potencies[t] != 0) {
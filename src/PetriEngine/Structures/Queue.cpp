@@ -157,10 +157,14 @@ namespace PetriEngine {
 
         void HeuristicQueue::push(size_t id, PQL::DistanceContext* context,
             const PQL::Condition* query)
+        {
+            push(id, query->distance(*context));
+        }
+
+        void HeuristicQueue::push(size_t id, uint32_t distance)
         {
             // invert result, highest numbers are on top!
-            uint32_t dist = query->distance(*context);
-            _queue.emplace(dist, (uint32_t)id);
+            _queue.emplace(distance, (uint32_t)id);
         }
 
         bool HeuristicQueue::empty() const {
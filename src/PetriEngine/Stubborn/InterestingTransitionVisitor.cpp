@@ -38,7 +38,7 @@ namespace PetriEngine {
     {
         if (!negated) {               // and
             for (auto &c : *element) {
-                if (!c->isSatisfied()) {
+                if (!satisfied(c.get())) {
                     Visitor::visit(this, c);
                     break;
                 }
@@ -54,7 +54,7 @@ namespace PetriEngine {
             for (auto &c : *element) Visitor::visit(this, c);
         } else {                    // and
             for (auto &c : *element) {
-                if (c->isSatisfied()) {
+                if (satisfied(c.get())) {
                     Visitor::visit(this, c);
                     break;
                 }
@@ -127,8 +127,8 @@ namespace PetriEngine {
     void InterestingTransitionVisitor::_accept(const PQL::EqualCondition *element)
     {
         if (!negated) {               // equal
-            if (element->getExpr1()->getEval() == element->getExpr2()->getEval()) { return; }
-            if (element->getExpr1()->getEval() > element->getExpr2()->getEval()) {
+            if (value(element->getExpr1()) == value(element->getExpr2())) { return; }
+            if (value(element->getExpr1()) > value(element->getExpr2())) {
                 Visitor::visit(decr, element->getExpr1());
                 Visitor::visit(incr, element->getExpr2());
             } else {
@@ -136,7 +136,7 @@ namespace PetriEngine {
                 Visitor::visit(decr, element->getExpr2());
             }
         } else {                    // not equal
-            if (element->getExpr1()->getEval() != element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) != value(element->getExpr2())) { return; }
             Visitor::visit(incr, element->getExpr1());
             Visitor::visit(decr, element->getExpr1());
             Visitor::visit(incr, element->getExpr2());
@@ -147,14 +147,14 @@ namespace PetriEngine {
     void InterestingTransitionVisitor::_accept(const PQL::NotEqualCondition *element)
     {
         if (!negated) {               // not equal
-            if (element->getExpr1()->getEval() != element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) != value(element->getExpr2())) { return; }
             Visitor::visit(incr, element->getExpr1());
             Visitor::visit(decr, element->getExpr1());
             Visitor::visit(incr, element->getExpr2());
             Visitor::visit(decr, element->getExpr2());
         } else {                    // equal
-            if (element->getExpr1()->getEval() == element->getExpr2()->getEval()) { return; }
-            if (element->getExpr1()->getEval() > element->getExpr2()->getEval()) {
+            if (value(element->getExpr1()) == value(element->getExpr2())) { return; }
+            if (value(element->getExpr1()) > value(element->getExpr2())) {
                 Visitor::visit(decr, element->getExpr1());
                 Visitor::visit(incr, element->getExpr2());
             } else {
@@ -167,11 +167,11 @@ namespace PetriEngine {
     void InterestingTransitionVisitor::_accept(const PQL::LessThanCondition *element)
     {
         if (!negated) {               // less than
-            if (element->getExpr1()->getEval() < element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) < value(element->getExpr2())) { return; }
             Visitor::visit(decr, element->getExpr1());
             Visitor::visit(incr, element->getExpr2());
         } else {                    // greater than or equal
-            if (element->getExpr1()->getEval() >= element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) >= value(element->getExpr2())) { return; }
             Visitor::visit(incr, element->getExpr1());
             Visitor::visit(decr, element->getExpr2());
         }
@@ -180,11 +180,11 @@ namespace PetriEngine {
     void InterestingTransitionVisitor::_accept(const PQL::LessThanOrEqualCondition *element)
     {
         if (!negated) {               // less than or equal
-            if (element->getExpr1()->getEval() <= element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) <= value(element->getExpr2())) { return; }
             Visitor::visit(decr, element->getExpr1());
             Visitor::visit(incr, element->getExpr2());
         } else {                    // greater than
-            if (element->getExpr1()->getEval() > element->getExpr2()->getEval()) { return; }
+            if (value(element->getExpr1()) > value(element->getExpr2())) { return; }
             Visitor::visit(incr, element->getExpr1());
             Visitor::visit(decr, element->getExpr2());
         }
@@ -204,7 +204,7 @@ namespace PetriEngine {
 
     void InterestingTransitionVisitor::_accept(const PQL::DeadlockCondition *element)
     {
-        if (!element->isSatisfied()) {
+        if (!satisfied(element)) {
             _stubborn.postPresetOf(_stubborn.leastDependentEnabled(), closure);
         } // else add nothing
     }
@@ -415,7 +415,7 @@ namespace PetriEngine {
     template<typename Condition>
     void InterestingLTLTransitionVisitor::negate_if_satisfied(const Condition *element)
     {
-        auto isSatisfied = element->getSatisfied();
+        auto isSatisfied = result(element);
         assert(isSatisfied != PQL::Condition::RUNKNOWN);
         if ((isSatisfied == PQL::Condition::RTRUE) != negated) {
             negate();
@@ -32,12 +32,27 @@ namespace PetriEngine {
             return true;
         }
         assert(!_queries.empty());
+        bool compiled = _program != nullptr;
+        for (auto &q : _queries)
+            compiled = compiled && _program->contains(q);
+        std::unique_lock<std::mutex> guard;
+        if (_queryLock != nullptr && (!compiled || !_program->is_thread_safe()))
+            guard = std::unique_lock<std::mutex>(*_queryLock);
+        PQL::EvaluationContext context((*_parent).marking(), &_net);
         for (auto &q : _queries) {
-            PetriEngine::PQL::evaluateAndSet(q, PQL::EvaluationContext((*_parent).marking(), &_net));
+            if (compiled) {
+                _program->evaluate(q, context, _scratch);
+                _interesting->set_evaluation(_program.get(), &_scratch);
+            } else {
+                PetriEngine::PQL::evaluateAndSet(q, context);
+                _interesting->set_evaluation(nullptr, nullptr);
+            }
 
             assert(_interesting->get_negated() == false);
             PQL::Visitor::visit(_interesting, q);
         }
+        if (guard.owns_lock())
+            guard.unlock();
 
         closure();
         return true;
@@ -120,6 +120,8 @@ namespace PetriEngine {
             }
             while (!waiting.empty())
             {
+                if(cancelled())
+                    return std::make_pair(false, false);
                 if(popDone(waiting, _stepno))
                     continue;  // we have reached the end of the edge-iterator for this part of the trace
 
@@ -163,7 +165,12 @@ namespace PetriEngine {
                     stopwatch ct;
                     ct.start();
 #endif
+                    std::unique_lock<std::mutex> guard;
+                    if(_queryLock != nullptr)
+                        guard = std::unique_lock<std::mutex>(*_queryLock);
                     auto satisfied = solver.check(waiting, _traceset);
+                    if(guard.owns_lock())
+                        guard.unlock();
 #ifdef TAR_TIMING
                     ct.stop();
                     _check_time += ct.duration();
@@ -248,6 +255,8 @@ namespace PetriEngine {
 #endif
             do
             {
+                if(cancelled())
+                    return false;
                 auto [finished, satisfied] = runTAR(printtrace, solver, use_trans);
                 if(finished)
                 {
@@ -469,7 +478,8 @@ namespace PetriEngine {
             for(size_t i = 0; i < queries.size(); ++i)
             {
                 _traceset.clear();
-                if(results[i] == ResultPrinter::Unknown)
+                _query = i;
+                if(results[i] == ResultPrinter::Unknown && !cancelled())
                 {
                     PlaceUseVisitor visitor(_net.numberOfPlaces());
                     Visitor::visit(visitor, queries[i]);
@@ -483,6 +493,9 @@ namespace PetriEngine {
                     }
                     Solver solver(_net, state.marking(), queries[i].get(), used);
                     bool res = tryReach(printtrace, solver);
+                    // a cancelled query is left unanswered
+                    if(cancelled())
+                        continue;
                     if(res)
                         results[i] = ResultPrinter::Satisfied;
                     else
@@ -511,7 +524,13 @@ namespace PetriEngine {
                 if(results[i] == ResultPrinter::Unknown)
                 {
                     EvaluationContext ec(state.marking(), &_net);
-                    if(PetriEngine::PQL::evaluate(queries[i].get(), ec) == Condition::RTRUE)
+                    std::unique_lock<std::mutex> guard;
+                    if(_queryLock != nullptr)
+                        guard = std::unique_lock<std::mutex>(*_queryLock);
+                    auto res = PetriEngine::PQL::evaluate(queries[i].get(), ec);
+                    if(guard.owns_lock())
+                        guard.unlock();
+                    if(res == Condition::RTRUE)
                     {
                         auto ret = _printer.handle(i, queries[i].get(), ResultPrinter::Satisfied);
                         results[i] = ret.first;
@@ -38,10 +38,18 @@ void options_t::print(std::ostream& optionsOut) {
         optionsOut << "\nSearch=RPFS";
     } else if (strategy == Strategy::RandomWalk) {
         optionsOut << "\nSearch=RandomWalk";
+    } else if (strategy == Strategy::ExternalBFS) {
+        optionsOut << "\nSearch=ExternalBFS,ExternalMemory=" << external_memory;
     } else {
         optionsOut << "\nSearch=OverApprox";
     }
 
+    if (state_storage == StateStorage::HashCompaction) {
+        optionsOut << ",StateStorage=HashCompaction,MemoryBudget=" << memory_budget;
+    } else if (state_storage == StateStorage::Bitstate) {
+        optionsOut << ",StateStorage=Bitstate,MemoryBudget=" << memory_budget;
+    }
+
     if (trace != TraceLevel::None) {
         optionsOut << ",Trace=ENABLED";
     } else {
@@ -84,6 +92,10 @@ void options_t::print(std::ostream& optionsOut) {
 
     optionsOut << ",Struct_Red_Timout=" << reductionTimeout;
 
+    if (queryGroupReduction) {
+        optionsOut << ",Query_Group_Reduction=ENABLED";
+    }
+
     if (stubbornreduction) {
         optionsOut << ",Stubborn_Reduction=ENABLED";
     } else {
@@ -110,10 +122,23 @@ void options_t::print(std::ostream& optionsOut) {
 
     optionsOut << ",LPSolve_Timeout=" << lpsolveTimeout;
 
+    if (cores > 1) {
+        optionsOut << ",Cores=" << cores;
+    }
+
+    if (!portfolio.empty()) {
+        optionsOut << ",Portfolio=";
+        for (size_t i = 0; i < portfolio.size(); ++i) {
+            optionsOut << (i == 0 ? "" : "+") << portfolio[i];
+        }
+    }
+
 
     if (usedctl) {
         if (ctlalgorithm == CTL::CZero) {
             optionsOut << ",CTLAlgorithm=CZERO";
+        } else if (ctlalgorithm == CTL::ParallelCZero) {
+            optionsOut << ",CTLAlgorithm=PCZERO";
         } else {
             optionsOut << ",CTLAlgorithm=LOCAL";
         }
@@ -125,6 +150,9 @@ void options_t::print(std::ostream& optionsOut) {
             case LTL::Algorithm::Tarjan:
                 optionsOut << ",LTLAlgorithm=Tarjan";
                 break;
+            case LTL::Algorithm::ParallelNDFS:
+                optionsOut << ",LTLAlgorithm=PNDFS";
+                break;
             case LTL::Algorithm::None:
                 optionsOut << ",LTLAlgorithm=None";
                 break;
@@ -138,6 +166,9 @@ void options_t::print(std::ostream& optionsOut) {
         } else if (colored_sucessor_generator == ColoredSuccessorGeneratorOption::FIXED) {
             optionsOut << ",ColoredSuccessorGenerator=FIXED";
         }
+        if (colored_compact_waiting) {
+            optionsOut << ",CompactWaitingList=ENABLED";
+        }
     }
 
     optionsOut << "\n";
@@ -161,10 +192,20 @@ void printHelp() {
         "                                       - RandomWalk [<depth>] [<inc>]  Random walk using potency search\n"
         "                                           - depth  Maximum depth of a random walk (default 50000)\n"
         "                                           - inc    Increment of the maximum depth after every random walk (default 5000)\n"
+        "                                       - ExternalBFS                   Breadth first search keeping the state space on disk\n"
         "                                       - OverApprox   Linear Over Approx\n"
         "  --init-potency-timeout <timeout>     Timeout for potencies initialization in seconds (default 10)\n"
         "                                       Only relevant for RPFS and RandomWalk strategies\n"
         "                                       write --init-potency-timeout 0 to disable the initialization\n"
+        "  --external-dir <directory>           Directory for the files of ExternalBFS (default: system temporary directory)\n"
+        "  --external-memory <MB>               Memory in MB used by ExternalBFS for buffers and caches (default 1024)\n"
+        "  --state-storage <type>               Storage of visited states for reachability and Tarjan LTL:\n"
+        "                                       - exact            Store every marking (default)\n"
+        "                                       - hash-compaction  Store a 64-bit fingerprint per marking\n"
+        "                                       - bitstate         Set three bits per marking in a bit table\n"
+        "                                       The approximate storages may miss states, results relying on\n"
+        "                                       the full state space are then reported as unknown (MAYBE)\n"
+        "  --memory-budget <MB>                 Memory in MB for the approximate state storage (default 1024)\n"
         "  --seed-offset <number>               Extra noise to add to the seed of the random number generation\n"
         "  -e, --state-space-exploration        State-space exploration only (query-file is irrelevant)\n"
         "  -x, --xml-queries <query index>      Parse XML query file and verify queries of a given comma-seperated list\n"
@@ -179,6 +220,9 @@ void printHelp() {
         "                                       - 2  user defined reduction sequence, eg -b 2 1,0 to use colored rules B,A only, and in that order\n"
         "  -d, --reduction-timeout <timeout>    Timeout for structural reductions in seconds (default 60)\n"
         "  -D, --colreduction-timeout <timeout> Timeout for colored structural reductions in seconds (default 60)\n"
+        "  --query-groups                       Group the reachability queries by the places they use, reduce a\n"
+        "                                       separate net for every group on --cores threads and verify each\n"
+        "                                       group on its own net (no traces, TAR or portfolio)\n"
         "  -q, --query-reduction <timeout>      Query reduction timeout in seconds (default 30)\n"
         "                                       write -q 0 to disable query reduction\n"
         "  --interval-timeout <timeout>         Time in seconds before the max intervals is halved (default 10)\n"
@@ -209,9 +253,16 @@ void printHelp() {
         "  -ctl, --ctl-algorithm [<type>]       Verify CTL properties\n"
         "                                       - local     Liu and Smolka's on-the-fly algorithm\n"
         "                                       - czero     local with certain zero extension (default)\n"
+#ifdef VERIFYPN_MultiCore
+        "                                       - pczero    czero on the number of cores given by --cores\n"
+#endif
         "  -ltl, --ltl-algorithm [<type>]       Verify LTL properties (default tarjan). If omitted the queries are assumed to be CTL.\n"
         "                                       - ndfs      Nested depth first search algorithm\n"
         "                                       - tarjan    On-the-fly Tarjan's algorithm\n"
+#ifdef VERIFYPN_MultiCore
+        "                                       - pndfs     Multi-core nested depth first search on the number of\n"
+        "                                                   cores given by --cores (no traces or partial order)\n"
+#endif
         "                                       - none      Run preprocessing steps only.\n"
         "  --noweak                             Disable optimizations for weak Büchi automata when doing \n"
         "                                       LTL model checking. Not recommended.\n"
@@ -219,18 +270,30 @@ void printHelp() {
         "                                       Not recommended since the reachability engine is faster.\n"
         "  --nounfold                           Stops after colored structural reductions and writing the reduced net\n"
         "                                       Useful for seeing the effect of colored reductions, without unfolding\n"
+        "  --unfold-only                        Stops after unfolding. The net given by --write-unfolded-net is written\n"
+        "                                       while it is unfolded, without keeping the unfolded net in memory\n"
         "  -c, --cpn-overapproximation          Over approximate query on Colored Petri Nets (CPN only)\n"
         "  -C                                   Use explicit colored engine to answer query (CPN only).\n"
-        "                                       Only supports -R, -t, --colored-successor-generator, --interactive-mode and -s options.\n"
+        "                                       Only supports -R, -t, --colored-successor-generator, --colored-compact-waiting-list,\n"
+        "                                       --interactive-mode and -s options.\n"
         "  --colored-successor-generator        Sets the the successor generator used in the explicit colored engine\n"
         "                                       - fixed   transitions and bindings are traversed in a fixed order\n"
         "                                       - even    transitions and bindings are checked evenly (default)\n"
+        "  --colored-compact-waiting-list       Keep only encoded state ids in the waiting list of the explicit colored\n"
+        "                                       engine and decode markings when they are expanded (sequential search only)\n"
         "  --interactive-mode                   Gives the set of fireable transitions and bindings from a marking, the marking is read from stdin (CPN only)"
         "  --disable-cfp                        Disable the computation of possible colors in the Petri Net (CPN only)\n"
         "  --disable-partitioning               Disable the partitioning of colors in the Petri Net (CPN only)\n"
         "  --disable-symmetry-vars              Disable search for symmetric variables (CPN only)\n"
-#ifdef VERIFYPN_MC_Simplification
-        "  -z, --cores <number of cores>        Number of cores to use (currently only query simplification)\n"
+#if defined(VERIFYPN_MC_Simplification) || defined(VERIFYPN_MultiCore)
+        "  -z, --cores <number of cores>        Number of cores to use (query simplification and BFS, DFS, RDFS and\n"
+        "                                       BestFS reachability search, explicit colored search, pczero CTL engine,\n"
+        "                                       pndfs LTL engine, color fixpoint and colored unfolding)\n"
+        "  --portfolio <engines>                Run a comma-separated list of reachability engines in parallel on the\n"
+        "                                       same net and queries, stopping the others once one answers a query.\n"
+        "                                       Engines are BestFS, BFS, DFS, RDFS, RPFS, RandomWalk and TAR, an engine\n"
+        "                                       listed more than once is run with different seeds. \"default\" is\n"
+        "                                       BestFS,DFS,RDFS,RandomWalk,RandomWalk,TAR\n"
 #endif
         "  -tar, --trace-abstraction            Enables Trace Abstraction Refinement for reachability properties\n"
         "  --max-intervals <interval count>     The max amount of intervals kept when computing the color fixpoint\n"
@@ -304,6 +367,8 @@ bool options_t::parse(int argc, const char** argv) {
                 strategy = Strategy::RDFS;
             else if (std::strcmp(s, "RPFS") == 0)
                 strategy = Strategy::RPFS;
+            else if (std::strcmp(s, "ExternalBFS") == 0)
+                strategy = Strategy::ExternalBFS;
             else if (std::strcmp(s, "RandomWalk") == 0) {
                 strategy = Strategy::RandomWalk;
                 if (argc > i + 1) {
@@ -467,6 +532,8 @@ bool options_t::parse(int argc, const char** argv) {
             if (sscanf(argv[++i], "%d", &reductionTimeout) != 1) {
                 throw base_error("Argument Error: Invalid reduction timeout argument ", std::quoted(argv[i]));
             }
+        } else if (std::strcmp(argv[i], "--query-groups") == 0) {
+            queryGroupReduction = true;
         } else if (std::strcmp(argv[i], "-D") == 0 || std::strcmp(argv[i], "--colreduction-timeout") == 0) {
             if (i == argc - 1) {
                 throw base_error("Missing number after ", std::quoted(argv[i]));
@@ -478,6 +545,39 @@ bool options_t::parse(int argc, const char** argv) {
             if (sscanf(argv[++i], "%u", &seed_offset) != 1) {
                 throw base_error("Argument Error: Invalid seed offset argument ", std::quoted(argv[i]));
             }
+        } else if (std::strcmp(argv[i], "--external-dir") == 0) {
+            if (i == argc - 1) {
+                throw base_error("Missing directory after ", std::quoted(argv[i]));
+            }
+            external_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--external-memory") == 0) {
+            if (i == argc - 1) {
+                throw base_error("Missing number after ", std::quoted(argv[i]));
+            }
+            if (sscanf(argv[++i], "%zu", &external_memory) != 1 || external_memory == 0) {
+                throw base_error("Argument Error: Invalid external memory ", std::quoted(argv[i]));
+            }
+        } else if (std::strcmp(argv[i], "--state-storage") == 0) {
+            if (i == argc - 1) {
+                throw base_error("Missing argument to --state-storage");
+            }
+            if (std::strcmp(argv[i + 1], "exact") == 0) {
+                state_storage = StateStorage::Exact;
+            } else if (std::strcmp(argv[i + 1], "hash-compaction") == 0) {
+                state_storage = StateStorage::HashCompaction;
+            } else if (std::strcmp(argv[i + 1], "bitstate") == 0) {
+                state_storage = StateStorage::Bitstate;
+            } else {
+                throw base_error("Invalid argument ", std::quoted(argv[i + 1]), " to --state-storage");
+            }
+            ++i;
+        } else if (std::strcmp(argv[i], "--memory-budget") == 0) {
+            if (i == argc - 1) {
+                throw base_error("Missing number after ", std::quoted(argv[i]));
+            }
+            if (sscanf(argv[++i], "%zu", &memory_budget) != 1 || memory_budget == 0) {
+                throw base_error("Argument Error: Invalid memory budget ", std::quoted(argv[i]));
+            }
         } else if (std::strcmp(argv[i], "-p") == 0 || std::strcmp(argv[i], "--disable-partial-order") == 0) {
             stubbornreduction = false;
         } else if (std::strcmp(argv[i], "-a") == 0 || std::strcmp(argv[i], "--siphon-trap") == 0) {
@@ -573,19 +673,40 @@ bool options_t::parse(int argc, const char** argv) {
                 throw base_error("Invalid argument ", std::quoted(argv[i + 1]), " to --colored-successor-generator");
             }
             ++i;
+        } else if (std::strcmp(argv[i], "--colored-compact-waiting-list") == 0) {
+            colored_compact_waiting = true;
         } else if (std::strcmp(argv[i], "--interactive-mode") == 0) {
             interactive_mode = true;
             ++i;
         }
-#ifdef VERIFYPN_MC_Simplification
-        else if (std::strcmp(argv[i], "-z") == 0) {
+#if defined(VERIFYPN_MC_Simplification) || defined(VERIFYPN_MultiCore)
+        else if (std::strcmp(argv[i], "-z") == 0 || std::strcmp(argv[i], "--cores") == 0) {
             if (i == argc - 1) {
                 throw base_error("Missing number after ", std::quoted(argv[i]));
             }
-            if (sscanf(argv[++i], "%u", &cores) != 1) {
+            if (sscanf(argv[++i], "%u", &cores) != 1 || cores == 0) {
                 throw base_error("Argument Error: Invalid cores count ", std::quoted(argv[i]));
             }
         }
+        else if (std::strcmp(argv[i], "--portfolio") == 0) {
+            if (i == argc - 1) {
+                throw base_error("Missing engines after ", std::quoted(argv[i]));
+            }
+            if (std::strcmp(argv[++i], "default") == 0) {
+                portfolio = {"BestFS", "DFS", "RDFS", "RandomWalk", "RandomWalk", "TAR"};
+            } else {
+                portfolio = explode(argv[i]);
+                if (portfolio.empty()) {
+                    throw base_error("Argument Error: Empty portfolio ", std::quoted(argv[i]));
+                }
+                for (auto& engine : portfolio) {
+                    if (engine != "BestFS" && engine != "BFS" && engine != "DFS" && engine != "RDFS" &&
+                        engine != "RPFS" && engine != "RandomWalk" && engine != "TAR") {
+                        throw base_error("Argument Error: Unrecognized portfolio engine ", std::quoted(engine));
+                    }
+                }
+            }
+        }
 #endif
         else if (std::strcmp(argv[i], "--keep-solved") == 0)
         {
@@ -600,6 +721,12 @@ bool options_t::parse(int argc, const char** argv) {
                     ctlalgorithm = CTL::Local;
                 } else if (std::strcmp(argv[i + 1], "czero") == 0) {
                     ctlalgorithm = CTL::CZero;
+                } else if (std::strcmp(argv[i + 1], "pczero") == 0) {
+#ifdef VERIFYPN_MultiCore
+                    ctlalgorithm = CTL::ParallelCZero;
+#else
+                    throw base_error("Argument Error: The ctl-algorithm pczero requires a multi-core build");
+#endif
                 } else {
                     throw base_error("Argument Error: Invalid ctl-algorithm type ", std::quoted(argv[i + 1]));
                 }
@@ -612,6 +739,12 @@ bool options_t::parse(int argc, const char** argv) {
                     ltlalgorithm = LTL::Algorithm::NDFS;
                 } else if (std::strcmp(argv[i + 1], "tarjan") == 0) {
                     ltlalgorithm = LTL::Algorithm::Tarjan;
+                } else if (std::strcmp(argv[i + 1], "pndfs") == 0) {
+#ifdef VERIFYPN_MultiCore
+                    ltlalgorithm = LTL::Algorithm::ParallelNDFS;
+#else
+                    throw base_error("Argument Error: The ltl-algorithm pndfs requires a multi-core build");
+#endif
                 } else if (std::strcmp(argv[i + 1], "none") == 0) {
                     ltlalgorithm = LTL::Algorithm::None;
                 } else {
@@ -661,6 +794,8 @@ bool options_t::parse(int argc, const char** argv) {
             doVerification = false;
         } else if (std::strcmp(argv[i], "--nounfold") == 0) {
             doUnfolding = false;
+        } else if (std::strcmp(argv[i], "--unfold-only") == 0) {
+            unfoldOnly = true;
         } else if (std::strcmp(argv[i], "--disable-symmetry-vars") == 0) {
             symmetricVariables = false;
         } else if (std::strcmp(argv[i], "--strategy-output") == 0) {
@@ -769,6 +904,10 @@ bool options_t::parse(int argc, const char** argv) {
         }
     }
 
+    if (unfoldOnly && unfolded_out_file.empty()) {
+        throw base_error("Argument Error: --unfold-only requires --write-unfolded-net.");
+    }
+
     if (false && replay_trace && logic != TemporalLogic::LTL) {
         throw base_error("Argument Error: Trace replay_trace is only supported for LTL model checking.");
     }
@@ -53,6 +53,8 @@
 #include "LTL/Simplification/SpotToPQL.h"
 
 #include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace PetriEngine;
 using namespace PetriEngine::PQL;
@@ -128,13 +130,14 @@ bool reduceColored(ColoredPetriNetBuilder &cpnBuilder, std::vector<std::shared_p
     return anyReduction;
 }
 
-std::tuple<PetriNetBuilder, shared_name_name_map, shared_place_color_map>
-unfold(ColoredPetriNetBuilder& cpnBuilder, bool compute_partiton, bool compute_symmetry, bool computed_fixed_point,
-    std::ostream& out, int32_t partitionTimeout, int32_t max_intervals, int32_t intervals_reduced, int32_t interval_timeout, bool over_approx, bool print_bindings) {
+// Computes the partition, symmetries and color fixed point (all skipped when over-approximating),
+// hands the unfolder to unfold_net, which returns the number of unfolded places and transitions,
+// and prints the unfolding statistics for a real unfolding.
+template<typename F>
+static void unfoldWith(ColoredPetriNetBuilder& cpnBuilder, bool compute_partiton, bool compute_symmetry, bool computed_fixed_point,
+    std::ostream& out, int32_t partitionTimeout, int32_t max_intervals, int32_t intervals_reduced, int32_t interval_timeout, bool over_approx, bool print_bindings,
+    uint32_t threads, F&& unfold_net) {
     Colored::PartitionBuilder partition(cpnBuilder.transitions(), cpnBuilder.places());
-
-    if(!cpnBuilder.isColored())
-        return {cpnBuilder.pt_builder(), {}, {}};
     if (compute_partiton && !over_approx) {
         partition.compute(partitionTimeout);
     }
@@ -146,46 +149,54 @@ unfold(ColoredPetriNetBuilder& cpnBuilder, bool compute_partiton, bool compute_s
 
     Colored::ForwardFixedPoint fixed_point(cpnBuilder, partition);
     if (computed_fixed_point && !over_approx) {
-        fixed_point.compute(max_intervals, intervals_reduced, interval_timeout);
+        fixed_point.compute(max_intervals, intervals_reduced, interval_timeout, threads);
     } else fixed_point.set_default();
 
-    Colored::Unfolder unfolder(cpnBuilder, partition, symmetry, fixed_point, print_bindings);
-    if(over_approx)
-    {
-        auto r = unfolder.strip_colors();
-        return std::make_tuple<PetriNetBuilder, shared_name_name_map, shared_place_color_map>
-            (std::move(r),
-            shared_name_name_map{unfolder.transition_names()},
-            shared_place_color_map{unfolder.place_names()});
+    Colored::Unfolder unfolder(cpnBuilder, partition, symmetry, fixed_point, print_bindings, threads);
+    auto [places, transitions] = unfold_net(unfolder);
+    if (over_approx)
+        return;
+
+    if (computed_fixed_point) {
+        out << "\nColor fixpoint computed in " << fixed_point.time() << " seconds" << std::endl;
+        out << "Max intervals used: " << fixed_point.max_intervals() << std::endl;
     }
-    else
-    {
-        auto r = unfolder.unfold();
-        if (computed_fixed_point) {
-            out << "\nColor fixpoint computed in " << fixed_point.time() << " seconds" << std::endl;
-            out << "Max intervals used: " << fixed_point.max_intervals() << std::endl;
-        }
 
-        out << "Size of colored net: " <<
-            cpnBuilder.unskippedPlacesCount() << " places, " <<
-            cpnBuilder.unskippedTransitionsCount() << " transitions, and " <<
-            cpnBuilder.getArcCount() << " arcs" << std::endl;
-        out << "Size of unfolded net: " <<
-            r.numberOfPlaces() << " places, " <<
-            r.numberOfTransitions() << " transitions, and " <<
-            unfolder.number_of_arcs() << " arcs" << std::endl;
-        if (compute_partiton) {
-            out << "Partitioned in " << partition.time() << " seconds" << std::endl;
-        }
-        out << "Unfolded in " << unfolder.time() << " seconds\n" << std::endl;
-        
-        unfolder.printBinding();
-        
-        return std::make_tuple<PetriNetBuilder, shared_name_name_map, shared_place_color_map>
-            (std::move(r),
-            shared_name_name_map{unfolder.transition_names()},
-            shared_place_color_map{unfolder.place_names()});
+    out << "Size of colored net: " <<
+        cpnBuilder.unskippedPlacesCount() << " places, " <<
+        cpnBuilder.unskippedTransitionsCount() << " transitions, and " <<
+        cpnBuilder.getArcCount() << " arcs" << std::endl;
+    out << "Size of unfolded net: " <<
+        places << " places, " <<
+        transitions << " transitions, and " <<
+        unfolder.number_of_arcs() << " arcs" << std::endl;
+    if (compute_partiton) {
+        out << "Partitioned in " << partition.time() << " seconds" << std::endl;
     }
+    out << "Unfolded in " << unfolder.time() << " seconds\n" << std::endl;
+
+    unfolder.printBinding();
+}
+
+std::tuple<PetriNetBuilder, shared_name_name_map, shared_place_color_map>
+unfold(ColoredPetriNetBuilder& cpnBuilder, bool compute_partiton, bool compute_symmetry, bool computed_fixed_point,
+    std::ostream& out, int32_t partitionTimeout, int32_t max_intervals, int32_t intervals_reduced, int32_t interval_timeout, bool over_approx, bool print_bindings,
+    uint32_t threads) {
+    if(!cpnBuilder.isColored())
+        return {cpnBuilder.pt_builder(), {}, {}};
+
+    std::optional<PetriNetBuilder> result;
+    shared_name_name_map transition_names;
+    shared_place_color_map place_names;
+    unfoldWith(cpnBuilder, compute_partiton, compute_symmetry, computed_fixed_point, out, partitionTimeout, max_intervals,
+        intervals_reduced, interval_timeout, over_approx, print_bindings, threads, [&](Colored::Unfolder& unfolder) {
+        result.emplace(over_approx ? unfolder.strip_colors() : unfolder.unfold());
+        transition_names = unfolder.transition_names();
+        place_names = unfolder.place_names();
+        return std::make_pair(result->numberOfPlaces(), result->numberOfTransitions());
+    });
+    return std::make_tuple<PetriNetBuilder, shared_name_name_map, shared_place_color_map>
+        (std::move(*result), std::move(transition_names), std::move(place_names));
 }
 
 ReturnValue contextAnalysis(bool colored, const shared_name_name_map& transition_names, const shared_place_color_map& place_names,
@@ -494,6 +505,29 @@ void outputNet(const PetriNetBuilder &builder, std::string out_file) {
     unfoldedNet->toXML(file);
 }
 
+void outputUnfoldedNet(ColoredPetriNetBuilder& cpnBuilder, std::string out_file,
+    bool compute_partiton, bool compute_symmetry, bool computed_fixed_point,
+    std::ostream& out, int32_t partitionTimeout, int32_t max_intervals, int32_t intervals_reduced, int32_t interval_timeout, bool over_approx, bool print_bindings,
+    uint32_t threads) {
+    if (!cpnBuilder.isColored() || over_approx) {
+        auto [builder, transition_names, place_names] = unfold(cpnBuilder, compute_partiton, compute_symmetry, computed_fixed_point,
+            out, partitionTimeout, max_intervals, intervals_reduced, interval_timeout, over_approx, print_bindings, threads);
+        builder.sort();
+        outputNet(builder, out_file);
+        return;
+    }
+
+    std::fstream file;
+    file.open(out_file, std::ios::out);
+    StreamingPnmlBuilder ptBuilder(file);
+    unfoldWith(cpnBuilder, compute_partiton, compute_symmetry, computed_fixed_point, out, partitionTimeout, max_intervals,
+        intervals_reduced, interval_timeout, over_approx, print_bindings, threads, [&](Colored::Unfolder& unfolder) {
+        unfolder.unfold(ptBuilder);
+        ptBuilder.finish();
+        return std::make_pair(ptBuilder.numberOfPlaces(), ptBuilder.numberOfTransitions());
+    });
+}
+
 void outputQueries(const PetriNetBuilder &builder, const std::vector<PetriEngine::PQL::Condition_ptr> &queries,
     std::vector<std::string> &querynames, std::string filename, uint32_t binary_query_io, bool keep_solved) {
     std::vector<uint32_t> reorder(queries.size());
@@ -791,3 +825,120 @@ void initialize_potency(const MarkVal* marking,
             return a;
     }) && std::chrono::duration_cast<std::chrono::seconds>(end - begin).count() < options.initPotencyTimeout && to_handle > 0);
 }
+
+std::vector<std::unique_ptr<PetriNetBuilder>>
+reduceQueryGroups(const PetriNetBuilder& builder, const std::vector<std::vector<size_t>>& groups,
+                  std::vector<Condition_ptr>& queries, const std::vector<ResultPrinter::Result>& results,
+                  options_t& options) {
+    std::vector<std::unique_ptr<PetriNetBuilder>> reduced(groups.size());
+#ifdef VERIFYPN_MultiCore
+    const size_t workers = std::max<size_t>(1, std::min<size_t>(options.cores, groups.size()));
+#else
+    const size_t workers = 1;
+#endif
+    // the groups are reduced in rounds of one group per worker, and each group gets an equal
+    // share of the reduction time that is left for the rounds still to come
+    const size_t rounds = (groups.size() + workers - 1) / workers;
+    const auto begin = std::chrono::high_resolution_clock::now();
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    std::mutex error_lock;
+    std::exception_ptr error;
+    // every group is reduced on its own copy of the net and only touches its own queries
+    auto reduce = [&]() {
+        try {
+            for (size_t g = next++; g < groups.size() && !stop; g = next++) {
+                auto group_builder = std::make_unique<PetriNetBuilder>(builder);
+                std::vector<ResultPrinter::Result> group_results(results.size(), ResultPrinter::Ignore);
+                for (auto i : groups[g])
+                    group_results[i] = results[i];
+                auto reductions = options.reductions;
+                const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::high_resolution_clock::now() - begin).count();
+                const int timeout = std::max<int>(0, options.reductionTimeout - elapsed) / (rounds - g / workers);
+                group_builder->startTimer();
+                group_builder->reduce(queries, group_results, options.enablereduction, false, nullptr,
+                                      timeout, reductions);
+                reduced[g] = std::move(group_builder);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error)
+                error = std::current_exception();
+            stop = true;
+        }
+    };
+#ifdef VERIFYPN_MultiCore
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; ++w)
+        threads.emplace_back(reduce);
+    reduce();
+    for (auto& thread : threads)
+        thread.join();
+#else
+    reduce();
+#endif
+    if (error)
+        std::rethrow_exception(error);
+    return reduced;
+}
+
+void verifyQueryGroups(const PetriNetBuilder& builder, const std::vector<std::vector<size_t>>& groups,
+                       std::vector<Condition_ptr>& queries, std::vector<ResultPrinter::Result>& results,
+                       bool colored, const shared_name_name_map& transition_names, const shared_place_color_map& place_names,
+                       AbstractHandler& printer, options_t& options) {
+    auto reduced = reduceQueryGroups(builder, groups, queries, results, options);
+
+    if (options.strategy == Strategy::DEFAULT) options.strategy = Strategy::HEUR;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        auto& group_builder = *reduced[g];
+        if (options.printstatistics == StatisticsLevel::Full) {
+            std::cout << "\nQuery group " << g << ", query indexes";
+            for (auto i : groups[g])
+                std::cout << " " << i;
+            std::cout << std::endl;
+        }
+        printStats(group_builder, options);
+
+        std::unique_ptr<PetriNet> group_net(group_builder.makePetriNet());
+        std::vector<Condition_ptr> group_queries;
+        std::vector<ResultPrinter::Result> group_results;
+        for (auto i : groups[g]) {
+            group_queries.push_back(queries[i]);
+            group_results.push_back(results[i]);
+        }
+        if (contextAnalysis(colored, transition_names, place_names, group_builder, group_net.get(), group_queries) != ReturnValue::ContinueCode) {
+            throw base_error("An error occurred while assigning indexes");
+        }
+        for (auto& query : group_queries)
+            query = prepareForReachability(query);
+
+        // RPFS and RandomWalk start from potencies initialized on the net of the group; the groups are
+        // verified one after the other and share the initialization timeout
+        std::vector<MarkVal> initialPotencies;
+        if (options.initPotencyTimeout > 0 && (options.strategy == Strategy::RandomWalk || options.strategy == Strategy::RPFS)) {
+            initialPotencies.assign(group_net->numberOfTransitions(), 0);
+            options_t group_options = options;
+            group_options.initPotencyTimeout = std::max<int>(1, options.initPotencyTimeout / groups.size());
+            std::unique_ptr<MarkVal[]> qm0(group_net->makeInitialMarking());
+            initialize_potency(qm0.get(), group_net.get(), group_queries, group_options, std::cout, initialPotencies);
+        }
+
+        QueryGroupResultPrinter group_printer(printer, groups[g]);
+        ReachabilitySearch strategy(*group_net, group_printer, options.kbound);
+        strategy.setExternalMemory(options.external_dir, options.external_memory);
+        strategy.setStateStorage(options.state_storage, options.memory_budget);
+        strategy.reachable(group_queries, group_results,
+                        options.strategy,
+                        options.stubbornreduction,
+                        options.statespaceexploration,
+                        options.printstatistics,
+                        false,
+                        options.seed(),
+                        options.depthRandomWalk,
+                        options.incRandomWalk,
+                        initialPotencies);
+        for (size_t j = 0; j < groups[g].size(); ++j)
+            results[groups[g][j]] = group_results[j];
+    }
+}
@@ -56,6 +56,8 @@
 #include "PetriEngine/ExplicitColored/ExplicitColoredPetriNetBuilder.h"
 #include "PetriEngine/ExplicitColored/Algorithms/ExplicitWorklist.h"
 #include "PetriEngine/ExplicitColored/ExplicitColoredModelChecker.h"
+#include "PetriEngine/Reachability/ParallelReachabilitySearch.h"
+#include "PetriEngine/Reachability/PortfolioReachabilitySearch.h"
 using namespace PetriEngine;
 using namespace PetriEngine::PQL;
 using namespace PetriEngine::Reachability;
@@ -169,11 +171,20 @@ int main(int argc, const char** argv) {
             return 0;
         }
 
+        if (options.unfoldOnly) {
+            outputUnfoldedNet(cpnBuilder, options.unfolded_out_file,
+                options.computePartition, options.symmetricVariables,
+                options.computeCFP, out,
+                options.partitionTimeout, options.max_intervals, options.max_intervals_reduced,
+                options.intervalTimeout, options.cpnOverApprox, options.print_bindings, options.cores);
+            return to_underlying(ReturnValue::SuccessCode);
+        }
+
         auto [builder, transition_names, place_names] = unfold(cpnBuilder,
             options.computePartition, options.symmetricVariables,
             options.computeCFP, out,
             options.partitionTimeout, options.max_intervals, options.max_intervals_reduced,
-            options.intervalTimeout, options.cpnOverApprox, options.print_bindings);
+            options.intervalTimeout, options.cpnOverApprox, options.print_bindings, options.cores);
 
         builder.sort();
         std::vector<ResultPrinter::Result> results(queries.size(), ResultPrinter::Result::Unknown);
@@ -310,6 +321,22 @@ int main(int argc, const char** argv) {
         }
 
         builder.freezeOriginalSize();
+        if (options.queryGroupReduction && options.enablereduction > 0 && options.doVerification && !alldone) {
+            bool only_reachability = std::none_of(results.begin(), results.end(), [](auto r) {
+                return r == ResultPrinter::CTL || r == ResultPrinter::LTL || r == ResultPrinter::Synthesis;
+            });
+            if (!only_reachability || options.trace != TraceLevel::None || options.tar || !options.portfolio.empty() ||
+                options.statespaceexploration || options.replay_trace || options.model_out_file.size() > 0) {
+                fprintf(stdout, "Query group reduction was ignored as it only supports reachability queries without traces, TAR or portfolio.\n");
+            }
+            else if (auto groups = builder.queryGroups(queries, results, nullptr); groups.size() > 1) {
+                //--------------------- Reduce and verify query groups ---------------//
+                verifyQueryGroups(builder, groups, queries, results, cpnBuilder.isColored() && !options.cpnOverApprox,
+                                  transition_names, place_names, printer, options);
+                return to_underlying(ReturnValue::SuccessCode);
+            }
+        }
+
         if (options.enablereduction > 0) {
             // Compute structural reductions
             builder.startTimer();
@@ -397,6 +424,10 @@ int main(int argc, const char** argv) {
                 auto reachabilityStrategy = options.strategy;
 
                 if (options.strategy == Strategy::DEFAULT) options.strategy = Strategy::DFS;
+                if (options.strategy == Strategy::ExternalBFS) {
+                    fprintf(stdout, "ExternalBFS is only supported for reachability, BFS is used for CTL queries.\n");
+                    options.strategy = Strategy::BFS;
+                }
                 auto v = CTLMain(net.get(),
                                  options.ctlalgorithm,
                                  options.strategy,
@@ -418,16 +449,30 @@ int main(int argc, const char** argv) {
 
             if (!ltl_ids.empty() && options.ltlalgorithm != LTL::Algorithm::None) {
                 options.usedltl = true;
+                if (options.ltlalgorithm == LTL::Algorithm::ParallelNDFS && options.stubbornreduction &&
+                    options.ltl_por != LTL::LTLPartialOrder::None) {
+                    fprintf(stdout, "Partial order option was ignored as the parallel NDFS does not support partial order reduction.\n");
+                }
 
                 for (auto qid : ltl_ids) {
                     LTL::LTLSearch search(*net, queries[qid], options.buchiOptimization, options.ltl_compress_aps);
                     auto res = search.solve(options.trace != TraceLevel::None, options.kbound,
                         options.ltlalgorithm, options.stubbornreduction ? options.ltl_por : LTL::LTLPartialOrder::None,
-                        options.strategy, options.ltlHeuristic, options.ltluseweak, options.seed_offset);
+                        options.strategy, options.ltlHeuristic, options.ltluseweak, options.seed_offset,
+                        options.state_storage, options.memory_budget, options.cores);
 
                     if(options.printstatistics != StatisticsLevel::None)
                         search.print_stats(std::cout);
 
+                    if (search.is_approximate() && res) {
+                        // no accepting cycle was found, but the approximate storage may have omitted one
+                        std::cout << "\nUnable to decide if " << querynames[qid] << " is satisfied.\n\n"
+                                  << "Query is MAYBE satisfied.\n"
+                                  << "Visited states were stored approximately (estimated omission probability "
+                                  << search.omission_probability() << ")." << std::endl;
+                        continue;
+                    }
+
                     std::cout << "FORMULA " << querynames[qid]
                         << (res ? " TRUE" : " FALSE") << " TECHNIQUES EXPLICIT "
                         << LTL::to_string(options.ltlalgorithm)
@@ -512,6 +557,31 @@ int main(int argc, const char** argv) {
                 if(results[i] == ResultPrinter::Unknown)
                     queries[i] = prepareForReachability(queries[i]);
             }
+#ifdef VERIFYPN_MultiCore
+            if (!options.portfolio.empty() && options.trace != TraceLevel::None) {
+                fprintf(stdout, "Portfolio option was ignored as traces are not supported by the portfolio.\n");
+            }
+            if (!options.portfolio.empty() && options.trace == TraceLevel::None && !options.statespaceexploration) {
+                PortfolioReachabilitySearch portfolio(*net, printer, builder.getReducer(), options.kbound);
+
+                if (options.tar || options.strategy != Strategy::DEFAULT)
+                    fprintf(stdout, "Search strategy option was ignored as the reachability portfolio is used.\n");
+
+                //Reachability search
+                portfolio.reachable(queries, results,
+                                    options.portfolio,
+                                    options.stubbornreduction,
+                                    options.printstatistics,
+                                    options.seed(),
+                                    options.depthRandomWalk,
+                                    options.incRandomWalk);
+                if (options.printstatistics == StatisticsLevel::Full) {
+                    for (size_t i = 0; i < queries.size(); ++i)
+                        if (!portfolio.winner(i).empty())
+                            std::cout << "Query index " << i << " was solved by portfolio engine " << portfolio.winner(i) << std::endl;
+                }
+            } else
+#endif
             if (options.tar && net->numberOfPlaces() > 0) {
                 //Create reachability search strategy
                 TarResultPrinter tar_printer(printer);
@@ -527,6 +597,8 @@ int main(int argc, const char** argv) {
                                    options.trace != TraceLevel::None);
             } else {
                 ReachabilitySearch strategy(*net, printer, options.kbound);
+                strategy.setExternalMemory(options.external_dir, options.external_memory);
+                strategy.setStateStorage(options.state_storage, options.memory_budget);
 
                 // Change default place-holder to default strategy
                 if (options.strategy == Strategy::DEFAULT) options.strategy = Strategy::HEUR;
@@ -550,7 +622,21 @@ int main(int argc, const char** argv) {
                                     options.depthRandomWalk,
                                     options.incRandomWalk,
                                     initialPotencies);
-                } else {
+                }
+#ifdef VERIFYPN_MultiCore
+                else if (options.cores > 1 && options.state_storage == StateStorage::Exact &&
+                         ParallelReachabilitySearch::supports(options.strategy)) {
+                    ParallelReachabilitySearch parallel(*net, printer, options.cores, options.kbound);
+                    parallel.reachable(queries, results,
+                                    options.strategy,
+                                    options.stubbornreduction,
+                                    options.statespaceexploration,
+                                    options.printstatistics,
+                                    options.trace != TraceLevel::None,
+                                    options.seed());
+                }
+#endif
+                else {
                     strategy.reachable(queries, results,
                                     options.strategy,
                                     options.stubbornreduction,
@@ -580,6 +666,12 @@ int explicitColored(shared_string_set& stringSet, options_t& options, std::vecto
         return to_underlying(ReturnValue::UnknownCode);
     }
 
+#ifdef VERIFYPN_MultiCore
+    if (options.colored_compact_waiting && options.cores > 1) {
+        std::cout << "Compact waiting list option was ignored as the parallel search does not support it." << std::endl;
+    }
+#endif
+
     try {
         NullStream nullStream;
         std::ostream& fullStatisticsOut = options.printstatistics == StatisticsLevel::Full